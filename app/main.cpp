@@ -58,5 +58,6 @@ CUSTOM_MAIN(context)
 
 	platform.terminate(code);
 
-	return 0;
+	// e.g. a performance regression found by benchmark mode
+	return platform.has_failed() ? 1 : 0;
 }
\ No newline at end of file
@@ -17,6 +17,10 @@
 
 #include "batch_mode.h"
 
+#include <algorithm>
+#include <iterator>
+
+#include "benchmark_target.h"
 #include "vulkan_sample.h"
 
 #include "platform/parser.h"
@@ -31,6 +35,7 @@ BatchMode::BatchMode() :
                   {
                       vkb::Hook::OnUpdate,
                       vkb::Hook::OnAppError,
+                      vkb::Hook::PostDraw,
                   },
                   {&batch_cmd})
 {
@@ -114,6 +119,8 @@ void BatchMode::on_update(float delta_time)
 	{
 		elapsed_time = 0.0f;
 
+		log_configuration_summary();
+
 		// Only check and advance the config if the application is a vulkan sample
 		if (auto *vulkan_app = dynamic_cast<vkb::VulkanSample *>(&platform->get_app()))
 		{
@@ -137,8 +144,63 @@ void BatchMode::on_app_error(const std::string &app_id)
 	load_next_app();
 }
 
+void BatchMode::on_post_draw(vkb::RenderContext &context)
+{
+	auto *target = dynamic_cast<vkb::BenchmarkTarget *>(&platform->get_app());
+	if (!target)
+	{
+		return;
+	}
+
+	for (auto &pass_time : target->get_benchmark_pass_times())
+	{
+		// no time is reported until the first frame of a variant has been read back
+		if (pass_time.time <= 0.0)
+		{
+			continue;
+		}
+
+		auto it = std::find_if(pass_timings.begin(), pass_timings.end(),
+		                       [&pass_time](const auto &pass) { return pass.first == pass_time.name; });
+		if (it == pass_timings.end())
+		{
+			pass_timings.emplace_back(pass_time.name, vkb::TimingStatistics{});
+			it = std::prev(pass_timings.end());
+		}
+		it->second.push(pass_time.time);
+	}
+}
+
+void BatchMode::log_configuration_summary()
+{
+	auto *target = dynamic_cast<vkb::BenchmarkTarget *>(&platform->get_app());
+	if (target && !pass_timings.empty())
+	{
+		// the configurations of a benchmark target are its variants, in the same order
+		auto        variants = target->get_benchmark_variants();
+		std::string name     = configuration_index < variants.size() ?
+		                           variants[configuration_index].type + " " + variants[configuration_index].window :
+		                           fmt::format("configuration {}", configuration_index);
+
+		std::string passes;
+		for (auto &pass : pass_timings)
+		{
+			auto summary = pass.second.get_summary();
+			passes += fmt::format(", {} median {:.4f} ms (p99 {:.4f} ms)", pass.first, summary.median, summary.p99);
+		}
+
+		LOGI("[Batch Mode] {} {}{} over {} frames", (*sample_iter)->id, name, passes, pass_timings.front().second.size());
+	}
+
+	pass_timings.clear();
+	++configuration_index;
+}
+
 void BatchMode::request_app()
 {
+	configuration_index = 0;
+	pass_timings.clear();
+
 	LOGI("===========================================");
 	LOGI("Running {}", (*sample_iter)->id);
 	LOGI("===========================================");
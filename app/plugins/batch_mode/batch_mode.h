@@ -18,10 +18,13 @@
 #pragma once
 
 #include <chrono>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "apps.h"
 #include "platform/plugins/plugin_base.h"
+#include "stats/timing_statistics.h"
 #include "timer.h"
 
 using namespace std::chrono_literals;
@@ -35,6 +38,9 @@ using BatchModeTags = vkb::PluginBase<vkb::tags::Entrypoint, vkb::tags::FullCont
  *
  * Run a subset of samples. The next sample in the set will start after the current sample being executed has finished. Using --wrap-to-start will start again from the first sample after the last sample is executed.
  *
+ * Every configuration of a sample runs for the given duration. The filter samples register each of their variants as a configuration, and a summary
+ * line of the GPU time of every pass is logged once each of their configurations completes.
+ *
  * Usage: vulkan_samples batch --duration 3 --category performance --tag arm
  *
  */
@@ -53,6 +59,8 @@ class BatchMode : public BatchModeTags
 
 	virtual void on_app_error(const std::string &app_id) override;
 
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
 	// TODO: Could this be replaced by the stop after plugin?
 	vkb::FlagCommand duration_flag{vkb::FlagType::OneValue, "duration", "", "The duration which a configuration should run for in seconds"};
 
@@ -80,6 +88,14 @@ class BatchMode : public BatchModeTags
 
 	bool wrap_to_start = false;
 
+	/// Index of the configuration the current sample runs
+	size_t configuration_index{0};
+
+	/// Per pass name, the GPU times of the current configuration of a benchmark target
+	std::vector<std::pair<std::string, vkb::TimingStatistics>> pass_timings;
+
+	void log_configuration_summary();
+
 	void request_app();
 
 	void load_next_app();
@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,15 +17,64 @@
 
 #include "benchmark_mode.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+
+#include <json.hpp>
+
+#include "apps.h"
 #include "platform/platform.h"
+#include "rendering/render_context.h"
 
 namespace plugins
 {
+namespace
+{
+// Minimum number of measured frames before a variant may stop early
+constexpr size_t min_converged_frames = 30;
+
+// Significance level of the Mann-Whitney U tests against the baseline
+constexpr double regression_significance = 0.01;
+
+// Version of the baseline file format
+constexpr int baseline_version = 1;
+
+bool ends_with(const std::string &str, const std::string &suffix)
+{
+	return str.size() >= suffix.size() && str.compare(str.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+// Megapixels per second of a pass processing a batch of width x height images in the given time
+double get_mpix_per_s(uint32_t width, uint32_t height, uint32_t batch_size, double time_ms)
+{
+	return time_ms > 0.0 ? static_cast<double>(width) * height * batch_size / (time_ms * 1e3) : 0.0;
+}
+
+double get_median(std::vector<double> values)
+{
+	if (values.empty())
+	{
+		return 0.0;
+	}
+
+	size_t middle = values.size() / 2;
+	std::nth_element(values.begin(), values.begin() + middle, values.end());
+	if (values.size() % 2 != 0)
+	{
+		return values[middle];
+	}
+	return 0.5 * (values[middle] + *std::max_element(values.begin(), values.begin() + middle));
+}
+}        // namespace
+
 BenchmarkMode::BenchmarkMode() :
     BenchmarkModeTags("Benchmark Mode",
-                      "Log frame averages after running an app.",
-                      {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose},
-                      {&benchmark_flag})
+                      "Log frame averages after running an app, or sweep the variants of a benchmark target.",
+                      {vkb::Hook::OnUpdate, vkb::Hook::OnAppStart, vkb::Hook::OnAppClose, vkb::Hook::PostDraw},
+                      {&benchmark_flag, &warmup_flag, &frames_flag, &precision_flag, &resolutions_flag, &batches_flag, &samples_flag, &output_flag,
+                       &baseline_flag, &update_baseline_flag, &regression_threshold_flag})
 {
 }
 
@@ -39,6 +88,92 @@ void BenchmarkMode::init(const vkb::CommandParser &parser)
 	// Whilst in benchmark mode fix the fps so that separate runs are consistently simulated
 	// This will effect the graph outputs of framerate
 	platform->force_simulation_fps(60.0f);
+
+	if (parser.contains(&warmup_flag))
+	{
+		warmup_frames = parser.as<uint32_t>(&warmup_flag);
+	}
+
+	if (parser.contains(&frames_flag))
+	{
+		measured_frames = std::max(parser.as<uint32_t>(&frames_flag), 1u);
+	}
+
+	if (parser.contains(&precision_flag))
+	{
+		precision = parser.as<float>(&precision_flag);
+	}
+
+	if (parser.contains(&resolutions_flag))
+	{
+		for (auto &resolution : parser.as<std::vector<std::string>>(&resolutions_flag))
+		{
+			uint32_t width  = 0;
+			uint32_t height = 0;
+			if (std::sscanf(resolution.c_str(), "%ux%u", &width, &height) != 2 || width == 0 || height == 0)
+			{
+				LOGE("[Benchmark Mode] Invalid resolution {}, expected WIDTHxHEIGHT", resolution);
+				throw std::runtime_error{"Can not continue"};
+			}
+			resolutions.emplace_back(width, height);
+		}
+
+		// The window is created after plugin initialization, so the first resolution applies to the first run
+		vkb::Window::OptionalProperties properties;
+		properties.extent.width  = resolutions.front().first;
+		properties.extent.height = resolutions.front().second;
+		properties.resizable     = true;
+		platform->set_window_properties(properties);
+	}
+
+	if (parser.contains(&batches_flag))
+	{
+		for (auto &batch : parser.as<std::vector<std::string>>(&batches_flag))
+		{
+			uint32_t batch_size = 0;
+			if (std::sscanf(batch.c_str(), "%u", &batch_size) != 1 || batch_size == 0)
+			{
+				LOGE("[Benchmark Mode] Invalid image batch {}, expected a number of images", batch);
+				throw std::runtime_error{"Can not continue"};
+			}
+			batch_sizes.push_back(batch_size);
+		}
+	}
+
+	if (parser.contains(&samples_flag))
+	{
+		for (auto &sample_id : parser.as<std::vector<std::string>>(&samples_flag))
+		{
+			if (!apps::get_app(sample_id))
+			{
+				LOGE("[Benchmark Mode] Unknown sample {}", sample_id);
+				throw std::runtime_error{"Can not continue"};
+			}
+			sweep_samples.push_back(sample_id);
+		}
+	}
+
+	if (parser.contains(&output_flag))
+	{
+		output_file = parser.as<std::string>(&output_flag);
+	}
+
+	if (parser.contains(&baseline_flag))
+	{
+		baseline_file = parser.as<std::string>(&baseline_flag);
+	}
+
+	update_baseline = parser.contains(&update_baseline_flag);
+	if (update_baseline && baseline_file.empty())
+	{
+		LOGE("[Benchmark Mode] --benchmark-update-baseline requires --benchmark-baseline");
+		throw std::runtime_error{"Can not continue"};
+	}
+
+	if (parser.contains(&regression_threshold_flag))
+	{
+		regression_threshold = parser.as<float>(&regression_threshold_flag);
+	}
 }
 
 void BenchmarkMode::on_update(float delta_time)
@@ -52,10 +187,585 @@ void BenchmarkMode::on_app_start(const std::string &app_id)
 	elapsed_time = 0;
 	total_frames = 0;
 	LOGI("Starting Benchmark for {}", app_id);
+
+	// The sample started from the command line is the first one to be swept
+	if (target_id.empty() && (sweep_samples.empty() || sweep_samples[sample_index] != app_id))
+	{
+		sweep_samples.insert(sweep_samples.begin(), app_id);
+	}
+
+	target    = dynamic_cast<vkb::BenchmarkTarget *>(&platform->get_app());
+	target_id = app_id;
+
+	if (!target)
+	{
+		if (sweep_samples.size() > 1)
+		{
+			LOGW("[Benchmark Mode] {} can not be swept, skipping", app_id);
+			advance_sample();
+		}
+		return;
+	}
+
+	variants = target->get_benchmark_variants();
+	if (variants.empty())
+	{
+		LOGW("[Benchmark Mode] {} has no variants, skipping", app_id);
+		target = nullptr;
+		advance_sample();
+		return;
+	}
+
+	// samples swept at several window sizes are started once per size
+	if (std::none_of(notes.begin(), notes.end(), [&app_id](const auto &sample_notes) { return sample_notes.first == app_id; }))
+	{
+		auto target_notes = target->get_benchmark_notes();
+		for (auto &note : target_notes)
+		{
+			LOGI("[Benchmark Mode] {}: {}", app_id, note);
+		}
+		notes.emplace_back(app_id, std::move(target_notes));
+	}
+
+	// a target reporting its processing resolution can be switched to every resolution in place
+	processing_resolutions = !resolutions.empty() && target->get_processing_extent().width != 0;
+	if (processing_resolutions && !set_processing_resolution(resolution_index))
+	{
+		advance_resolution();
+		return;
+	}
+
+	begin_batches();
 }
 
 void BenchmarkMode::on_app_close(const std::string &app_id)
 {
 	LOGI("Benchmark for {} completed in {} seconds (ran {} frames, averaged {} fps)", app_id, elapsed_time, total_frames, total_frames / elapsed_time);
+
+	// The platform was closed before the sweep completed, keep what has been measured so far
+	if (!results_written && !records.empty())
+	{
+		LOGW("[Benchmark Mode] Sweep did not complete, writing partial results");
+		write_results();
+	}
+}
+
+void BenchmarkMode::on_post_draw(vkb::RenderContext &context)
+{
+	if (!target)
+	{
+		return;
+	}
+
+	if (device_name.empty())
+	{
+		auto &gpu      = context.get_device().get_gpu();
+		device_name    = gpu.get_properties().deviceName;
+		driver_version = gpu.get_properties().driverVersion;
+		device_uuid    = gpu.get_uuid();
+	}
+
+	auto &record = records.back();
+	if (variant_frames == 0)
+	{
+		auto extent   = target->get_processing_extent();
+		record.width  = extent.width != 0 ? extent.width : context.get_surface_extent().width;
+		record.height = extent.height != 0 ? extent.height : context.get_surface_extent().height;
+
+		record.batch_size = target->get_batch_size();
+	}
+
+	if (++variant_frames <= warmup_frames)
+	{
+		return;
+	}
+
+	// frames whose timestamps have not been read back yet report nothing instead of repeating the previous frame
+	auto pass_times = target->get_benchmark_pass_times();
+	if (!pass_times.empty())
+	{
+		++variant_samples;
+	}
+
+	for (auto &pass_time : pass_times)
+	{
+		auto it = std::find_if(record.passes.begin(), record.passes.end(),
+		                       [&pass_time](const auto &pass) { return pass.first == pass_time.name; });
+		if (it == record.passes.end())
+		{
+			record.passes.emplace_back(pass_time.name, vkb::TimingStatistics{measured_frames});
+			it = std::prev(record.passes.end());
+		}
+		it->second.push(pass_time.time);
+	}
+
+	bool converged = precision > 0.0 && !record.passes.empty() &&
+	                 std::all_of(record.passes.begin(), record.passes.end(),
+	                             [this](const auto &pass) { return pass.second.is_converged(precision, std::min<size_t>(min_converged_frames, measured_frames)); });
+
+	// a target reporting no new times does not stall the sweep, the frames without times are bounded by the measured frames
+	bool complete = variant_samples == measured_frames || variant_frames == warmup_frames + 2 * measured_frames;
+
+	if (converged || complete)
+	{
+		if (variant_samples < measured_frames && !converged)
+		{
+			LOGW("[Benchmark Mode] {} {} {}: only {} of {} frames reported new pass times",
+			     record.filter, record.variant.type, record.variant.window, variant_samples, measured_frames);
+		}
+
+		for (auto &pass : record.passes)
+		{
+			auto summary = pass.second.get_summary();
+			LOGI("[Benchmark Mode] {} {} {} {}x{}x{} {}: median {:.4f} ms ({:.1f} Mpix/s), mean {:.4f} ms (+-{:.4f}), p99 {:.4f} ms, {} outliers in {} frames",
+			     record.filter, record.variant.type, record.variant.window, record.width, record.height, record.batch_size, pass.first,
+			     summary.median, get_mpix_per_s(record.width, record.height, record.batch_size, summary.median), summary.mean, summary.ci95, summary.p99,
+			     summary.outliers, summary.count);
+		}
+
+		record.metrics = target->finish_benchmark_variant();
+		for (auto &metric : record.metrics)
+		{
+			LOGI("[Benchmark Mode] {} {} {} {}x{}x{} {}: {:.6f}",
+			     record.filter, record.variant.type, record.variant.window, record.width, record.height, record.batch_size, metric.name, metric.value);
+		}
+
+		advance();
+	}
+}
+
+void BenchmarkMode::begin_variant(size_t index)
+{
+	variant_index   = index;
+	variant_frames  = 0;
+	variant_samples = 0;
+
+	target->set_benchmark_variant(index);
+
+	Record record;
+	record.filter  = target_id;
+	record.variant = variants[index];
+	records.push_back(std::move(record));
+}
+
+bool BenchmarkMode::begin_supported_variant(size_t index)
+{
+	for (; index < variants.size(); ++index)
+	{
+		if (target->is_benchmark_variant_supported(index))
+		{
+			begin_variant(index);
+			return true;
+		}
+	}
+	return false;
+}
+
+void BenchmarkMode::advance()
+{
+	if (begin_supported_variant(variant_index + 1))
+	{
+		return;
+	}
+
+	advance_batch();
+}
+
+void BenchmarkMode::begin_batches()
+{
+	// the variants are swept for every batch size, starting with the first one the target supports
+	if ((batch_sizes.empty() || set_batch_size(0)) && begin_supported_variant(0))
+	{
+		return;
+	}
+
+	advance_batch();
+}
+
+void BenchmarkMode::advance_batch()
+{
+	// All variants done, continue with the next batch size at the same resolution
+	while (batch_index + 1 < batch_sizes.size())
+	{
+		if (set_batch_size(batch_index + 1) && begin_supported_variant(0))
+		{
+			return;
+		}
+	}
+
+	advance_resolution();
+}
+
+void BenchmarkMode::advance_resolution()
+{
+	// All variants done, continue with the same sample at the next resolution
+	while (resolution_index + 1 < resolutions.size())
+	{
+		if (!processing_resolutions)
+		{
+			target = nullptr;
+			request_resolution(resolution_index + 1);
+			platform->request_application(apps::get_app(target_id));
+			return;
+		}
+
+		// the sample stays running, resolutions the target does not support are skipped
+		if (set_processing_resolution(resolution_index + 1))
+		{
+			begin_batches();
+			return;
+		}
+	}
+
+	advance_sample();
+}
+
+void BenchmarkMode::advance_sample()
+{
+	target = nullptr;
+
+	if (sample_index + 1 < sweep_samples.size())
+	{
+		++sample_index;
+		if (!resolutions.empty())
+		{
+			request_resolution(0);
+		}
+		platform->request_application(apps::get_app(sweep_samples[sample_index]));
+		return;
+	}
+
+	write_results();
+	platform->close();
+}
+
+void BenchmarkMode::request_resolution(size_t index)
+{
+	resolution_index = index;
+
+	auto &resolution = resolutions[index];
+	auto  extent     = platform->get_window().resize({resolution.first, resolution.second});
+	if (extent.width != resolution.first || extent.height != resolution.second)
+	{
+		LOGW("[Benchmark Mode] Window could not be resized to {}x{}, running at {}x{}",
+		     resolution.first, resolution.second, extent.width, extent.height);
+	}
+}
+
+bool BenchmarkMode::set_processing_resolution(size_t index)
+{
+	resolution_index = index;
+
+	auto &resolution = resolutions[index];
+	if (!target->set_processing_extent({resolution.first, resolution.second}))
+	{
+		LOGW("[Benchmark Mode] {} can not process at {}x{}, skipping", target_id, resolution.first, resolution.second);
+		skipped.push_back({target_id, resolution.first, resolution.second, target->get_batch_size(), "resolution not supported"});
+		return false;
+	}
+	return true;
+}
+
+bool BenchmarkMode::set_batch_size(size_t index)
+{
+	batch_index = index;
+
+	// targets without batches still run the batch of a single image
+	uint32_t batch_size = batch_sizes[index];
+	if (target->get_batch_size() != batch_size && !target->set_batch_size(batch_size))
+	{
+		LOGW("[Benchmark Mode] {} can not filter batches of {} images, skipping", target_id, batch_size);
+		auto extent = target->get_processing_extent();
+		skipped.push_back({target_id, extent.width, extent.height, batch_size, "batch size not supported"});
+		return false;
+	}
+	return true;
+}
+
+void BenchmarkMode::write_results()
+{
+	results_written = true;
+
+	if (!baseline_file.empty() && !records.empty())
+	{
+		compare_baseline();
+	}
+
+	if (output_file.empty() || records.empty())
+	{
+		return;
+	}
+
+	if (ends_with(output_file, ".csv"))
+	{
+		write_csv(output_file);
+	}
+	else
+	{
+		write_json(output_file);
+	}
+
+	LOGI("[Benchmark Mode] Results written to {}", output_file);
+}
+
+void BenchmarkMode::write_json(const std::string &filename) const
+{
+	nlohmann::json results = nlohmann::json::array();
+
+	for (auto &record : records)
+	{
+		if (record.passes.empty())
+		{
+			continue;
+		}
+
+		nlohmann::json passes = nlohmann::json::array();
+		for (auto &pass : record.passes)
+		{
+			auto summary = pass.second.get_summary();
+			passes.push_back({{"name", pass.first},
+			                  {"frames", summary.count},
+			                  {"min_ms", summary.min},
+			                  {"max_ms", summary.max},
+			                  {"mean_ms", summary.mean},
+			                  {"median_ms", summary.median},
+			                  {"mpix_per_s", get_mpix_per_s(record.width, record.height, record.batch_size, summary.median)},
+			                  {"p90_ms", summary.p90},
+			                  {"p99_ms", summary.p99},
+			                  {"stddev_ms", summary.stddev},
+			                  {"ci95_ms", summary.ci95},
+			                  {"outliers", summary.outliers},
+			                  {"converged", precision > 0.0 && pass.second.is_converged(precision, std::min<size_t>(min_converged_frames, measured_frames))},
+			                  {"times_ms", pass.second.get_samples()}});
+		}
+
+		nlohmann::json metrics = nlohmann::json::object();
+		for (auto &metric : record.metrics)
+		{
+			metrics[metric.name] = metric.value;
+		}
+
+		results.push_back({{"filter", record.filter},
+		                   {"type", record.variant.type},
+		                   {"window", record.variant.window},
+		                   {"width", record.width},
+		                   {"height", record.height},
+		                   {"batch_size", record.batch_size},
+		                   {"passes", passes},
+		                   {"metrics", metrics}});
+	}
+
+	nlohmann::json skipped_results = nlohmann::json::array();
+	for (auto &entry : skipped)
+	{
+		skipped_results.push_back({{"filter", entry.filter},
+		                           {"width", entry.width},
+		                           {"height", entry.height},
+		                           {"batch_size", entry.batch_size},
+		                           {"reason", entry.reason}});
+	}
+
+	nlohmann::json sample_notes = nlohmann::json::object();
+	for (auto &sample : notes)
+	{
+		if (!sample.second.empty())
+		{
+			sample_notes[sample.first] = sample.second;
+		}
+	}
+
+	nlohmann::json json = {{"device", device_name},
+	                       {"device_uuid", device_uuid},
+	                       {"driver_version", driver_version},
+	                       {"warmup_frames", warmup_frames},
+	                       {"measured_frames", measured_frames},
+	                       {"precision", precision},
+	                       {"notes", sample_notes},
+	                       {"results", results},
+	                       {"skipped", skipped_results}};
+
+	std::ofstream out{filename, std::ios::trunc};
+	if (!out.is_open())
+	{
+		LOGE("[Benchmark Mode] Failed to open {}", filename);
+		return;
+	}
+	out << json.dump(2) << std::endl;
+}
+
+void BenchmarkMode::write_csv(const std::string &filename) const
+{
+	std::ofstream out{filename, std::ios::trunc};
+	if (!out.is_open())
+	{
+		LOGE("[Benchmark Mode] Failed to open {}", filename);
+		return;
+	}
+
+	out << "device,filter,type,window,width,height,batch_size,pass,frame,time_ms,mpix_per_s,outlier\n";
+	for (auto &record : records)
+	{
+		for (auto &pass : record.passes)
+		{
+			auto times = pass.second.get_samples();
+			for (size_t frame = 0; frame < times.size(); ++frame)
+			{
+				out << '"' << device_name << "\"," << record.filter << ',' << record.variant.type << ',' << record.variant.window << ','
+				    << record.width << ',' << record.height << ',' << record.batch_size << ',' << pass.first << ',' << frame << ',' << times[frame] << ','
+				    << get_mpix_per_s(record.width, record.height, record.batch_size, times[frame]) << ',' << pass.second.is_outlier(times[frame]) << '\n';
+			}
+		}
+	}
+}
+
+void BenchmarkMode::compare_baseline()
+{
+	nlohmann::json baseline = {{"version", baseline_version}, {"entries", nlohmann::json::array()}};
+
+	std::ifstream in{baseline_file};
+	if (in.is_open())
+	{
+		try
+		{
+			in >> baseline;
+		}
+		catch (const nlohmann::json::exception &e)
+		{
+			LOGE("[Benchmark Mode] Failed to parse the baseline {}: {}", baseline_file, e.what());
+			platform->set_failed();
+			return;
+		}
+	}
+	else if (!update_baseline)
+	{
+		LOGW("[Benchmark Mode] No baseline at {}, store one with --benchmark-update-baseline", baseline_file);
+		return;
+	}
+	in.close();
+
+	if (baseline.value("version", 0) != baseline_version || !baseline.contains("entries"))
+	{
+		LOGE("[Benchmark Mode] {} is not a baseline of version {}", baseline_file, baseline_version);
+		platform->set_failed();
+		return;
+	}
+
+	auto &entries = baseline["entries"];
+
+	size_t compared     = 0;
+	size_t regressions  = 0;
+	size_t improvements = 0;
+	for (auto &record : records)
+	{
+		if (record.passes.empty())
+		{
+			continue;
+		}
+
+		// the results of a device and driver are only compared to their own
+		nlohmann::json key = {{"device_uuid", device_uuid},
+		                      {"driver_version", driver_version},
+		                      {"filter", record.filter},
+		                      {"type", record.variant.type},
+		                      {"window", record.variant.window},
+		                      {"width", record.width},
+		                      {"height", record.height},
+		                      {"batch_size", record.batch_size}};
+
+		auto entry = std::find_if(entries.begin(), entries.end(), [&key](const nlohmann::json &entry) {
+			for (auto &item : key.items())
+			{
+				if (!entry.contains(item.key()) || entry.at(item.key()) != item.value())
+				{
+					return false;
+				}
+			}
+			return true;
+		});
+
+		for (auto &pass : record.passes)
+		{
+			if (entry == entries.end() || !(*entry)["passes"].contains(pass.first))
+			{
+				LOGW("[Benchmark Mode] {} {} {} {}x{}x{} {}: not in the baseline",
+				     record.filter, record.variant.type, record.variant.window, record.width, record.height, record.batch_size, pass.first);
+				continue;
+			}
+
+			auto reference = (*entry)["passes"][pass.first].get<std::vector<double>>();
+			auto times     = pass.second.get_samples();
+
+			double reference_median = get_median(reference);
+			double median           = get_median(times);
+			double change           = reference_median > 0.0 ? median / reference_median - 1.0 : 0.0;
+
+			// the effect size threshold keeps significant but negligible changes from failing the run
+			double p_slower = vkb::TimingStatistics::mann_whitney_greater(times, reference);
+			double p_faster = vkb::TimingStatistics::mann_whitney_greater(reference, times);
+			++compared;
+
+			if (p_slower < regression_significance && change > regression_threshold)
+			{
+				LOGE("[Benchmark Mode] {} {} {} {}x{}x{} {}: regressed, median {:.4f} ms against {:.4f} ms ({:+.1f}%, p = {:.2g})",
+				     record.filter, record.variant.type, record.variant.window, record.width, record.height, record.batch_size, pass.first,
+				     median, reference_median, 100.0 * change, p_slower);
+				++regressions;
+			}
+			else if (p_faster < regression_significance && change < -regression_threshold)
+			{
+				LOGI("[Benchmark Mode] {} {} {} {}x{}x{} {}: improved, median {:.4f} ms against {:.4f} ms ({:+.1f}%, p = {:.2g})",
+				     record.filter, record.variant.type, record.variant.window, record.width, record.height, record.batch_size, pass.first,
+				     median, reference_median, 100.0 * change, p_faster);
+				++improvements;
+			}
+			else
+			{
+				LOGI("[Benchmark Mode] {} {} {} {}x{}x{} {}: unchanged, median {:.4f} ms against {:.4f} ms ({:+.1f}%)",
+				     record.filter, record.variant.type, record.variant.window, record.width, record.height, record.batch_size, pass.first,
+				     median, reference_median, 100.0 * change);
+			}
+		}
+
+		if (update_baseline)
+		{
+			nlohmann::json updated = key;
+			updated["device"]      = device_name;
+			updated["passes"]      = nlohmann::json::object();
+			for (auto &pass : record.passes)
+			{
+				updated["passes"][pass.first] = pass.second.get_samples();
+			}
+
+			if (entry != entries.end())
+			{
+				*entry = std::move(updated);
+			}
+			else
+			{
+				entries.push_back(std::move(updated));
+			}
+		}
+	}
+
+	LOGI("[Benchmark Mode] {} passes compared to {}: {} regressions, {} improvements", compared, baseline_file, regressions, improvements);
+
+	if (update_baseline)
+	{
+		std::ofstream out{baseline_file, std::ios::trunc};
+		if (!out.is_open())
+		{
+			LOGE("[Benchmark Mode] Failed to open {}", baseline_file);
+			platform->set_failed();
+			return;
+		}
+		out << baseline.dump(2) << std::endl;
+		LOGI("[Benchmark Mode] Baseline written to {}", baseline_file);
+		return;
+	}
+
+	if (regressions > 0)
+	{
+		platform->set_failed();
+	}
 }
-}        // namespace plugins
\ No newline at end of file
+}        // namespace plugins
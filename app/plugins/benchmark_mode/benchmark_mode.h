@@ -1,4 +1,4 @@
-/* Copyright (c) 2020-2021, Arm Limited and Contributors
+/* Copyright (c) 2020-2023, Arm Limited and Contributors
  *
  * SPDX-License-Identifier: Apache-2.0
  *
@@ -17,7 +17,13 @@
 
 #pragma once
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "benchmark_target.h"
 #include "platform/plugins/plugin_base.h"
+#include "stats/timing_statistics.h"
 
 namespace plugins
 {
@@ -27,11 +33,32 @@ using BenchmarkModeTags = vkb::PluginBase<BenchmarkMode, vkb::tags::Passive>;
 
 /**
  * @brief Benchmark Mode
- * 
+ *
  * When enabled frame time statistics of a samples run will be printed to the console when an application closes. The simulation frame time (delta time) is also locked to 60FPS so that statistics can be compared more accurately across different devices.
- * 
+ *
+ * Samples implementing vkb::BenchmarkTarget are swept instead: every variant is run for a number of warmup frames followed by a number of measured frames,
+ * for every requested resolution and every requested sample. With --benchmark-precision a variant stops early once the 95% confidence interval of the mean
+ * of every pass is within the given fraction of the mean. The per-pass GPU timings and their statistics are written to a JSON or CSV file (chosen by the
+ * file extension) and the application closes once the sweep is complete. Combine with --headless to run without a display.
+ * Further results a target reports for a variant, such as the error of a reduced precision variant, are logged and written to the JSON file,
+ * as are the notes of a target on what its results do not cover.
+ * Targets with a processing resolution independent of the window are switched to each resolution in place and the window only shows the scaled
+ * result, other samples are restarted with the window resized. The throughput of every pass is reported in megapixels per second of the resolution.
+ * With --benchmark-image-batches the variants of every resolution are also swept for each number of images a target filters per frame, the pass
+ * times then cover the whole batch and the throughput counts every image of it. The batch sizes and resolutions a target can not be switched to are
+ * listed in the JSON file rather than measured.
+ *
+ * With --benchmark-baseline the measured frame times are compared to the ones stored in a baseline JSON file for the same device, driver,
+ * sample, variant, resolution and batch. A pass regressed if a one-sided Mann-Whitney U test finds its times larger at a significance of 1%
+ * and its median increased by more than --benchmark-regression-threshold (5% by default); the application then exits with a non-zero status.
+ * --benchmark-update-baseline stores the measured times in the baseline file instead of failing.
+ *
  * Usage: vulkan_samples sample afbc --benchmark
- * 
+ *
+ * Usage: vulkan_samples sample gaussian_filter --headless --benchmark --benchmark-samples tent_filter bilateral_filter --benchmark-resolutions 1280x720 1920x1080 --benchmark-output filters.json
+ *
+ * Usage: vulkan_samples sample convolution_filter --offscreen --benchmark --benchmark-baseline baseline.json --benchmark-regression-threshold 0.03
+ *
  */
 class BenchmarkMode : public BenchmarkModeTags
 {
@@ -50,11 +77,160 @@ class BenchmarkMode : public BenchmarkModeTags
 
 	virtual void on_app_close(const std::string &app_info) override;
 
+	virtual void on_post_draw(vkb::RenderContext &context) override;
+
 	vkb::FlagCommand benchmark_flag = {vkb::FlagType::FlagOnly, "benchmark", "", "Enable benchmark mode"};
 
+	vkb::FlagCommand warmup_flag = {vkb::FlagType::OneValue, "benchmark-warmup", "", "Number of frames to discard before measuring each variant"};
+
+	vkb::FlagCommand frames_flag = {vkb::FlagType::OneValue, "benchmark-frames", "", "Number of frames to measure for each variant"};
+
+	vkb::FlagCommand precision_flag = {vkb::FlagType::OneValue, "benchmark-precision", "", "Stop measuring a variant once the 95% confidence interval is within this fraction of the mean (e.g. 0.01)"};
+
+	vkb::FlagCommand resolutions_flag = {vkb::FlagType::ManyValues, "benchmark-resolutions", "", "Resolutions to sweep, given as WIDTHxHEIGHT"};
+
+	vkb::FlagCommand batches_flag = {vkb::FlagType::ManyValues, "benchmark-image-batches", "", "Numbers of images filtered per frame to sweep"};
+
+	vkb::FlagCommand samples_flag = {vkb::FlagType::ManyValues, "benchmark-samples", "", "Further samples to sweep after the started one"};
+
+	vkb::FlagCommand output_flag = {vkb::FlagType::OneValue, "benchmark-output", "", "Write the sweep results to the given .json or .csv file"};
+
+	vkb::FlagCommand baseline_flag = {vkb::FlagType::OneValue, "benchmark-baseline", "", "Compare the GPU times to the baseline JSON file and fail on regressions"};
+
+	vkb::FlagCommand update_baseline_flag = {vkb::FlagType::FlagOnly, "benchmark-update-baseline", "", "Store the GPU times in the baseline file instead of failing on regressions"};
+
+	vkb::FlagCommand regression_threshold_flag = {vkb::FlagType::OneValue, "benchmark-regression-threshold", "", "Minimum relative increase of the median GPU time of a pass counted as a regression (default 0.05)"};
+
   private:
+	/// Measurements of a single (sample, variant, resolution) combination
+	struct Record
+	{
+		std::string filter;
+
+		vkb::BenchmarkTarget::Variant variant;
+
+		uint32_t width{0};
+
+		uint32_t height{0};
+
+		/// Number of images filtered per frame, the pass times cover all of them
+		uint32_t batch_size{1};
+
+		/// Per pass name, the GPU times of the measured frames in milliseconds
+		std::vector<std::pair<std::string, vkb::TimingStatistics>> passes;
+
+		/// Further results reported by the target once the variant has been measured
+		std::vector<vkb::BenchmarkTarget::Metric> metrics;
+	};
+
 	uint32_t total_frames{0};
 
 	float elapsed_time{0.0f};
+
+	uint32_t warmup_frames{30};
+
+	uint32_t measured_frames{100};
+
+	/// Relative confidence interval at which a variant stops early, 0 disables early stopping
+	double precision{0.0};
+
+	std::vector<std::pair<uint32_t, uint32_t>> resolutions;
+
+	std::vector<uint32_t> batch_sizes;
+
+	/// Whether the resolutions are swept through the processing resolution of the target instead of the window size
+	bool processing_resolutions{false};
+
+	std::vector<std::string> sweep_samples;
+
+	std::string output_file;
+
+	std::string baseline_file;
+
+	bool update_baseline{false};
+
+	double regression_threshold{0.05};
+
+	/// The sample being swept, nullptr if the active app is not a benchmark target
+	vkb::BenchmarkTarget *target{nullptr};
+
+	std::string target_id;
+
+	std::vector<vkb::BenchmarkTarget::Variant> variants;
+
+	size_t variant_index{0};
+
+	size_t resolution_index{0};
+
+	size_t batch_index{0};
+
+	size_t sample_index{0};
+
+	uint32_t variant_frames{0};
+
+	/// Frames of the current variant that reported new pass times
+	uint32_t variant_samples{0};
+
+	std::string device_name;
+
+	/// Identify the device and driver of the baseline entries
+	std::string device_uuid;
+
+	uint32_t driver_version{0};
+
+	std::vector<Record> records;
+
+	/// A batch size or processing resolution a target could not be switched to
+	struct Skipped
+	{
+		std::string filter;
+
+		uint32_t width{0};
+
+		uint32_t height{0};
+
+		uint32_t batch_size{1};
+
+		std::string reason;
+	};
+
+	std::vector<Skipped> skipped;
+
+	/// Per swept sample, the notes of the target on what its results do not cover
+	std::vector<std::pair<std::string, std::vector<std::string>>> notes;
+
+	bool results_written{false};
+
+	void begin_variant(size_t index);
+
+	/**
+	 * @brief Begins the first variant from index on that the target supports
+	 * @return False if the target supports none of them
+	 */
+	bool begin_supported_variant(size_t index);
+
+	void advance();
+
+	void begin_batches();
+
+	void advance_batch();
+
+	void advance_sample();
+
+	void request_resolution(size_t index);
+
+	void advance_resolution();
+
+	bool set_processing_resolution(size_t index);
+
+	bool set_batch_size(size_t index);
+
+	void write_results();
+
+	void write_json(const std::string &filename) const;
+
+	void write_csv(const std::string &filename) const;
+
+	void compare_baseline();
 };
-}        // namespace plugins
\ No newline at end of file
+}        // namespace plugins
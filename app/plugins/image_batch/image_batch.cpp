@@ -0,0 +1,56 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "image_batch.h"
+
+#include "benchmark_target.h"
+#include "platform/platform.h"
+
+namespace plugins
+{
+ImageBatch::ImageBatch() :
+    ImageBatchTags("Image Batch",
+                   "Filter a batch of images per frame",
+                   {vkb::Hook::OnAppStart}, {&image_batch_flag})
+{
+}
+
+bool ImageBatch::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&image_batch_flag);
+}
+
+void ImageBatch::init(const vkb::CommandParser &parser)
+{
+	batch_size = parser.as<uint32_t>(&image_batch_flag);
+	if (batch_size == 0)
+	{
+		LOGE("[Image Batch] A batch has to hold at least one image");
+		throw std::runtime_error{"Can not continue"};
+	}
+}
+
+void ImageBatch::on_app_start(const std::string &app_id)
+{
+	auto *target = dynamic_cast<vkb::BenchmarkTarget *>(&platform->get_app());
+	if (!target || !target->set_batch_size(batch_size))
+	{
+		LOGW("[Image Batch] {} can not filter batches of {} images, filtering one image per frame", app_id, batch_size);
+	}
+}
+}        // namespace plugins
@@ -0,0 +1,60 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class ImageBatch;
+
+// Passive behaviour
+using ImageBatchTags = vkb::PluginBase<ImageBatch, vkb::tags::Passive>;
+
+/**
+ * @brief Image Batch
+ *
+ * Filter a batch of images per frame instead of a single one, which amortizes the submission and
+ * pass overheads that dominate at small resolutions. The pass times then cover the whole batch.
+ * Samples that do not implement vkb::BenchmarkTarget::set_batch_size keep filtering one image.
+ *
+ * Usage: vulkan_sample sample convolution_filter --image-batch 16 --processing-resolution 640x480
+ *
+ */
+class ImageBatch : public ImageBatchTags
+{
+  public:
+	ImageBatch();
+
+	virtual ~ImageBatch() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_app_start(const std::string &app_info) override;
+
+	vkb::FlagCommand image_batch_flag = {vkb::FlagType::OneValue, "image-batch", "", "Number of images the filters process per frame"};
+
+  private:
+	uint32_t batch_size{1};
+};
+}        // namespace plugins
@@ -0,0 +1,41 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "lazy_pipelines.h"
+
+#include "pipeline_builder.h"
+
+namespace plugins
+{
+LazyPipelines::LazyPipelines() :
+    LazyPipelinesTags("Lazy Pipelines",
+                      "Build the pipelines of a sample in the background, except the ones it starts with",
+                      {}, {&lazy_pipelines_flag})
+{
+}
+
+bool LazyPipelines::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&lazy_pipelines_flag);
+}
+
+void LazyPipelines::init(const vkb::CommandParser &parser)
+{
+	vkb::PipelineBuilder::set_lazy_enabled(true);
+}
+}        // namespace plugins
@@ -0,0 +1,52 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class LazyPipelines;
+
+// Passive behaviour
+using LazyPipelinesTags = vkb::PluginBase<LazyPipelines, vkb::tags::Passive>;
+
+/**
+ * @brief Lazy Pipelines
+ *
+ * Only build the pipelines a sample draws its first frame with before starting it, and build
+ * the others in the background. Switching to a pipeline that is not ready yet waits for it.
+ *
+ * Usage: vulkan_sample sample gaussian_filter --lazy-pipelines
+ *
+ */
+class LazyPipelines : public LazyPipelinesTags
+{
+  public:
+	LazyPipelines();
+
+	virtual ~LazyPipelines() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	vkb::FlagCommand lazy_pipelines_flag = {vkb::FlagType::FlagOnly, "lazy-pipelines", "", "Build the pipelines the sample does not start with in the background"};
+};
+}        // namespace plugins
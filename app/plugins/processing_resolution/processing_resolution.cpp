@@ -0,0 +1,58 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "processing_resolution.h"
+
+#include <cstdio>
+
+#include "benchmark_target.h"
+#include "platform/platform.h"
+
+namespace plugins
+{
+ProcessingResolution::ProcessingResolution() :
+    ProcessingResolutionTags("Processing Resolution",
+                             "Run the filters of a sample at a fixed resolution, independent of the window size",
+                             {vkb::Hook::OnAppStart}, {&processing_resolution_flag})
+{
+}
+
+bool ProcessingResolution::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&processing_resolution_flag);
+}
+
+void ProcessingResolution::init(const vkb::CommandParser &parser)
+{
+	auto resolution = parser.as<std::string>(&processing_resolution_flag);
+	if (std::sscanf(resolution.c_str(), "%ux%u", &width, &height) != 2 || width == 0 || height == 0)
+	{
+		LOGE("[Processing Resolution] Invalid resolution {}, expected WIDTHxHEIGHT", resolution);
+		throw std::runtime_error{"Can not continue"};
+	}
+}
+
+void ProcessingResolution::on_app_start(const std::string &app_id)
+{
+	auto *target = dynamic_cast<vkb::BenchmarkTarget *>(&platform->get_app());
+	if (!target || !target->set_processing_extent({width, height}))
+	{
+		LOGW("[Processing Resolution] {} can not run at {}x{}, using the window size", app_id, width, height);
+	}
+}
+}        // namespace plugins
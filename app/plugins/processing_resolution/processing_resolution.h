@@ -0,0 +1,62 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class ProcessingResolution;
+
+// Passive behaviour
+using ProcessingResolutionTags = vkb::PluginBase<ProcessingResolution, vkb::tags::Passive>;
+
+/**
+ * @brief Processing Resolution
+ *
+ * Run the filters of a sample at a resolution independent of the window, such as 3840x2160 in a
+ * small window. The result is scaled to the window. Samples that do not implement
+ * vkb::BenchmarkTarget::set_processing_extent keep filtering at the window size.
+ *
+ * Usage: vulkan_sample sample gaussian_filter --processing-resolution 3840x2160
+ *
+ */
+class ProcessingResolution : public ProcessingResolutionTags
+{
+  public:
+	ProcessingResolution();
+
+	virtual ~ProcessingResolution() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_app_start(const std::string &app_info) override;
+
+	vkb::FlagCommand processing_resolution_flag = {vkb::FlagType::OneValue, "processing-resolution", "", "Resolution the filters run at, as WIDTHxHEIGHT"};
+
+  private:
+	uint32_t width{0};
+
+	uint32_t height{0};
+};
+}        // namespace plugins
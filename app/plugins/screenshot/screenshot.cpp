@@ -20,6 +20,8 @@
 #include <chrono>
 #include <iomanip>
 
+#include "benchmark_target.h"
+#include "platform/platform.h"
 #include "rendering/render_context.h"
 
 namespace plugins
@@ -82,6 +84,17 @@ void Screenshot::on_post_draw(vkb::RenderContext &context)
 			output_path = stream.str();
 		}
 
+		// offscreen there is no swapchain image to capture, only the output of the filter
+		if (platform->get_window().get_window_mode() == vkb::Window::Mode::Offscreen)
+		{
+			auto *target = dynamic_cast<vkb::BenchmarkTarget *>(&platform->get_app());
+			if (!target || !target->save_output(output_path))
+			{
+				LOGW("[Screenshot] {} has no output image to capture offscreen", current_app_name);
+			}
+			return;
+		}
+
 		screenshot(context, output_path);
 	}
 }
@@ -31,6 +31,8 @@ using ScreenshotTags = vkb::PluginBase<Screenshot, vkb::tags::Passive>;
  * 
  * Capture a screen shot of the last rendered image at a given frame. The output can also be named
  * 
+ * With --offscreen the output image of the filter samples is captured instead, at its processing resolution
+ * 
  * Usage: vulkan_sample sample afbc --screenshot 1 --screenshot-output afbc-screenshot
  * 
  */
@@ -0,0 +1,108 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_output.h"
+
+#include <algorithm>
+#include <fstream>
+
+#include <json.hpp>
+
+#include "common/logging.h"
+#include "stats/trace_recorder.h"
+
+namespace plugins
+{
+namespace
+{
+// tid of each track in the trace, the track names are set through metadata events
+constexpr std::pair<vkb::TraceRecorder::Track, const char *> tracks[] = {
+    {vkb::TraceRecorder::Track::CPU, "CPU"},
+    {vkb::TraceRecorder::Track::GPU, "GPU"},
+    {vkb::TraceRecorder::Track::AsyncCompute, "GPU async compute"},
+};
+}        // namespace
+
+TraceOutput::TraceOutput() :
+    TraceOutputTags("Trace Output",
+                    "Write a timeline of the CPU frame phases and GPU passes as a Chrome JSON trace",
+                    {vkb::Hook::OnPlatformClose}, {&trace_output_flag})
+{
+}
+
+bool TraceOutput::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&trace_output_flag);
+}
+
+void TraceOutput::init(const vkb::CommandParser &parser)
+{
+	output_file = parser.as<std::string>(&trace_output_flag);
+	vkb::TraceRecorder::set_enabled(true);
+}
+
+void TraceOutput::on_platform_close()
+{
+	vkb::TraceRecorder::set_enabled(false);
+
+	auto events = vkb::TraceRecorder::get_events();
+	if (events.empty())
+	{
+		LOGW("[Trace Output] No events were recorded");
+		return;
+	}
+
+	// timestamps relative to the first event keep the numbers of the trace readable
+	double origin = std::min_element(events.begin(), events.end(), [](const vkb::TraceRecorder::Event &a, const vkb::TraceRecorder::Event &b) {
+		                return a.begin < b.begin;
+	                })->begin;
+
+	nlohmann::json trace_events = nlohmann::json::array();
+	for (auto &track : tracks)
+	{
+		trace_events.push_back({{"name", "thread_name"},
+		                        {"ph", "M"},
+		                        {"pid", 1},
+		                        {"tid", static_cast<int>(track.first)},
+		                        {"args", {{"name", track.second}}}});
+	}
+
+	for (auto &event : events)
+	{
+		trace_events.push_back({{"name", event.name},
+		                        {"cat", event.track == vkb::TraceRecorder::Track::CPU ? "cpu" : "gpu"},
+		                        {"ph", "X"},
+		                        {"pid", 1},
+		                        {"tid", static_cast<int>(event.track)},
+		                        {"ts", event.begin - origin},
+		                        {"dur", event.duration}});
+	}
+
+	nlohmann::json json = {{"traceEvents", trace_events},
+	                       {"displayTimeUnit", "ms"}};
+
+	std::ofstream out{output_file, std::ios::trunc};
+	if (!out.is_open())
+	{
+		LOGE("[Trace Output] Failed to open {}", output_file);
+		return;
+	}
+	out << json.dump() << std::endl;
+
+	LOGI("[Trace Output] {} events written to {}", events.size(), output_file);
+}
+}        // namespace plugins
@@ -0,0 +1,61 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class TraceOutput;
+
+// Passive behaviour
+using TraceOutputTags = vkb::PluginBase<TraceOutput, vkb::tags::Passive>;
+
+/**
+ * @brief Trace Output
+ *
+ * Record a timeline of the frames and write it as Chrome JSON trace events when the platform closes, to be opened
+ * in Perfetto (ui.perfetto.dev) or chrome://tracing. The CPU track holds the platform update, render, the acquire and
+ * present of prepare_frame and submit_frame, fence waits and command buffer recording. The GPU tracks hold the passes
+ * timed by the filter samples, mapped to the CPU clock with VK_EXT_calibrated_timestamps where available and with an
+ * estimated offset otherwise.
+ *
+ * Usage: vulkan_sample sample convolution_filter --trace-output frames.json --stop-after-frame 300
+ *
+ */
+class TraceOutput : public TraceOutputTags
+{
+  public:
+	TraceOutput();
+
+	virtual ~TraceOutput() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	virtual void on_platform_close() override;
+
+	vkb::FlagCommand trace_output_flag = {vkb::FlagType::OneValue, "trace-output", "", "Write a Chrome JSON trace of the frames to the given file"};
+
+  private:
+	std::string output_file;
+};
+}        // namespace plugins
@@ -66,6 +66,10 @@ void WindowOptions::init(const vkb::CommandParser &parser)
 	{
 		properties.mode = vkb::Window::Mode::Headless;
 	}
+	else if (parser.contains(&offscreen_flag))
+	{
+		properties.mode = vkb::Window::Mode::Offscreen;
+	}
 	else if (parser.contains(&fullscreen_flag))
 	{
 		properties.mode = vkb::Window::Mode::Fullscreen;
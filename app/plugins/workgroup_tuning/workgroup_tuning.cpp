@@ -0,0 +1,41 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "workgroup_tuning.h"
+
+#include "workgroup_tuner.h"
+
+namespace plugins
+{
+WorkgroupTuning::WorkgroupTuning() :
+    WorkgroupTuningTags("Workgroup Tuning",
+                        "Tune the workgroups of the compute passes of a sample for the device",
+                        {}, {&tune_workgroups_flag})
+{
+}
+
+bool WorkgroupTuning::is_active(const vkb::CommandParser &parser)
+{
+	return parser.contains(&tune_workgroups_flag);
+}
+
+void WorkgroupTuning::init(const vkb::CommandParser &parser)
+{
+	vkb::WorkgroupTuner::set_enabled(true);
+}
+}        // namespace plugins
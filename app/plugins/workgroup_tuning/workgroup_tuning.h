@@ -0,0 +1,52 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "platform/plugins/plugin_base.h"
+
+namespace plugins
+{
+class WorkgroupTuning;
+
+// Passive behaviour
+using WorkgroupTuningTags = vkb::PluginBase<WorkgroupTuning, vkb::tags::Passive>;
+
+/**
+ * @brief Workgroup Tuning
+ *
+ * Tune the workgroup shape and pixels per thread of the compute passes of a sample that have not been
+ * tuned on the device yet, and store the fastest configuration in the tuning database. Later runs use
+ * the tuned configurations without this flag.
+ *
+ * Usage: vulkan_sample sample convolution_filter --tune-workgroups
+ *
+ */
+class WorkgroupTuning : public WorkgroupTuningTags
+{
+  public:
+	WorkgroupTuning();
+
+	virtual ~WorkgroupTuning() = default;
+
+	virtual bool is_active(const vkb::CommandParser &parser) override;
+
+	virtual void init(const vkb::CommandParser &parser) override;
+
+	vkb::FlagCommand tune_workgroups_flag = {vkb::FlagType::FlagOnly, "tune-workgroups", "", "Tune the workgroups of the compute passes that have no entry in the tuning database"};
+};
+}        // namespace plugins
@@ -146,6 +146,10 @@ function(vkb__register_tests)
         target_link_libraries(${TARGET_NAME} PUBLIC ${TARGET_LINK_LIBS})
     endif()
 
+    if(TARGET_INCLUDE_DIRS)
+        target_include_directories(${TARGET_NAME} PUBLIC ${TARGET_INCLUDE_DIRS})
+    endif()
+
     if(${VKB_WARNINGS_AS_ERRORS})
         message(STATUS "Warnings as Errors Enabled")
         if ("${CMAKE_CXX_COMPILER_ID}" STREQUAL "Clang" OR "${CMAKE_CXX_COMPILER_ID}" STREQUAL "GNU")
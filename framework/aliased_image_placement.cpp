@@ -0,0 +1,55 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aliased_image_placement.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace vkb
+{
+std::vector<AliasedImageBlock> place_aliased_images(const std::vector<AliasedImageRequest> &images)
+{
+	std::vector<size_t> order(images.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(), [&images](size_t a, size_t b) { return images[a].requirements.size > images[b].requirements.size; });
+
+	std::vector<AliasedImageBlock> blocks;
+	for (size_t index : order)
+	{
+		auto &image = images[index];
+
+		auto block = std::find_if(blocks.begin(), blocks.end(), [&image](const AliasedImageBlock &block) {
+			return (block.variants & image.variants) == 0 && (block.requirements.memoryTypeBits & image.requirements.memoryTypeBits) != 0;
+		});
+
+		if (block == blocks.end())
+		{
+			blocks.push_back({image.requirements, 0, {}});
+			block = blocks.end() - 1;
+		}
+
+		block->requirements.size           = std::max(block->requirements.size, image.requirements.size);
+		block->requirements.alignment      = std::max(block->requirements.alignment, image.requirements.alignment);
+		block->requirements.memoryTypeBits &= image.requirements.memoryTypeBits;
+
+		block->images.push_back(index);
+		block->variants |= image.variants;
+	}
+	return blocks;
+}
+}        // namespace vkb
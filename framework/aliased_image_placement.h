@@ -0,0 +1,59 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief An image to place, with the bitmask of the variants using it
+ */
+struct AliasedImageRequest
+{
+	VkMemoryRequirements requirements;
+
+	uint64_t variants;
+};
+
+/**
+ * @brief Memory shared by images no variant uses together
+ */
+struct AliasedImageBlock
+{
+	/// Satisfies the requirements of all images of the block
+	VkMemoryRequirements requirements;
+
+	/// Variants using any image of the block
+	uint64_t variants;
+
+	/// Indices of the images of the block into the requests
+	std::vector<size_t> images;
+};
+
+/**
+ * @brief Places images into blocks of aliased memory, see vkb::AliasedImagePool
+ *        Images are placed largest first into the first block whose images they share no variant with
+ *        and whose memory types they support, or into a new block
+ */
+std::vector<AliasedImageBlock> place_aliased_images(const std::vector<AliasedImageRequest> &images);
+}        // namespace vkb
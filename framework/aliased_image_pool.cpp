@@ -0,0 +1,117 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "aliased_image_pool.h"
+
+#include <numeric>
+
+#include "aliased_image_placement.h"
+#include "core/device.h"
+
+namespace vkb
+{
+AliasedImagePool::AliasedImagePool(Device &device) :
+    device{device}
+{
+}
+
+AliasedImagePool::~AliasedImagePool()
+{
+	for (auto &entry : entries)
+	{
+		vkDestroyImage(device.get_handle(), entry.image->get_handle(), nullptr);
+	}
+
+	for (auto &block : blocks)
+	{
+		vmaFreeMemory(device.get_memory_allocator(), block.allocation);
+	}
+}
+
+core::Image &AliasedImagePool::request(const VkExtent3D &extent, VkFormat format, VkImageUsageFlags usage, uint64_t variants, uint32_t array_layers)
+{
+	assert(blocks.empty() && "Images have to be requested before the pool is allocated");
+
+	VkImageCreateInfo image_info{VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+	image_info.imageType     = VK_IMAGE_TYPE_2D;
+	image_info.format        = format;
+	image_info.extent        = extent;
+	image_info.mipLevels     = 1;
+	image_info.arrayLayers   = array_layers;
+	image_info.samples       = VK_SAMPLE_COUNT_1_BIT;
+	image_info.tiling        = VK_IMAGE_TILING_OPTIMAL;
+	image_info.usage         = usage;
+	image_info.sharingMode   = VK_SHARING_MODE_EXCLUSIVE;
+	image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+	VkImage handle = VK_NULL_HANDLE;
+	VK_CHECK(vkCreateImage(device.get_handle(), &image_info, nullptr, &handle));
+
+	Entry entry{std::make_unique<core::Image>(device, handle, extent, format, usage, VK_SAMPLE_COUNT_1_BIT, array_layers), {}, variants};
+	vkGetImageMemoryRequirements(device.get_handle(), handle, &entry.requirements);
+
+	entries.push_back(std::move(entry));
+	return *entries.back().image;
+}
+
+void AliasedImagePool::allocate()
+{
+	std::vector<AliasedImageRequest> requests;
+	for (auto &entry : entries)
+	{
+		requests.push_back({entry.requirements, entry.variants});
+	}
+
+	VmaAllocationCreateInfo allocation_info{};
+	allocation_info.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+
+	for (auto &block : place_aliased_images(requests))
+	{
+		VmaAllocation allocation = VK_NULL_HANDLE;
+		VK_CHECK(vmaAllocateMemory(device.get_memory_allocator(), &block.requirements, &allocation_info, &allocation, nullptr));
+		blocks.push_back({allocation, block.requirements.size});
+
+		for (size_t index : block.images)
+		{
+			VK_CHECK(vmaBindImageMemory(device.get_memory_allocator(), allocation, entries[index].image->get_handle()));
+		}
+	}
+}
+
+VkDeviceSize AliasedImagePool::get_variant_size(uint32_t variant) const
+{
+	VkDeviceSize size = 0;
+	for (auto &entry : entries)
+	{
+		if ((entry.variants & (uint64_t{1} << variant)) != 0)
+		{
+			size += entry.requirements.size;
+		}
+	}
+	return size;
+}
+
+VkDeviceSize AliasedImagePool::get_allocated_size() const
+{
+	return std::accumulate(blocks.begin(), blocks.end(), VkDeviceSize{0}, [](VkDeviceSize size, const Block &block) { return size + block.size; });
+}
+
+VkDeviceSize AliasedImagePool::get_requested_size() const
+{
+	return std::accumulate(entries.begin(), entries.end(), VkDeviceSize{0}, [](VkDeviceSize size, const Entry &entry) { return size + entry.requirements.size; });
+}
+}        // namespace vkb
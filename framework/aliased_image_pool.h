@@ -0,0 +1,110 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/image.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Allocates the images of a sample so that images no variant uses together share memory
+ *
+ * Every image is requested with the set of variants of the sample that use it. Two images whose sets
+ * are disjoint are never used by the same frame, so they are bound to the same VMA allocation (memory
+ * aliasing). Images are placed largest first into the first allocation whose images they share no
+ * variant with, which is sized for the largest image bound to it (see vkb::place_aliased_images).
+ *
+ * Aliased images have undefined contents whenever another image of their allocation was used since,
+ * so every variant has to transition its images from VK_IMAGE_LAYOUT_UNDEFINED before writing them,
+ * and the frames of the previous variant have to complete before the next one is submitted.
+ *
+ * The pool owns the images and their memory, its vkb::core::Image objects do not.
+ */
+class AliasedImagePool
+{
+  public:
+	AliasedImagePool(Device &device);
+
+	AliasedImagePool(const AliasedImagePool &) = delete;
+
+	AliasedImagePool(AliasedImagePool &&) = delete;
+
+	~AliasedImagePool();
+
+	AliasedImagePool &operator=(const AliasedImagePool &) = delete;
+
+	AliasedImagePool &operator=(AliasedImagePool &&) = delete;
+
+	/**
+	 * @brief Creates a 2D image with optimal tiling and a single mip level
+	 * @param variants Bitmask of the variants using the image
+	 * @param array_layers Number of layers of the image
+	 * @return The image, its views can only be created once allocate() bound it to memory
+	 */
+	core::Image &request(const VkExtent3D &extent, VkFormat format, VkImageUsageFlags usage, uint64_t variants, uint32_t array_layers = 1);
+
+	/**
+	 * @brief Allocates the memory of the requested images and binds them, called once all images were requested
+	 */
+	void allocate();
+
+	/**
+	 * @brief Returns the size in bytes of the images a variant uses
+	 */
+	VkDeviceSize get_variant_size(uint32_t variant) const;
+
+	/**
+	 * @brief Returns the size in bytes of the memory allocated for all images
+	 */
+	VkDeviceSize get_allocated_size() const;
+
+	/**
+	 * @brief Returns the size in bytes all images would take without aliasing
+	 */
+	VkDeviceSize get_requested_size() const;
+
+  private:
+	struct Entry
+	{
+		std::unique_ptr<core::Image> image;
+
+		VkMemoryRequirements requirements;
+
+		uint64_t variants;
+	};
+
+	struct Block
+	{
+		VmaAllocation allocation;
+
+		VkDeviceSize size;
+	};
+
+	Device &device;
+
+	std::vector<Entry> entries;
+
+	std::vector<Block> blocks;
+};
+}        // namespace vkb
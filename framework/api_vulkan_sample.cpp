@@ -17,13 +17,18 @@
 
 #include "api_vulkan_sample.h"
 
+#include <utility>
+
 #include "core/device.h"
 #include "core/swapchain.h"
 #include "gltf_loader.h"
+#include "pipeline_cache_data.h"
+#include "platform/filesystem.h"
 #include "scene_graph/components/image.h"
 #include "scene_graph/components/sampler.h"
 #include "scene_graph/components/sub_mesh.h"
 #include "scene_graph/components/texture.h"
+#include "stats/trace_recorder.h"
 
 bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 {
@@ -34,22 +39,13 @@ bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 
 	depth_format = vkb::get_suitable_depth_format(device->get_gpu().get_handle());
 
-	// Create synchronization objects
-	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
-	// Create a semaphore used to synchronize image presentation
-	// Ensures that the current swapchain render target has completed presentation and has been released by the presentation engine, ready for rendering
-	VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &semaphores.acquired_image_ready));
-	// Create a semaphore used to synchronize command submission
-	// Ensures that the image is not presented until all commands have been sumbitted and executed
-	VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &semaphores.render_complete));
-
 	// Set up submit info structure
-	// Semaphores will stay the same during application lifetime
+	// The semaphores of the current frame are set by prepare_frame(), they are created with the fences
 	// Command buffer submission info is set by each example
 	submit_info                   = vkb::initializers::submit_info();
 	submit_info.pWaitDstStageMask = &submit_pipeline_stages;
 
-	if (window->get_window_mode() != vkb::Window::Mode::Headless)
+	if (render_context->has_swapchain())
 	{
 		submit_info.waitSemaphoreCount   = 1;
 		submit_info.pWaitSemaphores      = &semaphores.acquired_image_ready;
@@ -78,6 +74,12 @@ bool ApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 
 void ApiVulkanSample::prepare_gui()
 {
+	// nothing displays the UI of an offscreen sample
+	if (is_offscreen())
+	{
+		return;
+	}
+
 	gui = std::make_unique<vkb::Gui>(*this, *window, /*stats=*/nullptr, 15.0f, true);
 	gui->prepare(pipeline_cache, render_pass,
 	             {load_shader("uioverlay/uioverlay.vert", VK_SHADER_STAGE_VERTEX_BIT),
@@ -92,7 +94,10 @@ void ApiVulkanSample::update(float delta_time)
 		view_changed();
 	}
 
-	render(delta_time);
+	{
+		vkb::ScopedTrace trace{"render"};
+		render(delta_time);
+	}
 	camera.update(delta_time);
 	if (camera.moving())
 	{
@@ -430,11 +435,70 @@ void ApiVulkanSample::recreate_current_command_buffer()
 
 void ApiVulkanSample::create_pipeline_cache()
 {
+	const auto &properties = device->get_gpu().get_properties();
+	auto        filename   = vkb::get_pipeline_cache_filename(properties);
+
+	std::vector<uint8_t> data;
+	try
+	{
+		data = vkb::fs::read_cache(filename);
+	}
+	catch (const std::runtime_error &)
+	{
+		data.clear();
+	}
+
+	pipeline_cache_loaded = !data.empty() && vkb::is_valid_pipeline_cache(data, properties);
+	if (!data.empty() && !pipeline_cache_loaded)
+	{
+		LOGW("Ignoring pipeline cache {}, its header does not match the device", filename);
+	}
+
 	VkPipelineCacheCreateInfo pipeline_cache_create_info = {};
 	pipeline_cache_create_info.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	if (pipeline_cache_loaded)
+	{
+		pipeline_cache_create_info.initialDataSize = data.size();
+		pipeline_cache_create_info.pInitialData    = data.data();
+		LOGI("Loaded pipeline cache {} ({} bytes)", filename, data.size());
+	}
 	VK_CHECK(vkCreatePipelineCache(device->get_handle(), &pipeline_cache_create_info, nullptr, &pipeline_cache));
 }
 
+void ApiVulkanSample::save_pipeline_cache()
+{
+	size_t size = 0;
+	if (vkGetPipelineCacheData(device->get_handle(), pipeline_cache, &size, nullptr) != VK_SUCCESS || size == 0)
+	{
+		return;
+	}
+
+	std::vector<uint8_t> data(size);
+	if (vkGetPipelineCacheData(device->get_handle(), pipeline_cache, &size, data.data()) != VK_SUCCESS)
+	{
+		return;
+	}
+	data.resize(size);
+
+	auto filename = vkb::get_pipeline_cache_filename(device->get_gpu().get_properties());
+	try
+	{
+		if (vkb::fs::write_cache(data, filename))
+		{
+			return;
+		}
+	}
+	catch (const std::runtime_error &)
+	{
+	}
+	LOGW("Failed to save pipeline cache {}", filename);
+}
+
+void ApiVulkanSample::log_pipeline_creation_time(double time) const
+{
+	LOGI("Created pipelines in {:.2f} ms with a {} pipeline cache", time, pipeline_cache_loaded ? "warm" : "cold");
+}
+
 VkPipelineShaderStageCreateInfo ApiVulkanSample::load_shader(const std::string &file, VkShaderStageFlagBits stage, vkb::ShaderSourceLanguage src_language)
 {
 	VkPipelineShaderStageCreateInfo shader_stage = {};
@@ -447,6 +511,19 @@ VkPipelineShaderStageCreateInfo ApiVulkanSample::load_shader(const std::string &
 	return shader_stage;
 }
 
+VkPipelineShaderStageCreateInfo ApiVulkanSample::load_shader(const std::string &file, VkShaderStageFlagBits stage, const vkb::ShaderVariant &shader_variant,
+                                                             vkb::ShaderSourceLanguage src_language)
+{
+	VkPipelineShaderStageCreateInfo shader_stage = {};
+	shader_stage.sType                           = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+	shader_stage.stage                           = stage;
+	shader_stage.module                          = vkb::load_shader(file.c_str(), device->get_handle(), stage, shader_variant, src_language);
+	shader_stage.pName                           = "main";
+	assert(shader_stage.module != VK_NULL_HANDLE);
+	shader_modules.push_back(shader_stage.module);
+	return shader_stage;
+}
+
 void ApiVulkanSample::update_overlay(float delta_time, const std::function<void()> &additional_ui)
 {
 	if (gui)
@@ -458,6 +535,18 @@ void ApiVulkanSample::update_overlay(float delta_time, const std::function<void(
 
 		gui->update(delta_time);
 
+		// Samples with a fence per frame draw the GUI from buffers of every frame, which update_frame_overlay()
+		// updates once the fence of a frame has signaled, instead of waiting for all frames to update shared buffers
+		if (use_wait_fences)
+		{
+			if (gui->get_drawer().is_dirty())
+			{
+				rebuild_command_buffers();
+				gui->get_drawer().clear();
+			}
+			return;
+		}
+
 		if (gui->update_buffers() || gui->get_drawer().is_dirty())
 		{
 			rebuild_command_buffers();
@@ -479,13 +568,57 @@ void ApiVulkanSample::draw_ui(const VkCommandBuffer command_buffer)
 	}
 }
 
+void ApiVulkanSample::draw_ui(const VkCommandBuffer command_buffer, uint32_t frame)
+{
+	if (!use_wait_fences)
+	{
+		draw_ui(command_buffer);
+		return;
+	}
+
+	if (gui)
+	{
+		const VkViewport viewport = vkb::initializers::viewport(static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f);
+		const VkRect2D   scissor  = vkb::initializers::rect2D(width, height, 0, 0);
+		vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+		vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+		gui->draw(command_buffer, frame);
+	}
+}
+
+bool ApiVulkanSample::update_frame_overlay()
+{
+	if (frame_overlays.size() != draw_cmd_buffers.size())
+	{
+		frame_overlays.assign(draw_cmd_buffers.size(), true);
+	}
+
+	// a frame recorded while the GUI was visible is recorded once more after it was hidden
+	bool visible  = gui && vkb::Gui::visible;
+	bool outdated = visible || frame_overlays[current_buffer];
+
+	frame_overlays[current_buffer] = visible;
+	if (visible)
+	{
+		gui->update_frame_buffers(current_buffer);
+	}
+	return outdated;
+}
+
 void ApiVulkanSample::prepare_frame()
 {
+	vkb::ScopedTrace trace{"prepare_frame"};
+
 	if (render_context->has_swapchain())
 	{
 		handle_surface_changes();
 		// Acquire the next image from the swap chain
-		VkResult result = render_context->get_swapchain().acquire_next_image(current_buffer, semaphores.acquired_image_ready, VK_NULL_HANDLE);
+		// The frame is only known once its image is acquired, so the acquire signals the spare semaphore, which is then
+		// swapped with the acquire semaphore of that frame. The semaphore swapped out was last waited on by the previous
+		// submission of the frame, which has completed by the next acquire: the sample waits for the fence of the frame
+		// before submitting it, or for the queue to become idle in submit_frame().
+		VkResult result = render_context->get_swapchain().acquire_next_image(current_buffer, spare_acquire_semaphore, VK_NULL_HANDLE);
 		// Recreate the swapchain if it's no longer compatible with the surface (OUT_OF_DATE)
 		if (result == VK_ERROR_OUT_OF_DATE_KHR)
 		{
@@ -493,15 +626,23 @@ void ApiVulkanSample::prepare_frame()
 		}
 		// VK_SUBOPTIMAL_KHR means that acquire was successful and semaphore is signaled but image is suboptimal
 		// allow rendering frame to suboptimal swapchain as otherwise we would have to manually unsignal semaphore and acquire image again
-		else if (result != VK_SUBOPTIMAL_KHR)
+		else
 		{
-			VK_CHECK(result);
+			if (result != VK_SUBOPTIMAL_KHR)
+			{
+				VK_CHECK(result);
+			}
+			std::swap(spare_acquire_semaphore, frame_semaphores[current_buffer].acquired_image_ready);
 		}
+
+		semaphores = frame_semaphores[current_buffer];
 	}
 }
 
 void ApiVulkanSample::submit_frame()
 {
+	vkb::ScopedTrace trace{"submit_frame"};
+
 	if (render_context->has_swapchain())
 	{
 		const auto &queue = device->get_queue_by_present(0);
@@ -550,7 +691,11 @@ void ApiVulkanSample::submit_frame()
 	// DO NOT USE
 	// vkDeviceWaitIdle and vkQueueWaitIdle are extremely expensive functions, and are used here purely for demonstrating the vulkan API
 	// without having to concern ourselves with proper syncronization. These functions should NEVER be used inside the render loop like this (every frame).
-	VK_CHECK(device->get_queue_by_present(0).wait_idle());
+	if (!use_wait_fences)
+	{
+		// without a surface no queue supports present
+		VK_CHECK(render_context->has_swapchain() ? device->get_queue_by_present(0).wait_idle() : vkQueueWaitIdle(queue));
+	}
 }
 
 ApiVulkanSample::~ApiVulkanSample()
@@ -584,12 +729,20 @@ ApiVulkanSample::~ApiVulkanSample()
 		vkDestroyImage(device->get_handle(), depth_stencil.image, nullptr);
 		vkFreeMemory(device->get_handle(), depth_stencil.mem, nullptr);
 
-		vkDestroyPipelineCache(device->get_handle(), pipeline_cache, nullptr);
+		if (pipeline_cache != VK_NULL_HANDLE)
+		{
+			save_pipeline_cache();
+			vkDestroyPipelineCache(device->get_handle(), pipeline_cache, nullptr);
+		}
 
 		vkDestroyCommandPool(device->get_handle(), cmd_pool, nullptr);
 
-		vkDestroySemaphore(device->get_handle(), semaphores.acquired_image_ready, nullptr);
-		vkDestroySemaphore(device->get_handle(), semaphores.render_complete, nullptr);
+		for (auto &frame : frame_semaphores)
+		{
+			vkDestroySemaphore(device->get_handle(), frame.acquired_image_ready, nullptr);
+			vkDestroySemaphore(device->get_handle(), frame.render_complete, nullptr);
+		}
+		vkDestroySemaphore(device->get_handle(), spare_acquire_semaphore, nullptr);
 		for (auto &fence : wait_fences)
 		{
 			vkDestroyFence(device->get_handle(), fence, nullptr);
@@ -607,6 +760,8 @@ void ApiVulkanSample::build_command_buffers()
 
 void ApiVulkanSample::rebuild_command_buffers()
 {
+	vkb::ScopedTrace trace{"rebuild_command_buffers"};
+	wait_for_draw_cmd_buffers();
 	vkResetCommandPool(device->get_handle(), cmd_pool, 0);
 	build_command_buffers();
 }
@@ -620,6 +775,33 @@ void ApiVulkanSample::create_synchronization_primitives()
 	{
 		VK_CHECK(vkCreateFence(device->get_handle(), &fence_create_info, nullptr, &fence));
 	}
+
+	// Semaphores per frame in flight, so that none is signaled or waited on again while a previous frame still uses it
+	// acquired_image_ready ensures that the swapchain image has been released by the presentation engine, ready for rendering
+	// render_complete ensures that the image is not presented until all commands have been submitted and executed
+	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+	frame_semaphores.resize(draw_cmd_buffers.size());
+	for (auto &frame : frame_semaphores)
+	{
+		VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &frame.acquired_image_ready));
+		VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &frame.render_complete));
+	}
+	VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &spare_acquire_semaphore));
+
+	semaphores = frame_semaphores[0];
+}
+
+void ApiVulkanSample::wait_for_draw_cmd_buffers()
+{
+	if (!wait_fences.empty())
+	{
+		VK_CHECK(vkWaitForFences(device->get_handle(), vkb::to_u32(wait_fences.size()), wait_fences.data(), VK_TRUE, UINT64_MAX));
+	}
+}
+
+bool ApiVulkanSample::is_offscreen() const
+{
+	return window->get_window_mode() == vkb::Window::Mode::Offscreen;
 }
 
 void ApiVulkanSample::create_command_pool()
@@ -166,21 +166,42 @@ class ApiVulkanSample : public vkb::VulkanSample
 	std::vector<VkShaderModule> shader_modules;
 
 	// Pipeline cache object
-	VkPipelineCache pipeline_cache;
+	VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+
+	// True if the pipeline cache was created from the data saved by a previous run
+	bool pipeline_cache_loaded = false;
 
 	// Synchronization semaphores
-	struct
+	struct FrameSemaphores
 	{
 		// Swap chain image presentation
 		VkSemaphore acquired_image_ready;
 
 		// Command buffer submission and execution
 		VkSemaphore render_complete;
-	} semaphores;
+	};
+
+	// Semaphores of the current frame, set by prepare_frame() from frame_semaphores
+	FrameSemaphores semaphores{};
+
+	// Semaphores of every frame in flight, indexed like draw_cmd_buffers and wait_fences
+	std::vector<FrameSemaphores> frame_semaphores;
+
+	// Signaled by the next acquire, then swapped with the acquire semaphore of the acquired frame
+	VkSemaphore spare_acquire_semaphore{VK_NULL_HANDLE};
+
+	// Per frame in flight, whether its command buffer was last recorded with the gui visible
+	std::vector<bool> frame_overlays;
 
 	// Synchronization fences
 	std::vector<VkFence> wait_fences;
 
+	// If set, submit_frame() does not wait for the queue to become idle. The sample then has to signal
+	// wait_fences[current_buffer] on submission and wait for it after prepare_frame() and before submitting
+	// the frame, which also makes the semaphores of the frame available again.
+	// The GUI is then drawn from buffers of each frame, see update_frame_overlay().
+	bool use_wait_fences = false;
+
 	/**
 	 * @brief Populates the swapchain_buffers vector with the image and imageviews
 	 */
@@ -288,10 +309,20 @@ class ApiVulkanSample : public vkb::VulkanSample
 	void rebuild_command_buffers();
 
 	/**
-	 * @brief Creates the fences for rendering
+	 * @brief Creates the fences and semaphores of every frame in flight
 	 */
 	void create_synchronization_primitives();
 
+	/**
+	 * @brief Waits until none of the draw command buffers is in flight anymore
+	 */
+	void wait_for_draw_cmd_buffers();
+
+	/**
+	 * @brief Whether the sample runs without a surface or UI, rendering to offscreen images only
+	 */
+	bool is_offscreen() const;
+
 	/**
 	 * @brief Creates a new (graphics) command pool object storing command buffers
 	 */
@@ -342,9 +373,22 @@ class ApiVulkanSample : public vkb::VulkanSample
 
 	/**
 	 * @brief Create a cache pool for rendering pipelines
+	 *        The cache is initialized with the data saved by the last run on the same device and
+	 *        driver, if its header matches the device, and saved again when the sample is destroyed
 	 */
 	void create_pipeline_cache();
 
+	/**
+	 * @brief Save the data of the pipeline cache to the cache directory
+	 */
+	void save_pipeline_cache();
+
+	/**
+	 * @brief Log how long the pipelines of the sample took to create, and if the pipeline cache was warm
+	 * @param time Creation time in milliseconds
+	 */
+	void log_pipeline_creation_time(double time) const;
+
 	/**
 	 * @brief Load a SPIR-V shader
 	 * @param file The file location of the shader relative to the shaders folder
@@ -353,6 +397,16 @@ class ApiVulkanSample : public vkb::VulkanSample
 	 */
 	VkPipelineShaderStageCreateInfo load_shader(const std::string &file, VkShaderStageFlagBits stage, vkb::ShaderSourceLanguage src_language = vkb::ShaderSourceLanguage::GLSL);
 
+	/**
+	 * @brief Load a variant of a SPIR-V shader
+	 * @param file The file location of the shader relative to the shaders folder
+	 * @param stage The shader stage
+	 * @param shader_variant The definitions the shader is compiled with
+	 * @param src_language The shader language
+	 */
+	VkPipelineShaderStageCreateInfo load_shader(const std::string &file, VkShaderStageFlagBits stage, const vkb::ShaderVariant &shader_variant,
+	                                            vkb::ShaderSourceLanguage src_language = vkb::ShaderSourceLanguage::GLSL);
+
 	/**
 	 * @brief Updates the overlay
 	 * @param delta_time The time taken since the last frame
@@ -365,6 +419,22 @@ class ApiVulkanSample : public vkb::VulkanSample
 	 */
 	void draw_ui(const VkCommandBuffer command_buffer);
 
+	/**
+	 * @brief If the gui is enabled, then record the drawing commands of a frame in flight to its command buffer
+	 *        For samples with use_wait_fences, the gui is drawn from the buffers updated by update_frame_overlay()
+	 * @param command_buffer A valid command buffer that is ready to be recorded to
+	 * @param frame Index of the frame the command buffer belongs to
+	 */
+	void draw_ui(const VkCommandBuffer command_buffer, uint32_t frame);
+
+	/**
+	 * @brief Uploads the gui to the buffers of the current frame, for samples with use_wait_fences
+	 *        Must be called once the fence of current_buffer has signaled, no other frame is waited for
+	 * @returns True if the command buffer of the current frame must be recorded again, since its draw commands
+	 *          depend on the uploaded draw data or it was recorded while the gui was still visible
+	 */
+	bool update_frame_overlay();
+
 	/**
 	 * @brief Prepare the frame for workload submission, acquires the next image from the swap chain and
 	 *        sets the default wait and signal semaphores
@@ -0,0 +1,46 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "benchmark_target.h"
+
+#include "platform/configuration.h"
+
+namespace vkb
+{
+void BenchmarkTarget::insert_configurations(Configuration &configuration)
+{
+	auto variant_count = get_benchmark_variants().size();
+	for (size_t i = 0; i < variant_count; ++i)
+	{
+		configuration.insert<IntSetting>(static_cast<uint32_t>(i), configured_variant, static_cast<int>(i));
+	}
+
+	// the sample starts in the first variant
+	configured_variant = 0;
+	applied_variant    = 0;
+	configuration.reset();
+}
+
+void BenchmarkTarget::update_configuration()
+{
+	if (configured_variant != applied_variant)
+	{
+		applied_variant = configured_variant;
+		set_benchmark_variant(static_cast<size_t>(applied_variant));
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,188 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkb
+{
+class Configuration;
+
+/**
+ * @brief Interface for samples which can be driven by the benchmark runner
+ *
+ * A benchmark target exposes a flat list of variants (a shader type and a window size),
+ * can be switched to any of them without user input and reports the GPU time of every
+ * pass of the last completed frame. Once a variant has been measured the target may report
+ * further results of it, such as its error against a reference variant.
+ *
+ * Targets whose filters process images independent of the swapchain may also be switched to
+ * a processing resolution other than the window size, the result being scaled for display.
+ * Their output can be written to a file, which is the only way to see it when running offscreen.
+ * Targets may also filter a batch of images per frame, in which case the pass times cover the whole batch.
+ *
+ * Every variant can also be registered as a configuration of the sample (see insert_configurations()),
+ * so that batch mode cycles through them like through the configurations of any other sample.
+ */
+class BenchmarkTarget
+{
+  public:
+	struct Variant
+	{
+		std::string type;
+
+		std::string window;
+	};
+
+	struct PassTime
+	{
+		std::string name;
+
+		/// GPU time of the pass in milliseconds
+		double time;
+	};
+
+	struct Metric
+	{
+		std::string name;
+
+		double value;
+	};
+
+	struct Extent
+	{
+		uint32_t width;
+
+		uint32_t height;
+	};
+
+	virtual ~BenchmarkTarget() = default;
+
+	/**
+	 * @brief Lists every variant the target can be switched to
+	 */
+	virtual std::vector<Variant> get_benchmark_variants() const = 0;
+
+	/**
+	 * @brief Switches the target to a variant, rebuilding command buffers if needed
+	 * @param index Index into the list returned by get_benchmark_variants()
+	 */
+	virtual void set_benchmark_variant(size_t index) = 0;
+
+	/**
+	 * @brief Returns false for the variants the target can not run in its current state, such as with the current batch size
+	 * @param index Index into the list returned by get_benchmark_variants()
+	 */
+	virtual bool is_benchmark_variant_supported(size_t index) const
+	{
+		return true;
+	}
+
+	/**
+	 * @brief Returns the GPU time of each pass of the frame read back since the previous call
+	 * @returns An empty list if no new timestamps have been read, so that no frame is reported twice
+	 */
+	virtual std::vector<PassTime> get_benchmark_pass_times() = 0;
+
+	/**
+	 * @brief Called once the current variant has been measured, before switching to the next one
+	 * @returns Further results of the variant, none by default
+	 */
+	virtual std::vector<Metric> finish_benchmark_variant()
+	{
+		return {};
+	}
+
+	/**
+	 * @brief Returns remarks on what the results of the target do not cover, such as variants it does not implement
+	 *        Logged once the target is swept and written to the JSON output next to its results, none by default
+	 */
+	virtual std::vector<std::string> get_benchmark_notes() const
+	{
+		return {};
+	}
+
+	/**
+	 * @brief Sets the resolution the filters process at, independent of the window size
+	 * @param extent Processing resolution, a zero extent follows the window size again
+	 * @returns False if the target does not support a separate processing resolution
+	 */
+	virtual bool set_processing_extent(const Extent &extent)
+	{
+		return false;
+	}
+
+	/**
+	 * @brief Returns the resolution the filters currently process at, zero if unknown
+	 */
+	virtual Extent get_processing_extent() const
+	{
+		return {0, 0};
+	}
+
+	/**
+	 * @brief Sets the number of images the filters process per frame
+	 * @param size Number of images of the batch, 1 processes a single image
+	 * @returns False if the target does not support batches of this size
+	 */
+	virtual bool set_batch_size(uint32_t size)
+	{
+		return false;
+	}
+
+	/**
+	 * @brief Returns the number of images the filters process per frame
+	 */
+	virtual uint32_t get_batch_size() const
+	{
+		return 1;
+	}
+
+	/**
+	 * @brief Writes the output image of the filter of the last completed frame to a PNG file
+	 * @param filename Name of the file in the screenshots folder, without extension
+	 * @returns False if the target has no output image to write
+	 */
+	virtual bool save_output(const std::string &filename)
+	{
+		return false;
+	}
+
+  protected:
+	/**
+	 * @brief Registers a configuration per variant, the configuration index being the variant index
+	 *        Called once the variants are known, the configuration is reset to the first variant
+	 * @param configuration The configuration of the sample
+	 */
+	void insert_configurations(Configuration &configuration);
+
+	/**
+	 * @brief Switches to the variant of the current configuration if it was changed since the last call
+	 *        Called every frame before the command buffers are submitted
+	 */
+	void update_configuration();
+
+  private:
+	// variant written by the settings of the configurations, and the last one switched to
+	int configured_variant{0};
+
+	int applied_variant{0};
+};
+}        // namespace vkb
@@ -17,9 +17,12 @@
 
 #include "utils.h"
 
+#include <cstring>
 #include <queue>
 #include <stdexcept>
 
+#include "common/vk_initializers.h"
+
 #include "scene_graph/components/material.h"
 #include "scene_graph/components/perspective_camera.h"
 #include "scene_graph/components/sub_mesh.h"
@@ -182,6 +185,49 @@ void screenshot(RenderContext &render_context, const std::string &filename)
 	dst_buffer.unmap();
 }        // namespace vkb
 
+std::vector<uint8_t> read_image(Device &device, const core::Image &image, VkImageLayout layout, uint32_t layer)
+{
+	const VkExtent3D &extent = image.get_extent();
+	VkDeviceSize      size   = static_cast<VkDeviceSize>(extent.width) * extent.height * 4;
+
+	core::Buffer staging_buffer{device, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU};
+
+	VkCommandBuffer cmd = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+
+	VkImageMemoryBarrier barrier = initializers::image_memory_barrier();
+	barrier.srcQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
+	barrier.srcAccessMask        = VK_ACCESS_NONE;
+	barrier.dstAccessMask        = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.oldLayout            = layout;
+	barrier.newLayout            = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.image                = image.get_handle();
+	barrier.subresourceRange     = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, layer, 1};
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	VkBufferImageCopy region = {};
+	region.imageSubresource  = {VK_IMAGE_ASPECT_COLOR_BIT, 0, layer, 1};
+	region.imageExtent       = {extent.width, extent.height, 1};
+	vkCmdCopyImageToBuffer(cmd, image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, staging_buffer.get_handle(), 1, &region);
+
+	barrier.srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barrier.dstAccessMask = VK_ACCESS_NONE;
+	barrier.oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barrier.newLayout     = layout;
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	device.flush_command_buffer(cmd, device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT, 0).get_handle());
+
+	VK_CHECK(vmaInvalidateAllocation(device.get_memory_allocator(), staging_buffer.get_allocation(), 0, VK_WHOLE_SIZE));
+
+	std::vector<uint8_t> texels(size);
+	std::memcpy(texels.data(), staging_buffer.map(), size);
+	staging_buffer.unmap();
+	return texels;
+}
+
 std::string to_snake_case(const std::string &text)
 {
 	std::stringstream result;
@@ -54,6 +54,16 @@ class CommandBuffer;
  */
 void screenshot(RenderContext &render_context, const std::string &filename);
 
+/**
+ * @brief Reads back an 8-bit RGBA color image, such as the output of an offscreen pass (slow function)
+ * @param device The device the image was created on
+ * @param image The image to read, created with VK_IMAGE_USAGE_TRANSFER_SRC_BIT and no longer in use by the GPU
+ * @param layout The layout the image is in, it is transitioned back to it after the copy
+ * @param layer The array layer to read
+ * @return The tightly packed texels of the first mip level of the layer
+ */
+std::vector<uint8_t> read_image(Device &device, const core::Image &image, VkImageLayout layout, uint32_t layer = 0);
+
 /**
  * @brief Adds a light to the scene with the specified parameters
  * @param scene The scene to add the light to
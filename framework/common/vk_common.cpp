@@ -375,32 +375,46 @@ int32_t get_bits_per_pixel(VkFormat format)
 }
 
 VkShaderModule load_shader(const std::string &filename, VkDevice device, VkShaderStageFlagBits stage, vkb::ShaderSourceLanguage src_language)
+{
+	return load_shader(filename, device, stage, ShaderVariant{}, src_language);
+}
+
+bool compile_glsl_shader(const std::string &filename, const ShaderVariant &shader_variant, std::vector<uint32_t> &spirv)
 {
 	vkb::GLSLCompiler glsl_compiler;
 
-	auto                  buffer = vkb::fs::read_shader_binary(filename);
-	std::vector<uint32_t> spirv;
+	auto buffer = vkb::fs::read_shader_binary(filename);
 
-	if (vkb::ShaderSourceLanguage::GLSL == src_language)
-	{
-		std::string file_ext = filename;
+	// Extract extension name from the glsl shader file
+	std::string file_ext = filename.substr(filename.find_last_of(".") + 1);
+
+	std::string info_log;
 
-		// Extract extension name from the glsl shader file
-		file_ext = file_ext.substr(file_ext.find_last_of(".") + 1);
+	// Compile the GLSL source
+	if (!glsl_compiler.compile_to_spirv(vkb::find_shader_stage(file_ext), buffer, "main", shader_variant, spirv, info_log))
+	{
+		LOGE("Failed to compile shader {}, Error: {}", filename, info_log.c_str());
+		return false;
+	}
+	return true;
+}
 
-		std::string info_log;
+VkShaderModule load_shader(const std::string &filename, VkDevice device, VkShaderStageFlagBits stage, const ShaderVariant &shader_variant, vkb::ShaderSourceLanguage src_language)
+{
+	std::vector<uint32_t> spirv;
 
-		// Compile the GLSL source
-		if (!glsl_compiler.compile_to_spirv(vkb::find_shader_stage(file_ext), buffer, "main", {}, spirv, info_log))
+	if (vkb::ShaderSourceLanguage::GLSL == src_language)
+	{
+		if (!compile_glsl_shader(filename, shader_variant, spirv))
 		{
-			LOGE("Failed to compile shader, Error: {}", info_log.c_str());
 			return VK_NULL_HANDLE;
 		}
 	}
 	else if (vkb::ShaderSourceLanguage::SPV == src_language)
 	{
-		spirv = std::vector<uint32_t>(reinterpret_cast<uint32_t *>(buffer.data()),
-		                              reinterpret_cast<uint32_t *>(buffer.data()) + buffer.size() / sizeof(uint32_t));
+		auto buffer = vkb::fs::read_shader_binary(filename);
+		spirv       = std::vector<uint32_t>(reinterpret_cast<uint32_t *>(buffer.data()),
+		                                    reinterpret_cast<uint32_t *>(buffer.data()) + buffer.size() / sizeof(uint32_t));
 	}
 	else
 	{
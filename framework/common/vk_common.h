@@ -41,6 +41,8 @@ using BindingMap = std::map<uint32_t, std::map<uint32_t, T>>;
 
 namespace vkb
 {
+class ShaderVariant;
+
 /**
  * @brief Helper function to determine if a Vulkan format is depth only.
  * @param format Vulkan format to check.
@@ -123,6 +125,26 @@ enum class ShaderSourceLanguage
  */
 VkShaderModule load_shader(const std::string &filename, VkDevice device, VkShaderStageFlagBits stage, ShaderSourceLanguage src_language = ShaderSourceLanguage::GLSL);
 
+/**
+ * @brief Helper function to create a VkShaderModule from a variant of a shader
+ * @param filename The shader location
+ * @param device The logical device
+ * @param stage The shader stage
+ * @param shader_variant The definitions the GLSL source is compiled with
+ * @param src_language The shader language
+ * @return The string to return.
+ */
+VkShaderModule load_shader(const std::string &filename, VkDevice device, VkShaderStageFlagBits stage, const ShaderVariant &shader_variant, ShaderSourceLanguage src_language = ShaderSourceLanguage::GLSL);
+
+/**
+ * @brief Helper function to compile a GLSL shader to SPIR-V, the stage is deduced from the file extension
+ * @param filename The shader location
+ * @param shader_variant The definitions the GLSL source is compiled with
+ * @param[out] spirv The generated SPIR-V
+ * @return False if the shader failed to compile, the error is logged
+ */
+bool compile_glsl_shader(const std::string &filename, const ShaderVariant &shader_variant, std::vector<uint32_t> &spirv);
+
 /**
  * @brief Helper function to select a VkSurfaceFormatKHR
  * @param gpu The VkPhysicalDevice to select a format for.
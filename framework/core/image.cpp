@@ -131,7 +131,8 @@ Image::Image(Device const         &device,
 	}
 }
 
-Image::Image(Device const &device, VkImage handle, const VkExtent3D &extent, VkFormat format, VkImageUsageFlags image_usage, VkSampleCountFlagBits sample_count) :
+Image::Image(Device const &device, VkImage handle, const VkExtent3D &extent, VkFormat format, VkImageUsageFlags image_usage, VkSampleCountFlagBits sample_count,
+             uint32_t array_layers) :
     VulkanResource{handle, &device},
     type{find_image_type(extent)},
     extent{extent},
@@ -140,7 +141,7 @@ Image::Image(Device const &device, VkImage handle, const VkExtent3D &extent, VkF
     usage{image_usage}
 {
 	subresource.mipLevel   = 1;
-	subresource.arrayLayer = 1;
+	subresource.arrayLayer = array_layers;
 }
 
 Image::Image(Image &&other) :
@@ -38,7 +38,8 @@ class Image : public VulkanResource<VkImage, VK_OBJECT_TYPE_IMAGE, const Device>
 	      const VkExtent3D &    extent,
 	      VkFormat              format,
 	      VkImageUsageFlags     image_usage,
-	      VkSampleCountFlagBits sample_count = VK_SAMPLE_COUNT_1_BIT);
+	      VkSampleCountFlagBits sample_count = VK_SAMPLE_COUNT_1_BIT,
+	      uint32_t              array_layers = 1);
 
 	Image(Device const &        device,
 	      const VkExtent3D &    extent,
@@ -81,6 +81,27 @@ const VkPhysicalDeviceMemoryProperties &PhysicalDevice::get_memory_properties()
 	return memory_properties;
 }
 
+std::string PhysicalDevice::get_uuid() const
+{
+	const uint8_t *uuid = properties.pipelineCacheUUID;
+
+	VkPhysicalDeviceIDPropertiesKHR id_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES_KHR};
+	if (instance.is_enabled(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+	{
+		VkPhysicalDeviceProperties2KHR properties_2{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+		properties_2.pNext = &id_properties;
+		vkGetPhysicalDeviceProperties2KHR(handle, &properties_2);
+		uuid = id_properties.deviceUUID;
+	}
+
+	std::string result;
+	for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+	{
+		result += fmt::format("{:02x}", uuid[i]);
+	}
+	return result;
+}
+
 const std::vector<VkQueueFamilyProperties> &PhysicalDevice::get_queue_family_properties() const
 {
 	return queue_family_properties;
@@ -55,6 +55,12 @@ class PhysicalDevice
 
 	const VkPhysicalDeviceMemoryProperties &get_memory_properties() const;
 
+	/**
+	 * @brief Returns the deviceUUID of the device as a hex string, or its pipelineCacheUUID
+	 *        if VK_KHR_get_physical_device_properties2 is not enabled
+	 */
+	std::string get_uuid() const;
+
 	const std::vector<VkQueueFamilyProperties> &get_queue_family_properties() const;
 
 	uint32_t get_queue_family_performance_query_passes(
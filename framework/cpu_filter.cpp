@@ -0,0 +1,404 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_filter.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+#include <ctpl_stl.h>
+
+#if defined(_MSC_VER) && (defined(VKB_CPU_FILTER_SSE4) || defined(VKB_CPU_FILTER_AVX2))
+#	include <immintrin.h>
+#	include <intrin.h>
+#endif
+
+#include "cpu_filter_kernels.h"
+
+namespace vkb
+{
+namespace cpu_filter
+{
+Kernels get_scalar_kernels()
+{
+	return make_kernels<ScalarFloat>();
+}
+}        // namespace cpu_filter
+
+namespace
+{
+// rows of one task on the thread pool, enough to amortize the task overhead for small windows
+constexpr uint32_t band_height = 16;
+
+bool cpu_supports(CpuFilter::InstructionSet instruction_set)
+{
+	if (instruction_set == CpuFilter::InstructionSet::Scalar)
+	{
+		return true;
+	}
+
+#if defined(VKB_CPU_FILTER_SSE4) || defined(VKB_CPU_FILTER_AVX2)
+#	if defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 0);
+	int max_leaf = info[0];
+
+	__cpuid(info, 1);
+	bool sse4 = (info[2] & (1 << 19)) != 0;
+
+	// AVX registers also have to be saved by the OS
+	bool avx = (info[2] & (1 << 28)) != 0 && (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+
+	bool avx2 = false;
+	if (max_leaf >= 7)
+	{
+		__cpuidex(info, 7, 0);
+		avx2 = avx && (info[1] & (1 << 5)) != 0;
+	}
+#	else
+	__builtin_cpu_init();
+	bool sse4 = __builtin_cpu_supports("sse4.1");
+	bool avx2 = __builtin_cpu_supports("avx2");
+#	endif
+
+	switch (instruction_set)
+	{
+		case CpuFilter::InstructionSet::SSE4:
+#	ifdef VKB_CPU_FILTER_SSE4
+			return sse4;
+#	else
+			return false;
+#	endif
+		case CpuFilter::InstructionSet::AVX2:
+#	ifdef VKB_CPU_FILTER_AVX2
+			return avx2;
+#	else
+			return false;
+#	endif
+		default:
+			return false;
+	}
+#else
+	return false;
+#endif
+}
+
+cpu_filter::Kernels get_kernels(CpuFilter::InstructionSet instruction_set)
+{
+	switch (instruction_set)
+	{
+#ifdef VKB_CPU_FILTER_SSE4
+		case CpuFilter::InstructionSet::SSE4:
+			return cpu_filter::get_sse4_kernels();
+#endif
+#ifdef VKB_CPU_FILTER_AVX2
+		case CpuFilter::InstructionSet::AVX2:
+			return cpu_filter::get_avx2_kernels();
+#endif
+		default:
+			return cpu_filter::get_scalar_kernels();
+	}
+}
+
+void allocate(std::vector<float> &storage, cpu_filter::PlanarImage &image, uint32_t width, uint32_t height, uint32_t pad)
+{
+	uint32_t stride = width + 2 * pad;
+	size_t   size   = static_cast<size_t>(stride) * height;
+
+	storage.resize(4 * size);
+	for (uint32_t c = 0; c < 4; ++c)
+	{
+		image.planes[c] = storage.data() + c * size;
+	}
+	image.width  = width;
+	image.height = height;
+	image.pad    = pad;
+	image.stride = stride;
+}
+
+float *plane_row(const cpu_filter::PlanarImage &image, uint32_t channel, uint32_t y)
+{
+	return image.planes[channel] + static_cast<size_t>(y) * image.stride + image.pad;
+}
+
+void check_source(const CpuFilter::Image &src)
+{
+	if (src.width == 0 || src.height == 0 || src.pixels.size() < static_cast<size_t>(src.width) * src.height * 4)
+	{
+		throw std::invalid_argument("The source image of a CPU filter has to hold width * height RGBA8 texels");
+	}
+}
+}        // namespace
+
+struct CpuFilter::Planes
+{
+	std::vector<float> source_storage;
+	std::vector<float> intermediate_storage;
+	std::vector<float> output_storage;
+
+	cpu_filter::PlanarImage source{};
+	cpu_filter::PlanarImage intermediate{};
+	cpu_filter::PlanarImage output{};
+};
+
+std::vector<CpuFilter::InstructionSet> CpuFilter::get_supported_instruction_sets()
+{
+	std::vector<InstructionSet> instruction_sets;
+	for (auto instruction_set : {InstructionSet::Scalar, InstructionSet::SSE4, InstructionSet::AVX2})
+	{
+		if (cpu_supports(instruction_set))
+		{
+			instruction_sets.push_back(instruction_set);
+		}
+	}
+	return instruction_sets;
+}
+
+const char *CpuFilter::to_string(InstructionSet instruction_set)
+{
+	switch (instruction_set)
+	{
+		case InstructionSet::SSE4:
+			return "SSE4";
+		case InstructionSet::AVX2:
+			return "AVX2";
+		default:
+			return "SCALAR";
+	}
+}
+
+CpuFilter::CpuFilter(uint32_t thread_count) :
+    planes{std::make_unique<Planes>()}
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	thread_pool = std::make_unique<ctpl::thread_pool>(static_cast<int>(thread_count));
+
+	instruction_set = get_supported_instruction_sets().back();
+}
+
+CpuFilter::~CpuFilter() = default;
+
+void CpuFilter::set_instruction_set(InstructionSet new_instruction_set)
+{
+	if (!cpu_supports(new_instruction_set))
+	{
+		throw std::runtime_error(std::string{"The CPU filters do not support "} + to_string(new_instruction_set) + " on this machine");
+	}
+	instruction_set = new_instruction_set;
+}
+
+CpuFilter::InstructionSet CpuFilter::get_instruction_set() const
+{
+	return instruction_set;
+}
+
+uint32_t CpuFilter::get_thread_count() const
+{
+	return static_cast<uint32_t>(thread_pool->size());
+}
+
+void CpuFilter::gaussian(const Image &src, Image &dst, uint32_t radius, float gaussian_divisor)
+{
+	std::vector<float> weights(2 * radius + 1);
+
+	float sum = 0.0f;
+	for (uint32_t i = 0; i < weights.size(); ++i)
+	{
+		float d    = static_cast<float>(i) - static_cast<float>(radius);
+		weights[i] = std::exp(d * d * gaussian_divisor);
+		sum += weights[i];
+	}
+	for (float &weight : weights)
+	{
+		weight /= sum;
+	}
+
+	separable(src, dst, weights);
+}
+
+void CpuFilter::bilateral(const Image &src, Image &dst, uint32_t radius, float gaussian_divisor, float intensities_divisor)
+{
+	int32_t            r = static_cast<int32_t>(radius);
+	std::vector<float> spatial_terms;
+	spatial_terms.reserve((2 * radius + 1) * (2 * radius + 1));
+	for (int32_t y = -r; y <= r; ++y)
+	{
+		for (int32_t x = -r; x <= r; ++x)
+		{
+			spatial_terms.push_back(static_cast<float>(x * x + y * y) * gaussian_divisor);
+		}
+	}
+
+	convert_source(src, radius);
+	allocate(planes->output_storage, planes->output, src.width, src.height, 0);
+
+	auto kernels = get_kernels(instruction_set);
+	for_each_band(src.height, [&](uint32_t y_begin, uint32_t y_end) {
+		kernels.bilateral(planes->source, planes->output, spatial_terms.data(), intensities_divisor, radius, y_begin, y_end);
+	});
+
+	convert_output(dst);
+}
+
+void CpuFilter::tent(const Image &src, Image &dst, uint32_t radius, float k, float b)
+{
+	if (radius > 0)
+	{
+		b = std::min(b, (k - 0.5f) / (2.0f * radius));
+	}
+
+	int32_t            r   = static_cast<int32_t>(radius);
+	float              sum = 0.0f;
+	std::vector<float> weights;
+	weights.reserve((2 * radius + 1) * (2 * radius + 1));
+	for (int32_t y = -r; y <= r; ++y)
+	{
+		for (int32_t x = -r; x <= r; ++x)
+		{
+			weights.push_back(k - b * static_cast<float>(std::abs(x) + std::abs(y)));
+			sum += weights.back();
+		}
+	}
+	for (float &weight : weights)
+	{
+		weight /= sum;
+	}
+
+	convert_source(src, radius);
+	allocate(planes->output_storage, planes->output, src.width, src.height, 0);
+
+	auto kernels = get_kernels(instruction_set);
+	for_each_band(src.height, [&](uint32_t y_begin, uint32_t y_end) {
+		kernels.convolve_2d(planes->source, planes->output, weights.data(), radius, y_begin, y_end);
+	});
+
+	convert_output(dst);
+}
+
+bool CpuFilter::taa_statistics(const Image &src, Image &dst, uint32_t radius, float gamma, float t)
+{
+	return false;
+}
+
+void CpuFilter::separable(const Image &src, Image &dst, const std::vector<float> &weights)
+{
+	uint32_t radius = static_cast<uint32_t>(weights.size() / 2);
+
+	convert_source(src, radius);
+	allocate(planes->intermediate_storage, planes->intermediate, src.width, src.height, 0);
+	allocate(planes->output_storage, planes->output, src.width, src.height, 0);
+
+	// the vertical pass of a band reads rows of the neighbouring bands, so both passes are waited for
+	auto kernels = get_kernels(instruction_set);
+	for_each_band(src.height, [&](uint32_t y_begin, uint32_t y_end) {
+		kernels.convolve_rows(planes->source, planes->intermediate, weights.data(), radius, y_begin, y_end);
+	});
+	for_each_band(src.height, [&](uint32_t y_begin, uint32_t y_end) {
+		kernels.convolve_columns(planes->intermediate, planes->output, weights.data(), radius, y_begin, y_end);
+	});
+
+	convert_output(dst);
+}
+
+void CpuFilter::convert_source(const Image &src, uint32_t pad)
+{
+	check_source(src);
+
+	static const auto unorm = [] {
+		std::array<float, 256> values{};
+		for (uint32_t i = 0; i < values.size(); ++i)
+		{
+			values[i] = static_cast<float>(i) / 255.0f;
+		}
+		return values;
+	}();
+
+	auto &source = planes->source;
+	allocate(planes->source_storage, source, src.width, src.height, pad);
+
+	for_each_band(src.height, [&](uint32_t y_begin, uint32_t y_end) {
+		for (uint32_t y = y_begin; y < y_end; ++y)
+		{
+			const uint8_t *in = src.pixels.data() + static_cast<size_t>(y) * src.width * 4;
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				float *out = plane_row(source, c, y);
+				for (uint32_t x = 0; x < src.width; ++x)
+				{
+					out[x] = unorm[in[x * 4 + c]];
+				}
+
+				// clamp to edge
+				std::fill(out - pad, out, out[0]);
+				std::fill(out + src.width, out + src.width + pad, out[src.width - 1]);
+			}
+		}
+	});
+}
+
+void CpuFilter::convert_output(Image &dst)
+{
+	const auto &output = planes->output;
+
+	dst.width  = output.width;
+	dst.height = output.height;
+	dst.pixels.resize(static_cast<size_t>(output.width) * output.height * 4);
+
+	for_each_band(output.height, [&](uint32_t y_begin, uint32_t y_end) {
+		for (uint32_t y = y_begin; y < y_end; ++y)
+		{
+			uint8_t *out = dst.pixels.data() + static_cast<size_t>(y) * output.width * 4;
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				const float *in = plane_row(output, c, y);
+				for (uint32_t x = 0; x < output.width; ++x)
+				{
+					out[x * 4 + c] = static_cast<uint8_t>(std::min(std::max(in[x], 0.0f), 1.0f) * 255.0f + 0.5f);
+				}
+			}
+		}
+	});
+}
+
+void CpuFilter::for_each_band(uint32_t height, const std::function<void(uint32_t, uint32_t)> &func)
+{
+	std::vector<std::future<void>> futures;
+	futures.reserve((height + band_height - 1) / band_height);
+	for (uint32_t y = 0; y < height; y += band_height)
+	{
+		uint32_t y_end = std::min(y + band_height, height);
+		futures.push_back(thread_pool->push([&func, y, y_end](size_t) { func(y, y_end); }));
+	}
+
+	// every task references func, so all of them have to finish before get() rethrows an exception
+	for (auto &future : futures)
+	{
+		future.wait();
+	}
+	for (auto &future : futures)
+	{
+		future.get();
+	}
+}
+}        // namespace vkb
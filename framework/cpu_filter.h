@@ -0,0 +1,146 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace ctpl
+{
+class thread_pool;
+}        // namespace ctpl
+
+namespace vkb
+{
+/**
+ * @brief CPU reference implementations of the gaussian, bilateral and tent filters
+ *
+ * The TAA statistics filter has no reference yet, see taa_statistics().
+ *
+ * The filters take the parameters the filter samples pass in their push constants and compute
+ * the same weights, with the borders clamped to the edge like the samplers of the GPU passes.
+ * Their output can be compared against the GPU variants, and they give a CPU baseline to
+ * benchmark them against.
+ *
+ * The image is converted to one float plane per channel and filtered in bands of rows on a
+ * thread pool, by kernels built for AVX2, SSE4.1 or plain scalar code and selected at runtime.
+ * All instruction sets evaluate the same operations in the same order, so their results are
+ * bit-exact with each other.
+ */
+class CpuFilter
+{
+  public:
+	enum class InstructionSet
+	{
+		Scalar,
+		SSE4,
+		AVX2,
+	};
+
+	/**
+	 * @brief RGBA8 unorm image with tightly packed rows
+	 */
+	struct Image
+	{
+		uint32_t width{0};
+
+		uint32_t height{0};
+
+		std::vector<uint8_t> pixels;
+	};
+
+	/**
+	 * @brief Instruction sets the library was built with and the CPU supports, the widest last
+	 */
+	static std::vector<InstructionSet> get_supported_instruction_sets();
+
+	static const char *to_string(InstructionSet instruction_set);
+
+	/**
+	 * @param thread_count Number of worker threads, 0 for one per hardware thread
+	 */
+	explicit CpuFilter(uint32_t thread_count = 0);
+
+	~CpuFilter();
+
+	CpuFilter(const CpuFilter &) = delete;
+
+	CpuFilter &operator=(const CpuFilter &) = delete;
+
+	/**
+	 * @brief Selects the kernels of the filters, the widest supported instruction set by default
+	 * @throws std::runtime_error if the instruction set is not supported
+	 */
+	void set_instruction_set(InstructionSet instruction_set);
+
+	InstructionSet get_instruction_set() const;
+
+	uint32_t get_thread_count() const;
+
+	/**
+	 * @brief Separable gaussian, weights exp(d^2 * gaussian_divisor) normalized to sum 1
+	 * @param gaussian_divisor -0.5 / sigma^2
+	 */
+	void gaussian(const Image &src, Image &dst, uint32_t radius, float gaussian_divisor);
+
+	/**
+	 * @brief Bilateral filter, weights exp((x^2 + y^2) * gaussian_divisor + |rgb - center rgb|^2 * intensities_divisor)
+	 *        normalized by their sum over the window
+	 * @param gaussian_divisor -0.5 / sigma_d^2
+	 * @param intensities_divisor -0.5 / sigma_r^2
+	 */
+	void bilateral(const Image &src, Image &dst, uint32_t radius, float gaussian_divisor, float intensities_divisor);
+
+	/**
+	 * @brief Tent of the tent filter sample, weights k - b * (|x| + |y|) normalized by their sum over the window
+	 *        Like the tent filter sample, b is limited to (k - 0.5) / (2 * radius) so that the corner weight stays at 0.5 or above
+	 */
+	void tent(const Image &src, Image &dst, uint32_t radius, float k, float b);
+
+	/**
+	 * @brief TAA statistics of the TAA statistics sample, not implemented
+	 *        The shaders that define its gamma and t parameters are not part of the tree, so there are no
+	 *        weights to match. The destination is left unchanged.
+	 * @returns False, the filter is not supported
+	 */
+	bool taa_statistics(const Image &src, Image &dst, uint32_t radius, float gamma, float t);
+
+  private:
+	struct Planes;
+
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
+
+	InstructionSet instruction_set{InstructionSet::Scalar};
+
+	// source and destination planes and the intermediate planes of the separable filters, reused between calls
+	std::unique_ptr<Planes> planes;
+
+	/**
+	 * @brief Calls func(y_begin, y_end) for bands of rows covering [0, height) on the thread pool and waits for them
+	 */
+	void for_each_band(uint32_t height, const std::function<void(uint32_t, uint32_t)> &func);
+
+	void convert_source(const Image &src, uint32_t pad);
+
+	void convert_output(Image &dst);
+
+	void separable(const Image &src, Image &dst, const std::vector<float> &weights);
+};
+}        // namespace vkb
@@ -0,0 +1,102 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_filter_kernels.h"
+
+// Built with AVX2 enabled, only called once the CPU is known to support it
+#ifdef VKB_CPU_FILTER_AVX2
+
+#	include <immintrin.h>
+
+namespace vkb
+{
+namespace cpu_filter
+{
+namespace
+{
+struct AvxFloat
+{
+	static constexpr uint32_t lanes = 8;
+
+	__m256 value;
+
+	static AvxFloat load(const float *data)
+	{
+		return {_mm256_loadu_ps(data)};
+	}
+
+	static AvxFloat set(float value)
+	{
+		return {_mm256_set1_ps(value)};
+	}
+
+	void store(float *data) const
+	{
+		_mm256_storeu_ps(data, value);
+	}
+};
+
+inline AvxFloat operator+(AvxFloat a, AvxFloat b)
+{
+	return {_mm256_add_ps(a.value, b.value)};
+}
+
+inline AvxFloat operator-(AvxFloat a, AvxFloat b)
+{
+	return {_mm256_sub_ps(a.value, b.value)};
+}
+
+inline AvxFloat operator*(AvxFloat a, AvxFloat b)
+{
+	return {_mm256_mul_ps(a.value, b.value)};
+}
+
+inline AvxFloat operator/(AvxFloat a, AvxFloat b)
+{
+	return {_mm256_div_ps(a.value, b.value)};
+}
+
+inline AvxFloat min(AvxFloat a, AvxFloat b)
+{
+	return {_mm256_min_ps(a.value, b.value)};
+}
+
+inline AvxFloat max(AvxFloat a, AvxFloat b)
+{
+	return {_mm256_max_ps(a.value, b.value)};
+}
+
+inline AvxFloat floor(AvxFloat a)
+{
+	return {_mm256_floor_ps(a.value)};
+}
+
+inline AvxFloat pow2(AvxFloat n)
+{
+	__m256i bits = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(n.value), _mm256_set1_epi32(127)), 23);
+	return {_mm256_castsi256_ps(bits)};
+}
+}        // namespace
+
+Kernels get_avx2_kernels()
+{
+	return make_kernels<AvxFloat>();
+}
+}        // namespace cpu_filter
+}        // namespace vkb
+
+#endif
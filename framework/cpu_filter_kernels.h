@@ -0,0 +1,354 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+/*
+ * Kernels of vkb::CpuFilter, only included by cpu_filter.cpp and the translation units
+ * built for a specific instruction set (cpu_filter_sse4.cpp, cpu_filter_avx2.cpp).
+ *
+ * The kernels are templates over a vector type which provides load, store, set and the
+ * arithmetic they need. Everything is defined in an unnamed namespace so that every
+ * translation unit gets its own copies, compiled with its own instruction set: no inline
+ * function may be shared between them, so the kernels only call the C math functions
+ * and none of the inline functions of the standard library.
+ * The vector types only use separate multiplies and adds, never fused ones, so all
+ * instruction sets produce exactly the same results.
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+
+namespace vkb
+{
+namespace cpu_filter
+{
+/**
+ * @brief Image stored as one float plane per channel
+ *        Every row is padded on both sides with copies of its edge texels, so that horizontal
+ *        windows never have to be clamped, vertical windows clamp the row index instead.
+ */
+struct PlanarImage
+{
+	float *planes[4];
+
+	uint32_t width;
+	uint32_t height;
+
+	/// Texels of padding on each side of a row
+	uint32_t pad;
+
+	/// Floats from one row to the next, at least width + 2 * pad
+	uint32_t stride;
+};
+
+/**
+ * @brief Kernels of one instruction set, each one computes the rows [y_begin, y_end) of dst
+ */
+struct Kernels
+{
+	/// Horizontal one-dimensional convolution with 2 * radius + 1 weights
+	void (*convolve_rows)(const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius, uint32_t y_begin, uint32_t y_end);
+
+	/// Vertical one-dimensional convolution with 2 * radius + 1 weights
+	void (*convolve_columns)(const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius, uint32_t y_begin, uint32_t y_end);
+
+	/// Two-dimensional convolution with (2 * radius + 1)^2 weights, row by row
+	void (*convolve_2d)(const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius, uint32_t y_begin, uint32_t y_end);
+
+	/// Bilateral filter, spatial_terms are (x * x + y * y) * gaussian_divisor for the (2 * radius + 1)^2 texels of the window
+	void (*bilateral)(const PlanarImage &src, const PlanarImage &dst, const float *spatial_terms, float intensities_divisor, uint32_t radius, uint32_t y_begin, uint32_t y_end);
+};
+
+Kernels get_scalar_kernels();
+
+Kernels get_sse4_kernels();
+
+Kernels get_avx2_kernels();
+
+namespace
+{
+/**
+ * @brief Vector type of a single lane, used by the scalar kernels and for the texels left over
+ *        at the end of a row by the wider vector types
+ */
+struct ScalarFloat
+{
+	static constexpr uint32_t lanes = 1;
+
+	float value;
+
+	static ScalarFloat load(const float *data)
+	{
+		return {*data};
+	}
+
+	static ScalarFloat set(float value)
+	{
+		return {value};
+	}
+
+	void store(float *data) const
+	{
+		*data = value;
+	}
+};
+
+inline ScalarFloat operator+(ScalarFloat a, ScalarFloat b)
+{
+	return {a.value + b.value};
+}
+
+inline ScalarFloat operator-(ScalarFloat a, ScalarFloat b)
+{
+	return {a.value - b.value};
+}
+
+inline ScalarFloat operator*(ScalarFloat a, ScalarFloat b)
+{
+	return {a.value * b.value};
+}
+
+inline ScalarFloat operator/(ScalarFloat a, ScalarFloat b)
+{
+	return {a.value / b.value};
+}
+
+inline ScalarFloat min(ScalarFloat a, ScalarFloat b)
+{
+	// same operand order as minps, which returns the second operand if either is NaN
+	return {a.value < b.value ? a.value : b.value};
+}
+
+inline ScalarFloat max(ScalarFloat a, ScalarFloat b)
+{
+	return {a.value > b.value ? a.value : b.value};
+}
+
+inline ScalarFloat floor(ScalarFloat a)
+{
+	return {floorf(a.value)};
+}
+
+/**
+ * @brief 2^n for integral n in [-126, 127], built from the exponent bits
+ */
+inline ScalarFloat pow2(ScalarFloat n)
+{
+	int32_t bits = (static_cast<int32_t>(n.value) + 127) << 23;
+	float   value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return {value};
+}
+
+inline const float *row(const PlanarImage &image, uint32_t channel, uint32_t y)
+{
+	return image.planes[channel] + static_cast<size_t>(y) * image.stride + image.pad;
+}
+
+inline float *row(const PlanarImage &image, uint32_t channel, uint32_t y, int32_t x)
+{
+	return image.planes[channel] + static_cast<size_t>(y) * image.stride + image.pad + x;
+}
+
+inline uint32_t clamp_row(int32_t y, uint32_t height)
+{
+	return y < 0 ? 0 : (y >= static_cast<int32_t>(height) ? height - 1 : static_cast<uint32_t>(y));
+}
+
+/**
+ * @brief exp(x) as a polynomial on the range reduced argument (Cephes expf)
+ *        The same evaluation for all vector types keeps their results identical,
+ *        the relative error is about 2 ulp.
+ */
+template <typename V>
+V exp(V x)
+{
+	x = min(max(x, V::set(-87.0f)), V::set(88.0f));
+
+	V n = floor(x * V::set(1.44269504088896341f) + V::set(0.5f));
+	x   = x - n * V::set(0.693359375f);
+	x   = x - n * V::set(-2.12194440e-4f);
+
+	V p = V::set(1.9875691500e-4f);
+	p   = p * x + V::set(1.3981999507e-3f);
+	p   = p * x + V::set(8.3334519073e-3f);
+	p   = p * x + V::set(4.1665795894e-2f);
+	p   = p * x + V::set(1.6666665459e-1f);
+	p   = p * x + V::set(5.0000001201e-1f);
+	p   = p * (x * x) + x + V::set(1.0f);
+
+	return p * pow2(n);
+}
+
+template <typename V>
+struct ConvolveRows
+{
+	static void run(int32_t x, uint32_t y, const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius)
+	{
+		int32_t r = static_cast<int32_t>(radius);
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			const float *in  = row(src, c, y) + x - r;
+			V            sum = V::set(0.0f);
+			for (int32_t i = 0; i <= 2 * r; ++i)
+			{
+				sum = sum + V::set(weights[i]) * V::load(in + i);
+			}
+			sum.store(row(dst, c, y, x));
+		}
+	}
+};
+
+template <typename V>
+struct ConvolveColumns
+{
+	static void run(int32_t x, uint32_t y, const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius)
+	{
+		int32_t r = static_cast<int32_t>(radius);
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			V sum = V::set(0.0f);
+			for (int32_t i = -r; i <= r; ++i)
+			{
+				uint32_t sy = clamp_row(static_cast<int32_t>(y) + i, src.height);
+				sum         = sum + V::set(weights[i + r]) * V::load(row(src, c, sy) + x);
+			}
+			sum.store(row(dst, c, y, x));
+		}
+	}
+};
+
+template <typename V>
+struct Convolve2D
+{
+	static void run(int32_t x, uint32_t y, const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius)
+	{
+		int32_t r = static_cast<int32_t>(radius);
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			V            sum    = V::set(0.0f);
+			const float *weight = weights;
+			for (int32_t j = -r; j <= r; ++j)
+			{
+				const float *in = row(src, c, clamp_row(static_cast<int32_t>(y) + j, src.height)) + x - r;
+				for (int32_t i = 0; i <= 2 * r; ++i)
+				{
+					sum = sum + V::set(*weight++) * V::load(in + i);
+				}
+			}
+			sum.store(row(dst, c, y, x));
+		}
+	}
+};
+
+template <typename V>
+struct Bilateral
+{
+	static void run(int32_t x, uint32_t y, const PlanarImage &src, const PlanarImage &dst, const float *spatial_terms, float intensities_divisor, uint32_t radius)
+	{
+		int32_t r = static_cast<int32_t>(radius);
+
+		V center[3];
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			center[c] = V::load(row(src, c, y) + x);
+		}
+
+		V divisor    = V::set(intensities_divisor);
+		V sum[4]     = {V::set(0.0f), V::set(0.0f), V::set(0.0f), V::set(0.0f)};
+		V weight_sum = V::set(0.0f);
+		for (int32_t j = -r; j <= r; ++j)
+		{
+			uint32_t sy = clamp_row(static_cast<int32_t>(y) + j, src.height);
+			for (int32_t i = -r; i <= r; ++i)
+			{
+				V value[4];
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					value[c] = V::load(row(src, c, sy) + x + i);
+				}
+
+				V diff_r   = value[0] - center[0];
+				V diff_g   = value[1] - center[1];
+				V diff_b   = value[2] - center[2];
+				V distance = diff_r * diff_r + diff_g * diff_g + diff_b * diff_b;
+
+				V weight = exp(V::set(spatial_terms[(j + r) * (2 * r + 1) + i + r]) + distance * divisor);
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					sum[c] = sum[c] + weight * value[c];
+				}
+				weight_sum = weight_sum + weight;
+			}
+		}
+
+		for (uint32_t c = 0; c < 4; ++c)
+		{
+			(sum[c] / weight_sum).store(row(dst, c, y, x));
+		}
+	}
+};
+
+/**
+ * @brief Runs a kernel over the rows [y_begin, y_end), V::lanes texels at a time
+ *        and the texels left at the end of each row one at a time
+ */
+template <template <typename> class Kernel, typename V, typename... Args>
+void run_kernel(uint32_t width, uint32_t y_begin, uint32_t y_end, const Args &...args)
+{
+	for (uint32_t y = y_begin; y < y_end; ++y)
+	{
+		uint32_t x = 0;
+		for (; x + V::lanes <= width; x += V::lanes)
+		{
+			Kernel<V>::run(static_cast<int32_t>(x), y, args...);
+		}
+		for (; x < width; ++x)
+		{
+			Kernel<ScalarFloat>::run(static_cast<int32_t>(x), y, args...);
+		}
+	}
+}
+
+template <typename V>
+Kernels make_kernels()
+{
+	Kernels kernels{};
+
+	kernels.convolve_rows = [](const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius, uint32_t y_begin, uint32_t y_end) {
+		run_kernel<ConvolveRows, V>(dst.width, y_begin, y_end, src, dst, weights, radius);
+	};
+
+	kernels.convolve_columns = [](const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius, uint32_t y_begin, uint32_t y_end) {
+		run_kernel<ConvolveColumns, V>(dst.width, y_begin, y_end, src, dst, weights, radius);
+	};
+
+	kernels.convolve_2d = [](const PlanarImage &src, const PlanarImage &dst, const float *weights, uint32_t radius, uint32_t y_begin, uint32_t y_end) {
+		run_kernel<Convolve2D, V>(dst.width, y_begin, y_end, src, dst, weights, radius);
+	};
+
+	kernels.bilateral = [](const PlanarImage &src, const PlanarImage &dst, const float *spatial_terms, float intensities_divisor, uint32_t radius, uint32_t y_begin, uint32_t y_end) {
+		run_kernel<Bilateral, V>(dst.width, y_begin, y_end, src, dst, spatial_terms, intensities_divisor, radius);
+	};
+
+	return kernels;
+}
+}        // namespace
+}        // namespace cpu_filter
+}        // namespace vkb
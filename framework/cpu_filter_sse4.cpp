@@ -0,0 +1,102 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_filter_kernels.h"
+
+// Built with SSE4.1 enabled, only called once the CPU is known to support it
+#ifdef VKB_CPU_FILTER_SSE4
+
+#	include <smmintrin.h>
+
+namespace vkb
+{
+namespace cpu_filter
+{
+namespace
+{
+struct SseFloat
+{
+	static constexpr uint32_t lanes = 4;
+
+	__m128 value;
+
+	static SseFloat load(const float *data)
+	{
+		return {_mm_loadu_ps(data)};
+	}
+
+	static SseFloat set(float value)
+	{
+		return {_mm_set1_ps(value)};
+	}
+
+	void store(float *data) const
+	{
+		_mm_storeu_ps(data, value);
+	}
+};
+
+inline SseFloat operator+(SseFloat a, SseFloat b)
+{
+	return {_mm_add_ps(a.value, b.value)};
+}
+
+inline SseFloat operator-(SseFloat a, SseFloat b)
+{
+	return {_mm_sub_ps(a.value, b.value)};
+}
+
+inline SseFloat operator*(SseFloat a, SseFloat b)
+{
+	return {_mm_mul_ps(a.value, b.value)};
+}
+
+inline SseFloat operator/(SseFloat a, SseFloat b)
+{
+	return {_mm_div_ps(a.value, b.value)};
+}
+
+inline SseFloat min(SseFloat a, SseFloat b)
+{
+	return {_mm_min_ps(a.value, b.value)};
+}
+
+inline SseFloat max(SseFloat a, SseFloat b)
+{
+	return {_mm_max_ps(a.value, b.value)};
+}
+
+inline SseFloat floor(SseFloat a)
+{
+	return {_mm_floor_ps(a.value)};
+}
+
+inline SseFloat pow2(SseFloat n)
+{
+	__m128i bits = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(n.value), _mm_set1_epi32(127)), 23);
+	return {_mm_castsi128_ps(bits)};
+}
+}        // namespace
+
+Kernels get_sse4_kernels()
+{
+	return make_kernels<SseFloat>();
+}
+}        // namespace cpu_filter
+}        // namespace vkb
+
+#endif
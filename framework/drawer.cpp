@@ -17,6 +17,8 @@
 
 #include "drawer.h"
 
+#include "stats/timing_statistics.h"
+
 namespace vkb
 {
 
@@ -140,6 +142,17 @@ void Drawer::text(const char *formatstr, ...)
 	va_end(args);
 }
 
+void Drawer::timing_statistics(const char *caption, const TimingStatistics &timings)
+{
+	auto summary = timings.get_summary();
+	text("%s: mean %lf ms (+-%lf)\n"
+	     "  median %lf ms, stddev %lf ms\n"
+	     "  min %lf ms, p90 %lf ms, p99 %lf ms",
+	     caption, summary.mean, summary.ci95,
+	     summary.median, summary.stddev,
+	     summary.min, summary.p90, summary.p99);
+}
+
 template <>
 bool Drawer::color_op_impl<Drawer::ColorOp::Edit, 3>(const char *caption, float *colors, ImGuiColorEditFlags flags)
 {
@@ -26,6 +26,7 @@
 namespace vkb
 {
 class Drawer;
+class TimingStatistics;
 
 /**
  * @brief Responsible for drawing new elements into the gui
@@ -140,6 +141,13 @@ class Drawer
 	 */
 	void text(const char *formatstr, ...);
 
+	/**
+	 * @brief Adds the summary of a timing measurement to the gui
+	 * @param caption The name of the measurement
+	 * @param timings The samples to summarize, in milliseconds
+	 */
+	void timing_statistics(const char *caption, const TimingStatistics &timings);
+
 	/**
 	 * @brief Adds a color picker to the gui
 	 * @param caption The text to display
@@ -0,0 +1,398 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "filter_benchmark_sample.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <cstring>
+
+#include "common/utils.h"
+#include "platform/filesystem.h"
+#include "stats/pass_statistics_queries.h"
+#include "stats/trace_recorder.h"
+
+FilterBenchmarkSample::FilterBenchmarkSample()
+{
+	// half precision arithmetic and storage, the features are queried through vkGetPhysicalDeviceFeatures2
+	add_instance_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+	add_device_extension(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_STORAGE_BUFFER_STORAGE_CLASS_EXTENSION_NAME, true);
+	add_device_extension(VK_KHR_16BIT_STORAGE_EXTENSION_NAME, true);
+}
+
+void FilterBenchmarkSample::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	uint32_t extension_count = 0;
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu.get_handle(), nullptr, &extension_count, nullptr));
+	std::vector<VkExtensionProperties> extensions(extension_count);
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu.get_handle(), nullptr, &extension_count, extensions.data()));
+
+	auto has_extension = [&extensions](const char *name) {
+		return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties &extension) {
+			return std::strcmp(extension.extensionName, name) == 0;
+		});
+	};
+
+	if (has_extension(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME))
+	{
+		auto &float16_int8_features = gpu.request_extension_features<VkPhysicalDeviceShaderFloat16Int8FeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_FLOAT16_INT8_FEATURES_KHR);
+		half_float_supported        = float16_int8_features.shaderFloat16;
+
+		// 8-bit arithmetic is not used
+		float16_int8_features.shaderInt8 = VK_FALSE;
+	}
+
+	if (has_extension(VK_KHR_16BIT_STORAGE_EXTENSION_NAME) && has_extension(VK_KHR_STORAGE_BUFFER_STORAGE_CLASS_EXTENSION_NAME))
+	{
+		auto &storage_features       = gpu.request_extension_features<VkPhysicalDevice16BitStorageFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_16BIT_STORAGE_FEATURES_KHR);
+		half_float_storage_supported = storage_features.storageBuffer16BitAccess;
+
+		// only the weights of the storage buffers are stored in half precision
+		storage_features.uniformAndStorageBuffer16BitAccess = VK_FALSE;
+		storage_features.storagePushConstant16              = VK_FALSE;
+		storage_features.storageInputOutput16               = VK_FALSE;
+	}
+}
+
+bool FilterBenchmarkSample::set_processing_extent(const Extent &extent)
+{
+	if (!prepared)
+	{
+		processing_extent = {extent.width, extent.height};
+		return true;
+	}
+
+	uint32_t max_extent = get_device().get_gpu().get_properties().limits.maxImageDimension2D;
+	if (extent.width > max_extent || extent.height > max_extent)
+	{
+		LOGW("Processing resolution {}x{} exceeds the device limit of {}", extent.width, extent.height, max_extent);
+		return false;
+	}
+
+	processing_extent = {extent.width, extent.height};
+
+	device->wait_idle();
+
+	setup_images();
+	setup_framebuffer();
+	update_extent_push_constants();
+
+	// the timings of the frames in flight and the full precision output were taken at the previous resolution
+	precision_reference.pixels.clear();
+	on_processing_extent_changed();
+	reset_timings();
+
+	rebuild_command_buffers();
+	return true;
+}
+
+vkb::BenchmarkTarget::Extent FilterBenchmarkSample::get_processing_extent() const
+{
+	VkExtent2D extent = get_filter_extent();
+	return {extent.width, extent.height};
+}
+
+bool FilterBenchmarkSample::set_batch_size(uint32_t size)
+{
+	if (size == 0)
+	{
+		return false;
+	}
+
+	if (!prepared)
+	{
+		batch_size = size;
+		return true;
+	}
+
+	uint32_t max_batch_size = get_max_batch_size();
+	if (size > max_batch_size)
+	{
+		LOGW("Batches of {} images exceed the limit of {} of the sample on this device", size, max_batch_size);
+		return false;
+	}
+
+	device->wait_idle();
+
+	batch_size = size;
+
+	on_batch_size_changed();
+
+	// the timings of the frames in flight cover the previous batch
+	reset_timings();
+
+	rebuild_command_buffers();
+	return true;
+}
+
+uint32_t FilterBenchmarkSample::get_batch_size() const
+{
+	return batch_size;
+}
+
+bool FilterBenchmarkSample::save_output(const std::string &filename)
+{
+	VkExtent2D extent = get_filter_extent();
+	auto       pixels = read_output_image();
+	vkb::fs::write_image(pixels.data(), filename, extent.width, extent.height, 4, extent.width * 4);
+	return true;
+}
+
+VkExtent2D FilterBenchmarkSample::get_filter_extent() const
+{
+	if (processing_extent.width == 0 || processing_extent.height == 0)
+	{
+		return render_context->get_surface_extent();
+	}
+	return processing_extent;
+}
+
+void FilterBenchmarkSample::on_processing_extent_changed()
+{
+}
+
+uint32_t FilterBenchmarkSample::get_max_batch_size()
+{
+	return 1;
+}
+
+void FilterBenchmarkSample::on_batch_size_changed()
+{
+	setup_images();
+	setup_framebuffer();
+}
+
+void FilterBenchmarkSample::check_batch_size()
+{
+	uint32_t max_batch_size = get_max_batch_size();
+	if (batch_size > max_batch_size)
+	{
+		LOGW("Batches of {} images exceed the limit of {} of the sample on this device, filtering a single image per frame", batch_size, max_batch_size);
+		batch_size = 1;
+	}
+}
+
+void FilterBenchmarkSample::record_batch_copy(VkCommandBuffer cmd, const vkb::core::Image &image)
+{
+	if (batch_size == 1)
+	{
+		return;
+	}
+
+	// the first layer is read by the copy, the other layers written over
+	std::array<VkImageMemoryBarrier, 2> barriers;
+	for (auto &barrier : barriers)
+	{
+		barrier                     = vkb::initializers::image_memory_barrier();
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image               = image.get_handle();
+	}
+	barriers[0].srcAccessMask    = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	barriers[0].dstAccessMask    = VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[0].oldLayout        = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[0].newLayout        = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[0].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+	barriers[1].srcAccessMask    = VK_ACCESS_NONE;
+	barriers[1].dstAccessMask    = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].oldLayout        = VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[1].newLayout        = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 1, batch_size - 1};
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+	                     0, 0, nullptr, 0, nullptr, vkb::to_u32(barriers.size()), barriers.data());
+
+	// a region per layer, the source and destination of a region have the same number of layers
+	std::vector<VkImageCopy> regions(batch_size - 1);
+	for (uint32_t i = 0; i < regions.size(); ++i)
+	{
+		regions[i].srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+		regions[i].srcOffset      = {0, 0, 0};
+		regions[i].dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, i + 1, 1};
+		regions[i].dstOffset      = {0, 0, 0};
+		regions[i].extent         = image.get_extent();
+	}
+
+	vkCmdCopyImage(cmd, image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, image.get_handle(), VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+	               vkb::to_u32(regions.size()), regions.data());
+
+	barriers[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[0].oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+	barriers[0].newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barriers[1].oldLayout     = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+	barriers[1].newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                     0, 0, nullptr, 0, nullptr, vkb::to_u32(barriers.size()), barriers.data());
+}
+
+std::vector<uint8_t> FilterBenchmarkSample::read_output_image()
+{
+	// the output image of the last frame is in the shader read only layout once the device is idle
+	device->wait_idle();
+
+	return vkb::read_image(get_device(), get_output_image(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
+void FilterBenchmarkSample::wait_for_frame_fence()
+{
+	{
+		vkb::ScopedTrace trace{"wait_for_fence"};
+		VK_CHECK(vkWaitForFences(get_device().get_handle(), 1, &wait_fences[current_buffer], VK_TRUE, UINT64_MAX));
+	}
+	VK_CHECK(vkResetFences(get_device().get_handle(), 1, &wait_fences[current_buffer]));
+}
+
+bool FilterBenchmarkSample::has_new_timings(const vkb::TimingStatistics &timings)
+{
+	if (timings.get_push_count() == reported_push_count)
+	{
+		return false;
+	}
+	reported_push_count = timings.get_push_count();
+	return true;
+}
+
+void FilterBenchmarkSample::check_half_float_support()
+{
+	half_float_supported = half_float_supported && get_device().is_enabled(VK_KHR_SHADER_FLOAT16_INT8_EXTENSION_NAME);
+	if (!half_float_supported)
+	{
+		LOGW("Half precision arithmetic is not supported, only the full precision variants are available");
+	}
+
+	// the half precision storage is only used by the half precision variants
+	half_float_storage_supported = half_float_supported && half_float_storage_supported &&
+	                               get_device().is_enabled(VK_KHR_16BIT_STORAGE_EXTENSION_NAME) &&
+	                               get_device().is_enabled(VK_KHR_STORAGE_BUFFER_STORAGE_CLASS_EXTENSION_NAME);
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> FilterBenchmarkSample::compare_to_full_precision(const std::string &configuration, bool half_precision, double time)
+{
+	auto pixels = read_output_image();
+
+	if (!half_precision)
+	{
+		precision_reference.configuration = configuration;
+		precision_reference.time          = time;
+		precision_reference.pixels        = std::move(pixels);
+		return {};
+	}
+
+	if (precision_reference.configuration != configuration || precision_reference.pixels.size() != pixels.size() || pixels.empty())
+	{
+		LOGW("No full precision output of {} to compare to", configuration);
+		return {};
+	}
+
+	uint32_t max_error = 0;
+	uint64_t error_sum = 0;
+	for (size_t i = 0; i < pixels.size(); ++i)
+	{
+		uint32_t error = static_cast<uint32_t>(std::abs(static_cast<int32_t>(pixels[i]) - static_cast<int32_t>(precision_reference.pixels[i])));
+		max_error      = std::max(max_error, error);
+		error_sum += error;
+	}
+
+	// errors of the 8-bit output, relative to its full range
+	std::vector<Metric> metrics;
+	if (time > 0.0)
+	{
+		metrics.push_back({"speedup", precision_reference.time / time});
+	}
+	metrics.push_back({"max_error", max_error / 255.0});
+	metrics.push_back({"mean_error", static_cast<double>(error_sum) / pixels.size() / 255.0});
+	return metrics;
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> FilterBenchmarkSample::profile_passes(const std::vector<ProfiledPass> &passes)
+{
+	vkb::PassStatisticsQueries queries{get_device(), device->get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0).get_family_index(),
+	                                   vkb::to_u32(passes.size())};
+	if (!queries.is_available())
+	{
+		return {};
+	}
+
+	// the frames in flight write to the same images
+	device->wait_idle();
+
+	// the queries are the first and last commands of the command buffer of each pass
+	std::vector<Metric> metrics;
+	for (uint32_t i = 0; i < passes.size(); ++i)
+	{
+		with_command_buffer([&](VkCommandBuffer cmd) {
+			queries.begin(cmd, i);
+			passes[i].record(cmd);
+			queries.end(cmd, i);
+		});
+
+		for (auto &result : queries.read(i))
+		{
+			metrics.push_back({fmt::format("{}_{}", passes[i].name, result.first), result.second});
+		}
+	}
+	return metrics;
+}
+
+void FilterBenchmarkSample::record_frames()
+{
+	outdated_frames.assign(draw_cmd_buffers.size(), false);
+	for (uint32_t i = 0; i < draw_cmd_buffers.size(); ++i)
+	{
+		record_frame(i);
+	}
+}
+
+void FilterBenchmarkSample::invalidate_frames()
+{
+	std::fill(outdated_frames.begin(), outdated_frames.end(), true);
+}
+
+void FilterBenchmarkSample::update_current_frame()
+{
+	// the GUI is drawn from buffers of the frame, its draw commands follow the draw data uploaded to them
+	if (update_frame_overlay())
+	{
+		outdated_frames[current_buffer] = true;
+	}
+
+	if (!outdated_frames[current_buffer])
+	{
+		return;
+	}
+
+	vkb::ScopedTrace trace{"record_frame"};
+
+	recreate_current_command_buffer();
+	record_frame(current_buffer);
+	outdated_frames[current_buffer] = false;
+}
+
+void FilterBenchmarkSample::apply_ui_changes(vkb::Drawer &drawer)
+{
+	if (drawer.is_dirty())
+	{
+		invalidate_frames();
+		drawer.clear();
+	}
+}
@@ -0,0 +1,213 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "api_vulkan_sample.h"
+#include "benchmark_target.h"
+#include "stats/timing_statistics.h"
+
+/**
+ * @brief Base class of the samples benchmarking filters on images of their own resolution
+ *
+ * The filter images have the processing resolution, which is the window size unless set through
+ * set_processing_extent(). Changing it recreates the images and the framebuffers of the derived
+ * class at the new resolution and discards the timings measured at the previous one, the derived
+ * classes only implementing the hooks creating their images and reporting their output image.
+ *
+ * Samples supporting batches filter the images of a batch as the layers of array images (see
+ * set_batch_size()). Every image of a batch holds the same source image, the samples drawing it
+ * into the first layer only copy it to the others with record_batch_copy().
+ */
+class FilterBenchmarkSample : public ApiVulkanSample, public vkb::BenchmarkTarget
+{
+  public:
+	FilterBenchmarkSample();
+	virtual ~FilterBenchmarkSample() = default;
+
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	// Benchmark runner interface
+	virtual bool     set_processing_extent(const Extent &extent) override;
+	virtual Extent   get_processing_extent() const override;
+	virtual bool     set_batch_size(uint32_t size) override;
+	virtual uint32_t get_batch_size() const override;
+	virtual bool     save_output(const std::string &filename) override;
+
+  protected:
+	/**
+	 * @brief Returns the resolution of the filter images, the window size unless a processing resolution is set
+	 */
+	VkExtent2D get_filter_extent() const;
+
+	/**
+	 * @brief Creates the filter images at the filter extent
+	 *        Called by set_processing_extent() once the device is idle, before setup_framebuffer()
+	 */
+	virtual void setup_images() = 0;
+
+	/**
+	 * @brief Updates the push constants derived from the filter extent
+	 */
+	virtual void update_extent_push_constants() = 0;
+
+	/**
+	 * @brief Discards the timings measured so far and the timestamps of the frames in flight
+	 */
+	virtual void reset_timings() = 0;
+
+	/**
+	 * @brief Called once the images of a new processing resolution are set up, before the command buffers are rebuilt
+	 *        Discards the results that depend on the resolution other than the timings, nothing by default
+	 */
+	virtual void on_processing_extent_changed();
+
+	/**
+	 * @brief Returns the largest batch of images the sample filters per frame on the device
+	 *        A single image by default, for the samples without batches
+	 */
+	virtual uint32_t get_max_batch_size();
+
+	/**
+	 * @brief Called by set_batch_size() once the device is idle, before the command buffers are rebuilt
+	 *        Recreates the images and the framebuffers with a layer per image of the batch by default
+	 */
+	virtual void on_batch_size_changed();
+
+	/**
+	 * @brief Falls back to a single image if the batch set before prepare() exceeds the limit of the device
+	 */
+	void check_batch_size();
+
+	/**
+	 * @brief Records the copy of the first layer of an image to the other layers of the batch
+	 *        The image is in the shader read only layout before and after the copy, a single image needs no copy
+	 */
+	void record_batch_copy(VkCommandBuffer cmd, const vkb::core::Image &image);
+
+	/**
+	 * @brief Returns the image the filter writes to, in the shader read only layout at the end of a frame
+	 */
+	virtual const vkb::core::Image &get_output_image() const = 0;
+
+	/**
+	 * @brief Waits for the device to be idle and reads the first layer of the output image
+	 * @returns Tightly packed RGBA8 pixels of the filter extent
+	 */
+	std::vector<uint8_t> read_output_image();
+
+	/**
+	 * @brief Waits for the previous submission of the current command buffer and resets its fence
+	 *        The fence guards both the command buffer and its range of timestamp queries, which can be read afterwards
+	 */
+	void wait_for_frame_fence();
+
+	/**
+	 * @brief Checks whether a sample was pushed to the timings since the previous call, for get_benchmark_pass_times()
+	 * @param timings Timings pushed once per frame read back, along with the other timings reported
+	 */
+	bool has_new_timings(const vkb::TimingStatistics &timings);
+
+	/**
+	 * @brief Disables the half precision variants if the extensions of the features requested by request_gpu_features()
+	 *        were not enabled, called by prepare() once the device is created
+	 */
+	void check_half_float_support();
+
+	/**
+	 * @brief Compares the output of a half precision configuration to the output of its full precision configuration
+	 *        The benchmark measures every full precision configuration right before its half precision ones, whose
+	 *        output is read back and compared to the full precision output of the same configuration name
+	 * @param configuration Name of the configuration without its precision
+	 * @param half_precision Whether the configuration computes in half precision, otherwise its output becomes the reference
+	 * @param time Median GPU time in ms of the configuration
+	 * @returns The speedup and the max and mean errors of the 8-bit output relative to its range, none for full precision
+	 */
+	std::vector<Metric> compare_to_full_precision(const std::string &configuration, bool half_precision, double time);
+
+	// shaderFloat16 of VK_KHR_shader_float16_int8
+	bool half_float_supported = false;
+
+	// storageBuffer16BitAccess of VK_KHR_16bit_storage, half precision values in storage buffers
+	bool half_float_storage_supported = false;
+
+	/**
+	 * @brief A pass profiled by profile_passes(), recorded into a command buffer of its own
+	 */
+	struct ProfiledPass
+	{
+		std::string name;
+
+		std::function<void(VkCommandBuffer)> record;
+	};
+
+	/**
+	 * @brief Waits for the device to be idle and collects the pipeline statistics and performance counters of every pass
+	 *        Each pass is submitted on its own to the queue of the frames, with the images its frames left them in
+	 * @returns A metric per statistic and counter, prefixed with the name of the pass, none if the device has no queries
+	 */
+	std::vector<Metric> profile_passes(const std::vector<ProfiledPass> &passes);
+
+	/**
+	 * @brief Records the command buffers of a frame
+	 */
+	virtual void record_frame(uint32_t frame) = 0;
+
+	/**
+	 * @brief Records every frame, called by build_command_buffers() once the resources of the frames are up to date
+	 */
+	void record_frames();
+
+	/**
+	 * @brief Marks every frame to be re-recorded before its next submission
+	 */
+	void invalidate_frames();
+
+	/**
+	 * @brief Re-records the current frame if it is outdated, called by render() after wait_for_frame_fence()
+	 *        While the GUI is visible the frame is outdated every time, since its draw commands follow the GUI
+	 */
+	void update_current_frame();
+
+	/**
+	 * @brief Applies the changes made through the UI by marking the frames as outdated
+	 *        Called at the end of on_update_ui_overlay(), clears the dirty flag of the drawer so that
+	 *        the UI changes do not rebuild every command buffer
+	 */
+	void apply_ui_changes(vkb::Drawer &drawer);
+
+  private:
+	// resolution of the filter images, the window size if zero
+	VkExtent2D processing_extent{};
+
+	// images filtered per frame, as the layers of the filter images
+	uint32_t batch_size = 1;
+
+	// frames recorded before the last change, re-recorded before their next submission
+	std::vector<bool> outdated_frames;
+
+	// push count of the timings when the pass times were last reported
+	uint64_t reported_push_count = 0;
+
+	// output and median GPU time of the last full precision configuration measured by the benchmark
+	struct
+	{
+		std::string          configuration;
+		double               time;
+		std::vector<uint8_t> pixels;
+	} precision_reference{};
+};
@@ -0,0 +1,224 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "filter_kernel.h"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace vkb
+{
+namespace
+{
+/**
+ * @brief Throws if a kernel of the given radius does not fit the kernel buffer of the shaders
+ */
+void validate_radius(uint32_t radius)
+{
+	if (radius > FilterKernel::max_radius)
+	{
+		throw std::invalid_argument("Filter kernel radius " + std::to_string(radius) + " exceeds the maximum of " + std::to_string(FilterKernel::max_radius));
+	}
+}
+
+/**
+ * @brief Returns the radius of a kernel with the given number of taps along one axis
+ */
+uint32_t radius_from_size(size_t size)
+{
+	if (size % 2 == 0)
+	{
+		throw std::invalid_argument("A filter kernel must have an odd number of taps");
+	}
+	return static_cast<uint32_t>(size / 2);
+}
+
+std::vector<float> normalized(std::vector<float> weights)
+{
+	float sum = 0.0f;
+	for (float weight : weights)
+	{
+		sum += weight;
+	}
+
+	if (sum != 0.0f)
+	{
+		for (float &weight : weights)
+		{
+			weight /= sum;
+		}
+	}
+	return weights;
+}
+}        // namespace
+
+FilterKernel::FilterKernel(std::string name, uint32_t radius, bool separable, std::vector<float> weights) :
+    name{std::move(name)},
+    radius{radius},
+    separable{separable},
+    weights{std::move(weights)}
+{
+	validate_radius(radius);
+}
+
+FilterKernel FilterKernel::gaussian(uint32_t radius, float sigma)
+{
+	validate_radius(radius);
+
+	// a zero or negative sigma would divide by zero or give weights that do not fall off
+	if (!(sigma > 0.0f) || !std::isfinite(sigma))
+	{
+		throw std::invalid_argument("The sigma of a gaussian kernel must be positive and finite, got " + std::to_string(sigma));
+	}
+
+	std::vector<float> weights(2 * radius + 1);
+	for (uint32_t i = 0; i < weights.size(); ++i)
+	{
+		float x    = static_cast<float>(i) - static_cast<float>(radius);
+		weights[i] = std::exp(-0.5f * x * x / (sigma * sigma));
+	}
+	return FilterKernel{"gaussian", radius, true, normalized(std::move(weights))};
+}
+
+FilterKernel FilterKernel::box(uint32_t radius)
+{
+	validate_radius(radius);
+	return FilterKernel{"box", radius, true, normalized(std::vector<float>(2 * radius + 1, 1.0f))};
+}
+
+FilterKernel FilterKernel::tent(uint32_t radius)
+{
+	validate_radius(radius);
+
+	std::vector<float> weights(2 * radius + 1);
+	for (uint32_t i = 0; i < weights.size(); ++i)
+	{
+		weights[i] = static_cast<float>(radius + 1) - std::abs(static_cast<float>(i) - static_cast<float>(radius));
+	}
+	return FilterKernel{"tent", radius, true, normalized(std::move(weights))};
+}
+
+FilterKernel FilterKernel::from_row(std::string name, std::vector<float> weights)
+{
+	uint32_t radius = radius_from_size(weights.size());
+	return FilterKernel{std::move(name), radius, true, std::move(weights)};
+}
+
+FilterKernel FilterKernel::from_weights(std::string name, std::vector<float> weights)
+{
+	auto size = static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(weights.size()))));
+	if (size * size != weights.size())
+	{
+		throw std::invalid_argument("A non-separable filter kernel must have a square number of weights");
+	}
+
+	uint32_t radius = radius_from_size(size);
+	return FilterKernel{std::move(name), radius, false, std::move(weights)};
+}
+
+const std::string &FilterKernel::get_name() const
+{
+	return name;
+}
+
+uint32_t FilterKernel::get_radius() const
+{
+	return radius;
+}
+
+uint32_t FilterKernel::get_size() const
+{
+	return 2 * radius + 1;
+}
+
+bool FilterKernel::is_separable() const
+{
+	return separable;
+}
+
+const std::vector<float> &FilterKernel::get_weights() const
+{
+	static const std::vector<float> empty;
+	return separable ? weights : empty;
+}
+
+std::vector<float> FilterKernel::get_weights_2d() const
+{
+	if (!separable)
+	{
+		return weights;
+	}
+
+	uint32_t           size = get_size();
+	std::vector<float> weights_2d(size * size);
+	for (uint32_t y = 0; y < size; ++y)
+	{
+		for (uint32_t x = 0; x < size; ++x)
+		{
+			weights_2d[y * size + x] = weights[y] * weights[x];
+		}
+	}
+	return weights_2d;
+}
+
+bool FilterKernel::supports_linear_sampling() const
+{
+	if (!separable)
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i + 1 < weights.size(); i += 2)
+	{
+		if (weights[i] * weights[i + 1] < 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+std::vector<FilterKernel::LinearTap> FilterKernel::get_linear_taps() const
+{
+	std::vector<LinearTap> taps;
+	if (!supports_linear_sampling())
+	{
+		return taps;
+	}
+
+	taps.reserve(radius + 1);
+	for (size_t i = 0; i < weights.size(); i += 2)
+	{
+		float offset = static_cast<float>(i) - static_cast<float>(radius);
+
+		// The last tap of an odd number of taps is left alone
+		if (i + 1 == weights.size())
+		{
+			taps.push_back({offset, weights[i]});
+			continue;
+		}
+
+		float weight = weights[i] + weights[i + 1];
+		if (weight != 0.0f)
+		{
+			offset += weights[i + 1] / weight;
+		}
+		taps.push_back({offset, weight});
+	}
+	return taps;
+}
+}        // namespace vkb
@@ -0,0 +1,122 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Description of a square convolution kernel with weights computed on the CPU
+ *
+ * A kernel is either separable, in which case it is stored as the single row that is
+ * applied horizontally and then vertically, or non-separable and stored as its full
+ * (2 * radius + 1)^2 weights in row-major order.
+ */
+class FilterKernel
+{
+  public:
+	/// Largest supported radius, the GPU kernel buffer is sized for it
+	static constexpr uint32_t max_radius = 32;
+
+	/**
+	 * @brief A bilinear tap that replaces two adjacent taps of a separable kernel
+	 */
+	struct LinearTap
+	{
+		/// Offset in texels from the center, between the two merged texels
+		float offset;
+
+		float weight;
+	};
+
+	/**
+	 * @brief Separable gaussian kernel, normalized to sum 1
+	 * @throws std::invalid_argument if sigma is not positive or the radius exceeds max_radius
+	 */
+	static FilterKernel gaussian(uint32_t radius, float sigma);
+
+	/**
+	 * @brief Separable box kernel, normalized to sum 1
+	 */
+	static FilterKernel box(uint32_t radius);
+
+	/**
+	 * @brief Separable tent (bilinear) kernel, normalized to sum 1
+	 */
+	static FilterKernel tent(uint32_t radius);
+
+	/**
+	 * @brief Separable kernel from its row of weights
+	 * @param weights 2 * radius + 1 weights, used as given
+	 */
+	static FilterKernel from_row(std::string name, std::vector<float> weights);
+
+	/**
+	 * @brief Non-separable kernel from its full weights
+	 * @param weights (2 * radius + 1)^2 weights in row-major order, used as given
+	 */
+	static FilterKernel from_weights(std::string name, std::vector<float> weights);
+
+	const std::string &get_name() const;
+
+	uint32_t get_radius() const;
+
+	/**
+	 * @returns Number of taps along one axis, 2 * radius + 1
+	 */
+	uint32_t get_size() const;
+
+	bool is_separable() const;
+
+	/**
+	 * @returns The row of weights of a separable kernel, empty for a non-separable one
+	 */
+	const std::vector<float> &get_weights() const;
+
+	/**
+	 * @returns The full weights in row-major order, the outer product of the row for a separable kernel
+	 */
+	std::vector<float> get_weights_2d() const;
+
+	/**
+	 * @brief Checks whether adjacent taps can be merged into bilinear taps,
+	 *        which requires a separable kernel whose merged weights have the same sign
+	 */
+	bool supports_linear_sampling() const;
+
+	/**
+	 * @brief Merges adjacent taps of the row pairwise, halving the number of texture fetches
+	 * @returns radius + 1 taps, empty if the kernel does not support linear sampling
+	 */
+	std::vector<LinearTap> get_linear_taps() const;
+
+  private:
+	FilterKernel(std::string name, uint32_t radius, bool separable, std::vector<float> weights);
+
+	std::string name;
+
+	uint32_t radius;
+
+	bool separable;
+
+	std::vector<float> weights;
+};
+}        // namespace vkb
@@ -0,0 +1,2338 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "filter_sample.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <glm/gtc/packing.hpp>
+
+#include "glsl_compiler.h"
+
+namespace
+{
+// Layout of the Kernel buffer declared in shaders/filters/convolution.h (std430)
+constexpr uint32_t     max_kernel_size           = 2 * vkb::FilterKernel::max_radius + 1;
+constexpr VkDeviceSize kernel_weights_offset     = 0;
+constexpr VkDeviceSize kernel_linear_taps_offset = (max_kernel_size * sizeof(float) + 7) & ~VkDeviceSize{7};        // vec2 is 8 byte aligned
+constexpr VkDeviceSize kernel_weights_2d_offset  = kernel_linear_taps_offset + (vkb::FilterKernel::max_radius + 1) * 2 * sizeof(float);
+constexpr VkDeviceSize kernel_buffer_size        = kernel_weights_2d_offset + max_kernel_size * max_kernel_size * sizeof(float);
+
+// Layout of the Kernel buffer of the half precision variants with 16-bit storage (FILTER_FP16_STORAGE),
+// the weights are half precision, the linear taps stay full precision as they hold texture coordinate offsets
+constexpr VkDeviceSize half_kernel_weights_offset     = 0;
+constexpr VkDeviceSize half_kernel_linear_taps_offset = (max_kernel_size * sizeof(uint16_t) + 7) & ~VkDeviceSize{7};
+constexpr VkDeviceSize half_kernel_weights_2d_offset  = half_kernel_linear_taps_offset + (vkb::FilterKernel::max_radius + 1) * 2 * sizeof(float);
+constexpr VkDeviceSize half_kernel_buffer_size        = half_kernel_weights_2d_offset + max_kernel_size * max_kernel_size * sizeof(uint16_t);
+
+std::vector<uint16_t> to_half_floats(const std::vector<float> &values)
+{
+	std::vector<uint16_t> half_values(values.size());
+	std::transform(values.begin(), values.end(), half_values.begin(), [](float value) { return glm::packHalf1x16(value); });
+	return half_values;
+}
+
+// Suffixes of the benchmark types of each precision, indexed by FilterPrecision
+constexpr std::array<const char *, 3> precision_suffixes = {"", "_FP16", "_FP16_RGBA16F"};
+
+double to_megabytes(VkDeviceSize size)
+{
+	return static_cast<double>(size) / (1024.0 * 1024.0);
+}
+
+}        // namespace
+
+FilterSample::FilterSample()
+{
+	// batches of images are drawn by the fragment passes through multiview render passes
+	add_device_extension(VK_KHR_MULTIVIEW_EXTENSION_NAME, true);
+
+	// maps the timestamps to the host clock of a trace (see --trace-output)
+	add_device_extension(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, true);
+}
+
+FilterSample::~FilterSample()
+{
+	if (device)
+	{
+		device->wait_idle();
+
+		destroy_filter_pipelines();
+		vkDestroyCommandPool(get_device().get_handle(), pass_command_pool, nullptr);
+		vkDestroyCommandPool(get_device().get_handle(), compute_pass_command_pool, nullptr);
+
+		vkDestroyPipeline(get_device().get_handle(), resolve_pipeline, nullptr);
+
+		vkDestroyRenderPass(get_device().get_handle(), offscreen_pass, nullptr);
+		vkDestroyRenderPass(get_device().get_handle(), half_float_pass, nullptr);
+		vkDestroyRenderPass(get_device().get_handle(), resolve_pass, nullptr);
+
+		// the views of the images go first, the images are destroyed with their pool
+		for (auto &target : targets)
+		{
+			vkDestroyFramebuffer(get_device().get_handle(), target.framebuffer, nullptr);
+			target.image_view.reset();
+			target.layer_view.reset();
+		}
+		image_pool.reset();
+
+		for (auto framebuffer : resolve_framebuffers)
+		{
+			vkDestroyFramebuffer(get_device().get_handle(), framebuffer, nullptr);
+		}
+
+		vkDestroyPipelineLayout(get_device().get_handle(), pipeline_layouts.resolve, nullptr);
+		vkDestroyPipelineLayout(get_device().get_handle(), pipeline_layouts.filter, nullptr);
+
+		vkDestroyDescriptorSetLayout(get_device().get_handle(), descriptor_set_layouts.resolve, nullptr);
+		vkDestroyDescriptorSetLayout(get_device().get_handle(), descriptor_set_layouts.filter, nullptr);
+
+		texture.image.reset();
+		vkDestroySampler(get_device().get_handle(), texture.sampler, nullptr);
+		vkDestroySampler(get_device().get_handle(), filter_sampler, nullptr);
+
+		for (size_t i = 0; i < source_complete_semaphores.size(); ++i)
+		{
+			vkDestroySemaphore(get_device().get_handle(), source_complete_semaphores[i], nullptr);
+			vkDestroySemaphore(get_device().get_handle(), compute_complete_semaphores[i], nullptr);
+		}
+		vkDestroyCommandPool(get_device().get_handle(), compute_cmd_pool, nullptr);
+		vkDestroyCommandPool(get_device().get_handle(), source_cmd_pool, nullptr);
+
+		kernel_buffer.reset();
+		half_kernel_buffer.reset();
+		timestamp_queries.reset();
+		frame_timestamp_queries.reset();
+		compute_timestamp_queries.reset();
+	}
+}
+
+void FilterSample::build_command_buffers()
+{
+	wait_active_pipelines();
+
+	// rebuilds of the frames alone, like the ones the UI requests, keep the pass commands
+	if (pass_commands_outdated)
+	{
+		// the pass commands bind the descriptor sets, which are rewritten here
+		reset_pass_commands();
+		update_descriptor_sets();
+	}
+
+	// the candidates are dispatched with the descriptor sets, the pipelines are then recreated with the tuned workgroups
+	if (tune_workgroups())
+	{
+		destroy_filter_pipelines();
+		prepare_filter_pipelines();
+		wait_active_pipelines();
+	}
+	pass_commands_outdated = false;
+
+	// offscreen the source image is drawn once and the frames only hold the filter passes
+	if (is_offscreen())
+	{
+		with_command_buffer([this](VkCommandBuffer cmd) {
+			draw_fullscreen(cmd, offscreen_pass, targets[static_cast<size_t>(FilterImage::Source)].framebuffer, get_filter_extent(),
+			                source_pipeline, pipeline_layouts.resolve, descriptor_sets.source);
+		});
+	}
+
+	record_frames();
+}
+
+void FilterSample::record_frame(uint32_t frame)
+{
+	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
+
+	bool async     = uses_async_compute();
+	bool offscreen = is_offscreen();
+
+	auto cmd = draw_cmd_buffers[frame];
+
+	// with async compute the source pass and the dispatches are recorded into their own command buffers,
+	// the draw command buffer only holds the resolve and the UI
+	VkCommandBuffer source_cmd  = async ? source_cmd_buffers[frame] : cmd;
+	VkCommandBuffer compute_cmd = async ? compute_cmd_buffers[frame] : cmd;
+
+	VK_CHECK(vkBeginCommandBuffer(source_cmd, &command_buffer_begin_info));
+
+	timestamp_queries->reset(source_cmd, frame);
+	frame_timestamp_queries->reset(source_cmd, frame);
+
+	frame_timestamp_queries->write(source_cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame, 0);
+	if (!offscreen)
+	{
+		draw_fullscreen(source_cmd, offscreen_pass, targets[static_cast<size_t>(FilterImage::Source)].framebuffer, get_filter_extent(),
+		                source_pipeline, pipeline_layouts.resolve, descriptor_sets.source);
+	}
+	frame_timestamp_queries->write(source_cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame, 1);
+
+	if (async)
+	{
+		record_ownership_transfer(source_cmd, FilterImage::Source, true, true);
+		VK_CHECK(vkEndCommandBuffer(source_cmd));
+
+		VK_CHECK(vkBeginCommandBuffer(compute_cmd, &command_buffer_begin_info));
+		compute_timestamp_queries->reset(compute_cmd, frame);
+		record_ownership_transfer(compute_cmd, FilterImage::Source, true, false);
+	}
+
+	for (uint32_t pass = 0; pass < variants[variant_id].passes.size(); ++pass)
+	{
+		record_filter_pass(compute_cmd, frame, pass);
+	}
+
+	if (async)
+	{
+		record_ownership_transfer(compute_cmd, FilterImage::Output, false, true);
+		VK_CHECK(vkEndCommandBuffer(compute_cmd));
+
+		VK_CHECK(vkBeginCommandBuffer(cmd, &command_buffer_begin_info));
+		record_ownership_transfer(cmd, FilterImage::Output, false, false);
+	}
+
+	frame_timestamp_queries->write(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame, 2);
+	if (!offscreen)
+	{
+		draw_fullscreen(cmd, resolve_pass, resolve_framebuffers[frame], {width, height}, resolve_pipeline, pipeline_layouts.resolve, descriptor_sets.resolve);
+
+		VkClearValue clear_value;
+		clear_value.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+
+		VkRenderPassBeginInfo render_pass_begin_info    = vkb::initializers::render_pass_begin_info();
+		render_pass_begin_info.renderPass               = render_pass;
+		render_pass_begin_info.framebuffer              = framebuffers[frame];
+		render_pass_begin_info.renderArea.extent.width  = width;
+		render_pass_begin_info.renderArea.extent.height = height;
+		render_pass_begin_info.clearValueCount          = 1;
+		render_pass_begin_info.pClearValues             = &clear_value;
+
+		vkCmdBeginRenderPass(cmd, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+
+		draw_ui(cmd, frame);
+
+		vkCmdEndRenderPass(cmd);
+	}
+	frame_timestamp_queries->write(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame, 3);
+
+	VK_CHECK(vkEndCommandBuffer(cmd));
+}
+
+void FilterSample::record_ownership_transfer(VkCommandBuffer cmd, FilterImage image, bool to_compute, bool release)
+{
+	// the source image is handed over to the compute queue family once drawn, the output image back once filtered.
+	// Both stay in the shader read only layout, the release and the acquire only differ in their stages and accesses
+	VkImageMemoryBarrier barrier = vkb::initializers::image_memory_barrier();
+	barrier.srcQueueFamilyIndex  = to_compute ? graphics_queue_family : compute_queue_family;
+	barrier.dstQueueFamilyIndex  = to_compute ? compute_queue_family : graphics_queue_family;
+	barrier.oldLayout            = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.newLayout            = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barrier.image                = targets[static_cast<size_t>(image)].image->get_handle();
+	barrier.subresourceRange     = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, VK_REMAINING_ARRAY_LAYERS};
+
+	VkPipelineStageFlags src_stage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+	VkPipelineStageFlags dst_stage = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+	if (release)
+	{
+		barrier.srcAccessMask = to_compute ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : VK_ACCESS_SHADER_WRITE_BIT;
+		src_stage             = to_compute ? VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT : VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	}
+	else
+	{
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		dst_stage             = to_compute ? VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT : VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+
+	vkCmdPipelineBarrier(cmd, src_stage, dst_stage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+void FilterSample::record_filter_pass(VkCommandBuffer cmd, uint32_t frame, uint32_t pass_index)
+{
+	auto           &pass          = variants[variant_id].passes[pass_index];
+	VkCommandBuffer pass_commands = get_pass_commands(frame, pass_index);
+	if (pass_commands == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	// compute passes are recorded with their barriers and timestamps, fragment passes only inside their render pass
+	if (pass.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	{
+		timestamp_queries->write(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, frame, 2 * pass_index);
+		begin_offscreen_pass(cmd, get_offscreen_pass(pass.output), targets[static_cast<size_t>(pass.output)].framebuffer, get_filter_extent(),
+		                     VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+		vkCmdExecuteCommands(cmd, 1, &pass_commands);
+		vkCmdEndRenderPass(cmd);
+		timestamp_queries->write(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, frame, 2 * pass_index + 1);
+		return;
+	}
+
+	vkCmdExecuteCommands(cmd, 1, &pass_commands);
+}
+
+VkCommandBuffer FilterSample::get_pass_commands(uint32_t frame, uint32_t pass_index)
+{
+	VkPipeline pipeline = filter_pipelines[variant_id][pass_index];
+	if (pipeline == VK_NULL_HANDLE)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	// with async compute the passes are executed by a command buffer of the compute queue family
+	bool  async    = uses_async_compute();
+	auto &passes   = variants[variant_id].passes;
+	auto &commands = pass_commands[{variant_id, async}];
+	if (commands.empty())
+	{
+		commands.resize(draw_cmd_buffers.size() * passes.size(), VK_NULL_HANDLE);
+	}
+
+	auto &cmd = commands[frame * passes.size() + pass_index];
+	if (cmd != VK_NULL_HANDLE)
+	{
+		return cmd;
+	}
+
+	auto &pass   = passes[pass_index];
+	auto &output = targets[static_cast<size_t>(pass.output)];
+
+	VkCommandBufferAllocateInfo allocate_info = vkb::initializers::command_buffer_allocate_info(async ? compute_pass_command_pool : pass_command_pool,
+	                                                                                           VK_COMMAND_BUFFER_LEVEL_SECONDARY, 1);
+	VK_CHECK(vkAllocateCommandBuffers(get_device().get_handle(), &allocate_info, &cmd));
+
+	VkCommandBufferInheritanceInfo inheritance_info = vkb::initializers::command_buffer_inheritance_info();
+	VkCommandBufferBeginInfo       begin_info       = vkb::initializers::command_buffer_begin_info();
+	begin_info.pInheritanceInfo                     = &inheritance_info;
+
+	if (pass.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	{
+		inheritance_info.renderPass  = get_offscreen_pass(pass.output);
+		inheritance_info.framebuffer = output.framebuffer;
+		begin_info.flags             = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+	}
+
+	VK_CHECK(vkBeginCommandBuffer(cmd, &begin_info));
+
+	push_constants.direction_x = pass.direction_x;
+	push_constants.direction_y = pass.direction_y;
+
+	if (pass.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+	{
+		record_fullscreen_draw(cmd, get_filter_extent(), pipeline, pipeline_layouts.filter, filter_descriptor_sets.at({pass.input, pass.output}));
+	}
+	else
+	{
+		record_dispatch(cmd, frame, pass_index, async ? compute_timestamp_queries.get() : timestamp_queries.get());
+	}
+
+	VK_CHECK(vkEndCommandBuffer(cmd));
+	return cmd;
+}
+
+void FilterSample::record_dispatch(VkCommandBuffer cmd, uint32_t frame, uint32_t pass_index, vkb::TimestampQueryRing *queries)
+{
+	std::function<void(VkPipelineStageFlagBits)> write_timestamp;
+	if (queries)
+	{
+		write_timestamp = [&](VkPipelineStageFlagBits stage) {
+			queries->write(cmd, stage, frame, stage == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT ? 2 * pass_index : 2 * pass_index + 1);
+		};
+	}
+
+	record_dispatch(cmd, variants[variant_id].passes[pass_index], filter_pipelines[variant_id][pass_index],
+	                workgroup_configs[variant_id][pass_index], write_timestamp);
+}
+
+void FilterSample::record_dispatch(VkCommandBuffer cmd, const FilterPass &pass, VkPipeline pipeline, const vkb::WorkgroupConfig &workgroup,
+                                   const std::function<void(VkPipelineStageFlagBits)> &write_timestamp)
+{
+	auto           &output         = targets[static_cast<size_t>(pass.output)];
+	VkDescriptorSet descriptor_set = filter_descriptor_sets.at({pass.input, pass.output});
+
+	VkImageMemoryBarrier barrier = vkb::initializers::image_memory_barrier();
+	barrier.srcQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
+	barrier.dstQueueFamilyIndex  = VK_QUEUE_FAMILY_IGNORED;
+	barrier.srcAccessMask        = VK_ACCESS_NONE;
+	barrier.dstAccessMask        = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.oldLayout            = VK_IMAGE_LAYOUT_UNDEFINED;
+	barrier.newLayout            = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.image                = output.image->get_handle();
+	barrier.subresourceRange     = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, VK_REMAINING_ARRAY_LAYERS};
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+	                     0, 0, nullptr, 0, nullptr, 1, &barrier);
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layouts.filter, 0, 1, &descriptor_set, 0, nullptr);
+	vkCmdPushConstants(cmd, pipeline_layouts.filter, VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+	                   0, sizeof(push_constants), &push_constants);
+
+	VkExtent2D extent = get_filter_extent();
+	VkExtent2D tile   = workgroup.get_tile_extent();
+	tile.width *= pass.texels_per_invocation.width;
+	tile.height *= pass.texels_per_invocation.height;
+	uint32_t x_size = (extent.width + tile.width - 1) / tile.width;
+	uint32_t y_size = (extent.height + tile.height - 1) / tile.height;
+
+	if (write_timestamp)
+	{
+		write_timestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	vkCmdDispatch(cmd, x_size, y_size, get_batch_size());
+	if (write_timestamp)
+	{
+		write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	}
+
+	barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	barrier.oldLayout     = VK_IMAGE_LAYOUT_GENERAL;
+	barrier.newLayout     = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	// a compute queue family has no fragment stage, the output image is then read by the graphics queue after its acquire
+	VkPipelineStageFlags dst_stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	if (!uses_async_compute())
+	{
+		dst_stages |= VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+	}
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, dst_stages, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> FilterSample::profile_variant_passes()
+{
+	std::vector<ProfiledPass> profiled_passes;
+	for (uint32_t i = 0; i < variants[variant_id].passes.size(); ++i)
+	{
+		auto &pass   = variants[variant_id].passes[i];
+		auto  record = [this, &pass, i](VkCommandBuffer cmd) {
+			push_constants.direction_x = pass.direction_x;
+			push_constants.direction_y = pass.direction_y;
+
+			if (pass.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+			{
+				draw_fullscreen(cmd, get_offscreen_pass(pass.output), targets[static_cast<size_t>(pass.output)].framebuffer, get_filter_extent(),
+				                filter_pipelines[variant_id][i], pipeline_layouts.filter, filter_descriptor_sets.at({pass.input, pass.output}));
+			}
+			else
+			{
+				record_dispatch(cmd, 0, i, nullptr);
+			}
+		};
+		profiled_passes.push_back({pass.name, record});
+	}
+	return profile_passes(profiled_passes);
+}
+
+void FilterSample::setup_pass_command_pool()
+{
+	// separate from the pool of the frames, which is reset whenever they are rebuilt
+	VkCommandPoolCreateInfo command_pool_info = {};
+	command_pool_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	command_pool_info.queueFamilyIndex        = graphics_queue_family;
+	VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_info, nullptr, &pass_command_pool));
+
+	// secondary command buffers are executed by primary ones of the same queue family
+	if (async_compute_supported)
+	{
+		command_pool_info.queueFamilyIndex = compute_queue_family;
+		VK_CHECK(vkCreateCommandPool(get_device().get_handle(), &command_pool_info, nullptr, &compute_pass_command_pool));
+	}
+}
+
+void FilterSample::reset_pass_commands()
+{
+	// only called once the frames using them have completed
+	if (pass_command_pool == VK_NULL_HANDLE)
+	{
+		return;
+	}
+
+	for (auto &commands : pass_commands)
+	{
+		VkCommandPool pool = commands.first.second ? compute_pass_command_pool : pass_command_pool;
+		for (auto cmd : commands.second)
+		{
+			if (cmd != VK_NULL_HANDLE)
+			{
+				vkFreeCommandBuffers(get_device().get_handle(), pool, 1, &cmd);
+			}
+		}
+	}
+	pass_commands.clear();
+}
+
+void FilterSample::select_variant(size_t id, bool async)
+{
+	// the variants alias their images and async compute hands them over to another queue family, so the frames of the
+	// previous variant complete before the first frame of the new one is submitted if it uses other images or queues
+	bool previous_async = uses_async_compute();
+	bool same_images    = true;
+	for (auto image : {FilterImage::Intermediate, FilterImage::Accumulation})
+	{
+		same_images = same_images && uses_image(variants[id], image) == uses_image(variants[variant_id], image);
+	}
+
+	variant_id    = id;
+	async_compute = async;
+	if (!same_images || uses_async_compute() != previous_async)
+	{
+		wait_for_draw_cmd_buffers();
+	}
+
+	wait_active_pipelines();
+	reset_timings();
+
+	// every frame is re-recorded from the pass commands of the variant once its previous submission completed,
+	// instead of waiting for all frames and recording all of them at once
+	invalidate_frames();
+}
+
+void FilterSample::begin_offscreen_pass(VkCommandBuffer cmd, VkRenderPass render_pass, VkFramebuffer framebuffer, const VkExtent2D &extent,
+                                        VkSubpassContents contents)
+{
+	VkClearValue clear_value;
+	clear_value.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+
+	VkRenderPassBeginInfo render_pass_begin_info = vkb::initializers::render_pass_begin_info();
+	render_pass_begin_info.renderPass            = render_pass;
+	render_pass_begin_info.framebuffer           = framebuffer;
+	render_pass_begin_info.renderArea.extent     = extent;
+	render_pass_begin_info.clearValueCount       = 1;
+	render_pass_begin_info.pClearValues          = &clear_value;
+
+	vkCmdBeginRenderPass(cmd, &render_pass_begin_info, contents);
+}
+
+void FilterSample::record_fullscreen_draw(VkCommandBuffer cmd, const VkExtent2D &extent, VkPipeline pipeline, VkPipelineLayout layout, VkDescriptorSet descriptor_set)
+{
+	VkViewport viewport = vkb::initializers::viewport(static_cast<float>(extent.width), static_cast<float>(extent.height), 0.0f, 1.0f);
+	vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+	VkRect2D scissor = vkb::initializers::rect2D(extent.width, extent.height, 0, 0);
+	vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, layout, 0, 1, &descriptor_set, 0, nullptr);
+
+	if (layout == pipeline_layouts.filter)
+	{
+		vkCmdPushConstants(cmd, layout, VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT,
+		                   0, sizeof(push_constants), &push_constants);
+	}
+
+	vkCmdDraw(cmd, 3, 1, 0, 0);
+}
+
+void FilterSample::draw_fullscreen(VkCommandBuffer cmd, VkRenderPass render_pass, VkFramebuffer framebuffer, const VkExtent2D &extent,
+                                   VkPipeline pipeline, VkPipelineLayout layout, VkDescriptorSet descriptor_set)
+{
+	begin_offscreen_pass(cmd, render_pass, framebuffer, extent, VK_SUBPASS_CONTENTS_INLINE);
+	record_fullscreen_draw(cmd, extent, pipeline, layout, descriptor_set);
+	vkCmdEndRenderPass(cmd);
+}
+
+void FilterSample::render(float delta_time)
+{
+	if (!prepared)
+	{
+		return;
+	}
+	update_configuration();
+	ApiVulkanSample::prepare_frame();
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
+
+	wait_for_frame_fence();
+	get_frame_time();
+
+	update_current_frame();
+
+	if (!uses_async_compute())
+	{
+		VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, wait_fences[current_buffer]));
+	}
+	else
+	{
+		// source pass on the graphics queue
+		VkSubmitInfo source_submit_info         = vkb::initializers::submit_info();
+		source_submit_info.commandBufferCount   = 1;
+		source_submit_info.pCommandBuffers      = &source_cmd_buffers[current_buffer];
+		source_submit_info.signalSemaphoreCount = 1;
+		source_submit_info.pSignalSemaphores    = &source_complete_semaphores[current_buffer];
+		VK_CHECK(vkQueueSubmit(queue, 1, &source_submit_info, VK_NULL_HANDLE));
+
+		// filter passes on the compute queue
+		VkPipelineStageFlags compute_wait_stage  = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		VkSubmitInfo         compute_submit_info = vkb::initializers::submit_info();
+		compute_submit_info.waitSemaphoreCount   = 1;
+		compute_submit_info.pWaitSemaphores      = &source_complete_semaphores[current_buffer];
+		compute_submit_info.pWaitDstStageMask    = &compute_wait_stage;
+		compute_submit_info.commandBufferCount   = 1;
+		compute_submit_info.pCommandBuffers      = &compute_cmd_buffers[current_buffer];
+		compute_submit_info.signalSemaphoreCount = 1;
+		compute_submit_info.pSignalSemaphores    = &compute_complete_semaphores[current_buffer];
+		VK_CHECK(vkQueueSubmit(compute_queue, 1, &compute_submit_info, VK_NULL_HANDLE));
+
+		// resolve and UI on the graphics queue. Waiting on all commands also keeps the source pass
+		// of the following frames from overwriting the source image while the dispatches read it
+		std::vector<VkSemaphore>          wait_semaphores = {compute_complete_semaphores[current_buffer]};
+		std::vector<VkPipelineStageFlags> wait_stages     = {VK_PIPELINE_STAGE_ALL_COMMANDS_BIT};
+		if (render_context->has_swapchain())
+		{
+			wait_semaphores.push_back(semaphores.acquired_image_ready);
+			wait_stages.push_back(submit_pipeline_stages);
+		}
+
+		VkSubmitInfo resolve_submit_info       = submit_info;
+		resolve_submit_info.waitSemaphoreCount = vkb::to_u32(wait_semaphores.size());
+		resolve_submit_info.pWaitSemaphores    = wait_semaphores.data();
+		resolve_submit_info.pWaitDstStageMask  = wait_stages.data();
+		VK_CHECK(vkQueueSubmit(queue, 1, &resolve_submit_info, wait_fences[current_buffer]));
+
+		compute_timestamp_queries->submitted(current_buffer);
+	}
+	timestamp_queries->submitted(current_buffer);
+	frame_timestamp_queries->submitted(current_buffer);
+	ApiVulkanSample::submit_frame();
+}
+
+bool FilterSample::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!VulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	depth_format = vkb::get_suitable_depth_format(device->get_gpu().get_handle());
+
+	check_half_float_support();
+	async_compute_supported = check_async_compute_support();
+
+	multiview_supported = multiview_supported && get_device().is_enabled(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+	if (multiview_supported)
+	{
+		VkPhysicalDeviceMultiviewPropertiesKHR multiview_properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_PROPERTIES_KHR};
+		VkPhysicalDeviceProperties2KHR         properties{VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR};
+		properties.pNext = &multiview_properties;
+		vkGetPhysicalDeviceProperties2KHR(get_device().get_gpu().get_handle(), &properties);
+
+		// the view mask of a subpass has a bit per layer
+		max_batch_size = std::min({multiview_properties.maxMultiviewViewCount, properties.properties.limits.maxImageArrayLayers, 32u});
+	}
+
+	variants = get_filter_variants();
+	assert(!variants.empty());
+
+	// the accumulation image has two layers per image of the batch
+	if (std::any_of(variants.begin(), variants.end(), [this](const FilterVariant &variant) { return uses_image(variant, FilterImage::Accumulation); }))
+	{
+		max_batch_size = std::min(max_batch_size, get_device().get_gpu().get_properties().limits.maxImageArrayLayers / 2);
+	}
+
+	check_batch_size();
+
+	submit_info                   = vkb::initializers::submit_info();
+	submit_info.pWaitDstStageMask = &submit_pipeline_stages;
+
+	if (render_context->has_swapchain())
+	{
+		submit_info.waitSemaphoreCount   = 1;
+		submit_info.pWaitSemaphores      = &semaphores.acquired_image_ready;
+		submit_info.signalSemaphoreCount = 1;
+		submit_info.pSignalSemaphores    = &semaphores.render_complete;
+	}
+
+	queue = device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT, 0).get_handle();
+
+	use_wait_fences = true;
+
+	width  = get_render_context().get_surface_extent().width;
+	height = get_render_context().get_surface_extent().height;
+
+	create_swapchain_buffers();
+	setup_images();
+	create_command_pool();
+	create_command_buffers();
+	create_synchronization_primitives();
+	setup_async_compute();
+	setup_pass_command_pool();
+	setup_depth_stencil();
+	setup_render_pass();
+	create_pipeline_cache();
+	setup_framebuffer();
+
+	prepare_gui();
+
+	update_extent_push_constants();
+
+	texture = load_texture(texture_path.data(), vkb::sg::Image::Color);
+
+	kernel_buffer = std::make_unique<vkb::core::Buffer>(get_device(), kernel_buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+	                                                    VMA_MEMORY_USAGE_CPU_TO_GPU);
+	if (half_float_storage_supported)
+	{
+		half_kernel_buffer = std::make_unique<vkb::core::Buffer>(get_device(), half_kernel_buffer_size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+		                                                         VMA_MEMORY_USAGE_CPU_TO_GPU);
+	}
+
+	setup_sampler();
+	setup_query_pool();
+	setup_descriptor_set_layouts();
+
+	workgroup_tuner = std::make_unique<vkb::WorkgroupTuner>(get_device());
+
+	// the filter pipelines are created for the radius of the kernel
+	vkb::Timer pipeline_timer;
+	pipeline_timer.start();
+	prepare_pipelines();
+	setup_descriptor_pool();
+	setup_descriptor_sets();
+	set_kernel_radius(kernel_radius);
+	wait_active_pipelines();
+	log_pipeline_creation_time(pipeline_timer.stop<vkb::Timer::Milliseconds>());
+	build_command_buffers();
+	insert_configurations(get_configuration());
+	prepared = true;
+	return true;
+}
+
+void FilterSample::on_update_ui_overlay(vkb::Drawer &drawer)
+{
+	auto &variant = variants[variant_id];
+
+	if (drawer.header("Select shader"))
+	{
+		// only the variants available for the kernel and the precision can be selected
+		std::vector<std::string> names;
+		std::vector<size_t>      indices;
+		int32_t                  current = 0;
+		for (size_t i = 0; i < variants.size(); ++i)
+		{
+			if (is_available(i))
+			{
+				if (i == variant_id)
+				{
+					current = static_cast<int32_t>(names.size());
+				}
+				names.push_back(variants[i].name);
+				indices.push_back(i);
+			}
+		}
+
+		if (drawer.combo_box("type", &current, names))
+		{
+			select_variant(indices[current], async_compute);
+		}
+
+		if (half_float_supported && variant.supports_half_precision)
+		{
+			int32_t precision_index = static_cast<int32_t>(precision);
+			if (drawer.combo_box("precision", &precision_index, {"fp32", "fp16", "fp16, fp16 intermediate"}))
+			{
+				set_precision(static_cast<FilterPrecision>(precision_index));
+			}
+		}
+
+		bool async = async_compute;
+		if (async_compute_supported && !is_offscreen() && drawer.checkbox("async compute", &async))
+		{
+			select_variant(variant_id, async);
+		}
+	}
+
+	if (drawer.header("Kernel"))
+	{
+		int32_t radius  = static_cast<int32_t>(kernel_radius);
+		bool    changed = drawer.slider_int("radius", &radius, 0, static_cast<int32_t>(vkb::FilterKernel::max_radius));
+		changed |= on_update_kernel_ui(drawer);
+		drawer.text("%s %ux%u, %s", kernel->get_name().c_str(), kernel->get_size(), kernel->get_size(),
+		            kernel->is_separable() ? "separable" : "non-separable");
+
+		if (changed)
+		{
+			set_kernel_radius(static_cast<uint32_t>(radius));
+		}
+	}
+
+	auto &passes = variants[variant_id].passes;
+
+	if (drawer.header("Frametime"))
+	{
+		double total = 0.0;
+		for (size_t i = 0; i < passes.size(); ++i)
+		{
+			drawer.text("%s: %lf ms", passes[i].name.c_str(), pass_timings[i].last());
+			total += pass_timings[i].last();
+		}
+		if (passes.size() > 1)
+		{
+			drawer.text("total: %lf ms", total);
+		}
+		if (get_batch_size() > 1)
+		{
+			drawer.text("batch of %u images: %lf ms per image", get_batch_size(), total / get_batch_size());
+		}
+		drawer.text("frame: %lf ms", frame_timings.last());
+	}
+
+	if (drawer.header("Statistics"))
+	{
+		uint64_t outliers = 0;
+		for (size_t i = 0; i < passes.size(); ++i)
+		{
+			outliers += pass_timings[i].get_outlier_count();
+		}
+		drawer.text("%zu frames, %llu outliers", pass_timings[0].size(), static_cast<unsigned long long>(outliers));
+
+		for (size_t i = 0; i < passes.size(); ++i)
+		{
+			drawer.timing_statistics(passes[i].name.c_str(), pass_timings[i]);
+		}
+		drawer.timing_statistics("frame", frame_timings);
+
+		if (uses_async_compute())
+		{
+			drawer.timing_statistics("graphics busy", graphics_busy_timings);
+			drawer.timing_statistics("compute busy", compute_busy_timings);
+			if (measures_queue_overlap())
+			{
+				drawer.timing_statistics("queue overlap", queue_overlap_timings);
+			}
+			else
+			{
+				drawer.text("queue overlap: requires VK_EXT_calibrated_timestamps");
+			}
+		}
+	}
+
+	if (drawer.header("Memory"))
+	{
+		drawer.text("images used: %.1f MB\n"
+		            "allocated: %.1f MB (%.1f MB without aliasing)",
+		            to_megabytes(image_pool->get_variant_size(vkb::to_u32(variant_id))),
+		            to_megabytes(image_pool->get_allocated_size()), to_megabytes(image_pool->get_requested_size()));
+	}
+
+	update_variant_time();
+	if (drawer.header("Comparison"))
+	{
+		draw_variant_comparison(drawer);
+	}
+
+	apply_ui_changes(drawer);
+}
+
+void FilterSample::update_variant_time()
+{
+	if (pass_timings.empty() || pass_timings[0].size() == 0)
+	{
+		return;
+	}
+
+	double time = 0.0;
+	for (size_t i = 0; i < variants[variant_id].passes.size(); ++i)
+	{
+		time += pass_timings[i].get_summary().median;
+	}
+	variant_times[{variant_id, uses_async_compute()}] = time;
+}
+
+void FilterSample::draw_variant_comparison(vkb::Drawer &drawer)
+{
+	// relative to the fastest variant made of fragment passes only, the baseline the compute variants have to beat
+	double fragment_time = 0.0;
+	for (auto &variant_time : variant_times)
+	{
+		auto &passes        = variants[variant_time.first.first].passes;
+		bool  fragment_only = std::none_of(passes.begin(), passes.end(), [](const FilterPass &pass) { return pass.bind_point == VK_PIPELINE_BIND_POINT_COMPUTE; });
+		if (fragment_only && (fragment_time == 0.0 || variant_time.second < fragment_time))
+		{
+			fragment_time = variant_time.second;
+		}
+	}
+
+	if (variant_times.empty())
+	{
+		drawer.text("select the variants to compare them");
+		return;
+	}
+
+	for (auto &variant_time : variant_times)
+	{
+		std::string name = variants[variant_time.first.first].name + (variant_time.first.second ? " async" : "");
+		if (fragment_time > 0.0)
+		{
+			drawer.text("%s: %lf ms (%.2fx the fragment path)", name.c_str(), variant_time.second, variant_time.second / fragment_time);
+		}
+		else
+		{
+			drawer.text("%s: %lf ms", name.c_str(), variant_time.second);
+		}
+	}
+}
+
+bool FilterSample::on_update_kernel_ui(vkb::Drawer &drawer)
+{
+	return false;
+}
+
+bool FilterSample::resize(uint32_t _width, uint32_t _height)
+{
+	if (!prepared)
+	{
+		return false;
+	}
+
+	get_render_context().handle_surface_changes();
+
+	// Don't recreate the swapchain if the dimensions haven't changed
+	if (width == get_render_context().get_surface_extent().width && height == get_render_context().get_surface_extent().height)
+	{
+		return false;
+	}
+
+	width  = get_render_context().get_surface_extent().width;
+	height = get_render_context().get_surface_extent().height;
+
+	prepared = false;
+
+	// Ensure all operations on the device have been finished before destroying resources
+	device->wait_idle();
+
+	create_swapchain_buffers();
+	setup_images();
+
+	// Recreate the frame buffers
+	vkDestroyImageView(device->get_handle(), depth_stencil.view, nullptr);
+	vkDestroyImage(device->get_handle(), depth_stencil.image, nullptr);
+	vkFreeMemory(device->get_handle(), depth_stencil.mem, nullptr);
+	setup_depth_stencil();
+
+	setup_framebuffer();
+	update_extent_push_constants();
+
+	if ((width > 0.0f) && (height > 0.0f))
+	{
+		if (gui)
+		{
+			gui->resize(width, height);
+		}
+	}
+
+	reset_timings();
+
+	rebuild_command_buffers();
+
+	device->wait_idle();
+
+	// Notify derived class
+	view_changed();
+
+	prepared = true;
+	return true;
+}
+
+void FilterSample::setup_framebuffer()
+{
+	// the pass commands of the fragment passes inherit the framebuffers
+	pass_commands_outdated = true;
+
+	VkImageView attachment;
+
+	VkFramebufferCreateInfo framebuffer_create_info = {};
+	framebuffer_create_info.sType                   = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+	framebuffer_create_info.attachmentCount         = 1;
+	framebuffer_create_info.pAttachments            = &attachment;
+	framebuffer_create_info.width                   = get_render_context().get_surface_extent().width;
+	framebuffer_create_info.height                  = get_render_context().get_surface_extent().height;
+	framebuffer_create_info.layers                  = 1;
+
+	// present (gui) and resolve framebuffers for every swapchain image
+	for (uint32_t i = 0; i < framebuffers.size(); i++)
+	{
+		vkDestroyFramebuffer(device->get_handle(), framebuffers[i], nullptr);
+		vkDestroyFramebuffer(device->get_handle(), resolve_framebuffers[i], nullptr);
+	}
+
+	framebuffers.resize(render_context->get_render_frames().size());
+	resolve_framebuffers.resize(framebuffers.size());
+	for (uint32_t i = 0; i < framebuffers.size(); i++)
+	{
+		attachment                         = swapchain_buffers[i].view;
+		framebuffer_create_info.renderPass = render_pass;
+		VK_CHECK(vkCreateFramebuffer(device->get_handle(), &framebuffer_create_info, nullptr, &framebuffers[i]));
+		framebuffer_create_info.renderPass = resolve_pass;
+		VK_CHECK(vkCreateFramebuffer(device->get_handle(), &framebuffer_create_info, nullptr, &resolve_framebuffers[i]));
+	}
+
+	// source, intermediate and output framebuffers, at the processing resolution. The accumulation image is only
+	// written by compute passes, and the images no variant uses have no framebuffer
+	framebuffer_create_info.width  = get_filter_extent().width;
+	framebuffer_create_info.height = get_filter_extent().height;
+	for (size_t i = 0; i < targets.size(); ++i)
+	{
+		auto &target = targets[i];
+		vkDestroyFramebuffer(device->get_handle(), target.framebuffer, nullptr);
+		target.framebuffer = VK_NULL_HANDLE;
+		if (!target.image || static_cast<FilterImage>(i) == FilterImage::Accumulation)
+		{
+			continue;
+		}
+
+		attachment                         = target.image_view->get_handle();
+		framebuffer_create_info.renderPass = get_offscreen_pass(static_cast<FilterImage>(i));
+		VK_CHECK(vkCreateFramebuffer(device->get_handle(), &framebuffer_create_info, nullptr, &target.framebuffer));
+	}
+}
+
+void FilterSample::setup_render_pass()
+{
+	VkAttachmentDescription attachment = {};
+	attachment.samples                 = VK_SAMPLE_COUNT_1_BIT;
+	attachment.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
+	attachment.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachment.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+	VkAttachmentReference color_reference = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+	VkSubpassDescription subpass_description = {};
+	subpass_description.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass_description.colorAttachmentCount = 1;
+	subpass_description.pColorAttachments    = &color_reference;
+
+	VkRenderPassCreateInfo render_pass_create_info = {};
+	render_pass_create_info.sType                  = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	render_pass_create_info.attachmentCount        = 1;
+	render_pass_create_info.pAttachments           = &attachment;
+	render_pass_create_info.subpassCount           = 1;
+	render_pass_create_info.pSubpasses             = &subpass_description;
+
+	// present render pass (gui render pass)
+	{
+		attachment.format        = render_context->get_format();
+		attachment.loadOp        = VK_ATTACHMENT_LOAD_OP_LOAD;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		attachment.finalLayout   = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+
+		VkSubpassDependency dependency = {};
+		dependency.srcSubpass          = 0;
+		dependency.dstSubpass          = VK_SUBPASS_EXTERNAL;
+		dependency.srcStageMask        = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependency.dstStageMask        = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
+		dependency.srcAccessMask       = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependency.dstAccessMask       = VK_ACCESS_MEMORY_READ_BIT;
+		dependency.dependencyFlags     = VK_DEPENDENCY_BY_REGION_BIT;
+
+		render_pass_create_info.dependencyCount = 1;
+		render_pass_create_info.pDependencies   = &dependency;
+
+		VK_CHECK(vkCreateRenderPass(device->get_handle(), &render_pass_create_info, nullptr, &render_pass));
+	}
+
+	// resolve pass, draws the output image to the swapchain
+	{
+		attachment.format        = render_context->get_format();
+		attachment.loadOp        = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		attachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		attachment.finalLayout   = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		render_pass_create_info.dependencyCount = 0;
+		render_pass_create_info.pDependencies   = nullptr;
+
+		VK_CHECK(vkCreateRenderPass(device->get_handle(), &render_pass_create_info, nullptr, &resolve_pass));
+	}
+
+	setup_offscreen_passes();
+}
+
+void FilterSample::setup_offscreen_passes()
+{
+	vkDestroyRenderPass(device->get_handle(), offscreen_pass, nullptr);
+	vkDestroyRenderPass(device->get_handle(), half_float_pass, nullptr);
+
+	VkAttachmentDescription attachment = {};
+	attachment.format                  = filter_format;
+	attachment.samples                 = VK_SAMPLE_COUNT_1_BIT;
+	attachment.loadOp                  = VK_ATTACHMENT_LOAD_OP_CLEAR;
+	attachment.storeOp                 = VK_ATTACHMENT_STORE_OP_STORE;
+	attachment.stencilLoadOp           = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+	attachment.stencilStoreOp          = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+	attachment.initialLayout           = VK_IMAGE_LAYOUT_UNDEFINED;
+	attachment.finalLayout             = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	VkAttachmentReference color_reference = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+
+	VkSubpassDescription subpass_description = {};
+	subpass_description.pipelineBindPoint    = VK_PIPELINE_BIND_POINT_GRAPHICS;
+	subpass_description.colorAttachmentCount = 1;
+	subpass_description.pColorAttachments    = &color_reference;
+
+	std::array<VkSubpassDependency, 2> dependencies = {};
+
+	// the image may still be read by the previous frame
+	dependencies[0].srcSubpass    = VK_SUBPASS_EXTERNAL;
+	dependencies[0].dstSubpass    = 0;
+	dependencies[0].srcStageMask  = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	dependencies[0].dstStageMask  = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[0].srcAccessMask = VK_ACCESS_NONE;
+	dependencies[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+
+	// the next pass samples the image, either from a fragment or a compute shader
+	dependencies[1].srcSubpass      = 0;
+	dependencies[1].dstSubpass      = VK_SUBPASS_EXTERNAL;
+	dependencies[1].srcStageMask    = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+	dependencies[1].dstStageMask    = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+	dependencies[1].srcAccessMask   = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+	dependencies[1].dstAccessMask   = VK_ACCESS_SHADER_READ_BIT;
+	dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+
+	VkRenderPassCreateInfo render_pass_create_info = {};
+	render_pass_create_info.sType                  = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+	render_pass_create_info.attachmentCount        = 1;
+	render_pass_create_info.pAttachments           = &attachment;
+	render_pass_create_info.subpassCount           = 1;
+	render_pass_create_info.pSubpasses             = &subpass_description;
+	render_pass_create_info.dependencyCount        = vkb::to_u32(dependencies.size());
+	render_pass_create_info.pDependencies          = dependencies.data();
+
+	// a batch of images is drawn with a view per layer, a single image without multiview
+	uint32_t view_mask = get_batch_size() >= 32 ? ~0u : (1u << get_batch_size()) - 1;
+
+	VkRenderPassMultiviewCreateInfoKHR multiview_create_info{VK_STRUCTURE_TYPE_RENDER_PASS_MULTIVIEW_CREATE_INFO_KHR};
+	multiview_create_info.subpassCount = 1;
+	multiview_create_info.pViewMasks   = &view_mask;
+	if (get_batch_size() > 1)
+	{
+		render_pass_create_info.pNext = &multiview_create_info;
+	}
+
+	VK_CHECK(vkCreateRenderPass(device->get_handle(), &render_pass_create_info, nullptr, &offscreen_pass));
+
+	attachment.format = half_float_format;
+	VK_CHECK(vkCreateRenderPass(device->get_handle(), &render_pass_create_info, nullptr, &half_float_pass));
+}
+
+void FilterSample::request_gpu_features(vkb::PhysicalDevice &gpu)
+{
+	FilterBenchmarkSample::request_gpu_features(gpu);
+
+	uint32_t extension_count = 0;
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu.get_handle(), nullptr, &extension_count, nullptr));
+	std::vector<VkExtensionProperties> extensions(extension_count);
+	VK_CHECK(vkEnumerateDeviceExtensionProperties(gpu.get_handle(), nullptr, &extension_count, extensions.data()));
+
+	auto has_extension = [&extensions](const char *name) {
+		return std::any_of(extensions.begin(), extensions.end(), [name](const VkExtensionProperties &extension) {
+			return std::strcmp(extension.extensionName, name) == 0;
+		});
+	};
+
+	// invocations of the passes, reported next to their times
+	if (gpu.get_features().pipelineStatisticsQuery)
+	{
+		gpu.get_mutable_requested_features().pipelineStatisticsQuery = VK_TRUE;
+	}
+
+	if (has_extension(VK_KHR_MULTIVIEW_EXTENSION_NAME))
+	{
+		auto &multiview_features = gpu.request_extension_features<VkPhysicalDeviceMultiviewFeaturesKHR>(VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MULTIVIEW_FEATURES_KHR);
+		multiview_supported      = multiview_features.multiview;
+
+		// only the fragment passes are drawn with multiview
+		multiview_features.multiviewGeometryShader     = VK_FALSE;
+		multiview_features.multiviewTessellationShader = VK_FALSE;
+	}
+}
+
+std::vector<vkb::BenchmarkTarget::Variant> FilterSample::get_benchmark_variants() const
+{
+	std::vector<Variant> benchmark_variants;
+	for (auto &configuration : get_benchmark_configurations())
+	{
+		uint32_t size = 2 * configuration.radius + 1;
+		std::string name = variants[configuration.variant_id].name + precision_suffixes[static_cast<size_t>(configuration.precision)];
+		if (configuration.async_compute)
+		{
+			name += "_ASYNC";
+		}
+		benchmark_variants.push_back({name, fmt::format("{0}x{0}", size)});
+	}
+	return benchmark_variants;
+}
+
+void FilterSample::set_benchmark_variant(size_t index)
+{
+	auto configuration = get_benchmark_configurations()[index];
+
+	// sweeping the variants of a kernel only switches between their pre-recorded passes
+	if (precision == configuration.precision && kernel_radius == configuration.radius)
+	{
+		select_variant(configuration.variant_id, configuration.async_compute);
+		return;
+	}
+
+	// both wait for the device, the variant is selected again in case one of them fell back to another variant
+	variant_id    = configuration.variant_id;
+	async_compute = configuration.async_compute;
+	if (precision != configuration.precision)
+	{
+		set_precision(configuration.precision);
+	}
+
+	if (kernel_radius != configuration.radius)
+	{
+		set_kernel_radius(configuration.radius);
+	}
+	variant_id = configuration.variant_id;
+
+	reset_timings();
+
+	rebuild_command_buffers();
+}
+
+std::vector<vkb::BenchmarkTarget::PassTime> FilterSample::get_benchmark_pass_times()
+{
+	// every pass of a frame is pushed at once
+	auto &passes = variants[variant_id].passes;
+	if (passes.empty() || !has_new_timings(pass_timings[0]))
+	{
+		return {};
+	}
+
+	std::vector<PassTime> pass_times;
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		pass_times.push_back({passes[i].name, pass_timings[i].last()});
+	}
+
+	// with async compute the passes overlap with the graphics work, so the frame is what they are compared by
+	if (uses_async_compute())
+	{
+		pass_times.push_back({"frame", frame_timings.last()});
+	}
+	return pass_times;
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> FilterSample::finish_benchmark_variant()
+{
+	double time = 0.0;
+	for (size_t i = 0; i < variants[variant_id].passes.size(); ++i)
+	{
+		time += pass_timings[i].get_summary().median;
+	}
+
+	// the passes filter every image of the batch
+	std::vector<Metric> metrics;
+	if (time > 0.0)
+	{
+		metrics.push_back({"images_per_s", get_batch_size() * 1000.0 / time});
+		metrics.push_back({"ms_per_image", time / get_batch_size()});
+		variant_times[{variant_id, uses_async_compute()}] = time;
+	}
+
+	// memory of the images the variant uses, the intermediate and accumulation images only count for the variants using them
+	metrics.push_back({"image_memory_mb", to_megabytes(image_pool->get_variant_size(vkb::to_u32(variant_id)))});
+
+	auto kernel_metrics = get_kernel_metrics(kernel_radius);
+	metrics.insert(metrics.end(), kernel_metrics.begin(), kernel_metrics.end());
+
+	// the async variants run the same passes as their full precision variant, with the source image owned by the
+	// compute queue family, so they report how busy each queue was instead, and with calibrated timestamps how long
+	// both were busy at once. Medians over the last frames of the variant, the overlap is often zero and would not converge as a pass time
+	if (uses_async_compute())
+	{
+		metrics.push_back({"graphics_busy", graphics_busy_timings.get_summary().median});
+		metrics.push_back({"compute_busy", compute_busy_timings.get_summary().median});
+		if (measures_queue_overlap())
+		{
+			metrics.push_back({"queue_overlap", queue_overlap_timings.get_summary().median});
+		}
+		return metrics;
+	}
+
+	// pipeline statistics and performance counters of every pass, to attribute the differences between variants
+	auto statistics = profile_variant_passes();
+	metrics.insert(metrics.end(), statistics.begin(), statistics.end());
+
+	// without half precision variants there is nothing to compare
+	if (!half_float_supported)
+	{
+		return metrics;
+	}
+
+	// the configurations of each precision directly follow their full precision configuration
+	auto errors = compare_to_full_precision(fmt::format("{}_r{}", variants[variant_id].name, kernel_radius), precision != FilterPrecision::Full, time);
+	metrics.insert(metrics.end(), errors.begin(), errors.end());
+	return metrics;
+}
+
+uint32_t FilterSample::get_max_batch_size()
+{
+	return max_batch_size;
+}
+
+void FilterSample::on_batch_size_changed()
+{
+	variant_times.clear();
+
+	// the offscreen passes have a view per layer, so the images, their framebuffers
+	// and the pipelines drawing into them are recreated
+	setup_offscreen_passes();
+	setup_images();
+	setup_framebuffer();
+
+	destroy_filter_pipelines();
+	prepare_filter_pipelines();
+}
+
+void FilterSample::set_kernel_radius(uint32_t radius)
+{
+	// the kernel buffer and the pipelines may still be in use
+	if (prepared)
+	{
+		device->wait_idle();
+	}
+
+	std::vector<bool> available(variants.size());
+	for (size_t i = 0; kernel && i < variants.size(); ++i)
+	{
+		available[i] = is_available(i);
+	}
+	bool same_radius = kernel && kernel_radius == radius;
+
+	kernel_radius             = radius;
+	kernel                    = std::make_unique<vkb::FilterKernel>(create_kernel(radius));
+	push_constants.parameters = get_filter_parameters(radius);
+
+	update_kernel_buffer();
+
+	// the pipelines only depend on the radius and on which variants are available, other parameters
+	// of the kernel only change its weights and the push constants the pass commands are recorded with
+	bool same_variants = true;
+	for (size_t i = 0; i < variants.size(); ++i)
+	{
+		same_variants = same_variants && available[i] == is_available(i);
+	}
+	if (same_radius && same_variants)
+	{
+		pass_commands_outdated = true;
+	}
+	else
+	{
+		destroy_filter_pipelines();
+		prepare_filter_pipelines();
+	}
+
+	select_available_variant();
+
+	variant_times.clear();
+	reset_timings();
+
+	if (prepared)
+	{
+		rebuild_command_buffers();
+	}
+}
+
+void FilterSample::set_precision(FilterPrecision filter_precision)
+{
+	// the images and the pipelines may still be in use
+	if (prepared)
+	{
+		device->wait_idle();
+	}
+
+	precision = filter_precision;
+
+	// the intermediate image changes its format
+	setup_images();
+	setup_framebuffer();
+
+	destroy_filter_pipelines();
+	prepare_filter_pipelines();
+
+	select_available_variant();
+
+	variant_times.clear();
+	reset_timings();
+
+	if (prepared)
+	{
+		rebuild_command_buffers();
+	}
+}
+
+void FilterSample::select_available_variant()
+{
+	if (is_available(variant_id))
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < variants.size(); ++i)
+	{
+		if (is_available(i))
+		{
+			LOGW("{} is not available for the {} kernel, switching to {}", variants[variant_id].name, kernel->get_name(), variants[i].name);
+			variant_id = i;
+			return;
+		}
+	}
+	LOGE("No variant supports the {} kernel", kernel->get_name());
+}
+
+bool FilterSample::is_supported(const FilterVariant &variant, const vkb::FilterKernel &filter_kernel) const
+{
+	if ((variant.requires_separable && !filter_kernel.is_separable()) ||
+	    (variant.requires_linear_sampling && !filter_kernel.supports_linear_sampling()))
+	{
+		return false;
+	}
+
+	// the default workgroups are the fallback of the tuned ones, so they have to fit the radius
+	return std::all_of(variant.passes.begin(), variant.passes.end(), [&](const FilterPass &pass) {
+		return pass.bind_point != VK_PIPELINE_BIND_POINT_COMPUTE ||
+		       is_workgroup_supported(pass, {pass.workgroup_size.width, pass.workgroup_size.height, 1}, filter_kernel.get_radius());
+	});
+}
+
+bool FilterSample::is_available(size_t id) const
+{
+	return is_supported(variants[id], *kernel) && (precision == FilterPrecision::Full || variants[id].supports_half_precision);
+}
+
+bool FilterSample::uses_image(const FilterVariant &variant, FilterImage image) const
+{
+	return std::any_of(variant.passes.begin(), variant.passes.end(), [image](const FilterPass &pass) { return pass.input == image || pass.output == image; });
+}
+
+bool FilterSample::is_compute_variant(const FilterVariant &variant) const
+{
+	return std::all_of(variant.passes.begin(), variant.passes.end(), [](const FilterPass &pass) { return pass.bind_point == VK_PIPELINE_BIND_POINT_COMPUTE; });
+}
+
+bool FilterSample::uses_async_compute() const
+{
+	// offscreen there is no source pass for the dispatches to overlap with
+	return async_compute && is_compute_variant(variants[variant_id]) && !is_offscreen();
+}
+
+bool FilterSample::measures_queue_overlap() const
+{
+	return uses_async_compute() && frame_timestamp_queries->is_calibrated() && compute_timestamp_queries->is_calibrated();
+}
+
+std::set<std::pair<FilterSample::FilterImage, FilterSample::FilterImage>> FilterSample::get_image_pairs() const
+{
+	std::set<std::pair<FilterImage, FilterImage>> pairs;
+	for (auto &variant : variants)
+	{
+		for (auto &pass : variant.passes)
+		{
+			pairs.insert({pass.input, pass.output});
+		}
+	}
+	return pairs;
+}
+
+glm::vec2 FilterSample::get_filter_parameters(uint32_t radius) const
+{
+	return glm::vec2(0.0f);
+}
+
+bool FilterSample::is_workgroup_supported(const FilterPass &pass, const vkb::WorkgroupConfig &workgroup, uint32_t radius) const
+{
+	return true;
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> FilterSample::get_kernel_metrics(uint32_t radius) const
+{
+	return {};
+}
+
+uint32_t FilterSample::get_kernel_radius() const
+{
+	return kernel_radius;
+}
+
+bool FilterSample::check_async_compute_support()
+{
+	graphics_queue_family = device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT, 0).get_family_index();
+
+	// prefers a family with compute but without graphics
+	compute_queue_family = device->get_queue_family_index(VK_QUEUE_COMPUTE_BIT);
+	if (compute_queue_family == graphics_queue_family)
+	{
+		LOGW("No dedicated compute queue family, async compute is not available");
+		return false;
+	}
+
+	// the dispatches are timed on the compute queue
+	if (device->get_queue(compute_queue_family, 0).get_properties().timestampValidBits == 0)
+	{
+		LOGW("Compute queue family {} does not support timestamps, async compute is not available", compute_queue_family);
+		return false;
+	}
+
+	LOGI("Async compute uses queue family {}", compute_queue_family);
+	return true;
+}
+
+void FilterSample::setup_async_compute()
+{
+	if (!async_compute_supported)
+	{
+		return;
+	}
+
+	compute_queue = device->get_queue(compute_queue_family, 0).get_handle();
+
+	// the compute command buffers are only re-recorded while async compute is in use, so they are reset one by one
+	VkCommandPoolCreateInfo command_pool_info = {};
+	command_pool_info.sType                   = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	command_pool_info.flags                   = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+	command_pool_info.queueFamilyIndex        = compute_queue_family;
+	VK_CHECK(vkCreateCommandPool(device->get_handle(), &command_pool_info, nullptr, &compute_cmd_pool));
+
+	compute_cmd_buffers.resize(draw_cmd_buffers.size());
+	VkCommandBufferAllocateInfo allocate_info =
+	    vkb::initializers::command_buffer_allocate_info(compute_cmd_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, vkb::to_u32(compute_cmd_buffers.size()));
+	VK_CHECK(vkAllocateCommandBuffers(device->get_handle(), &allocate_info, compute_cmd_buffers.data()));
+
+	// the source pass command buffers are re-recorded with their frame, so they are reset one by one as well
+	command_pool_info.queueFamilyIndex = graphics_queue_family;
+	VK_CHECK(vkCreateCommandPool(device->get_handle(), &command_pool_info, nullptr, &source_cmd_pool));
+
+	source_cmd_buffers.resize(draw_cmd_buffers.size());
+	allocate_info = vkb::initializers::command_buffer_allocate_info(source_cmd_pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY, vkb::to_u32(source_cmd_buffers.size()));
+	VK_CHECK(vkAllocateCommandBuffers(device->get_handle(), &allocate_info, source_cmd_buffers.data()));
+
+	// one pair per frame in flight, they are waited on before the fence of the frame signals
+	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
+	source_complete_semaphores.resize(draw_cmd_buffers.size());
+	compute_complete_semaphores.resize(draw_cmd_buffers.size());
+	for (size_t i = 0; i < draw_cmd_buffers.size(); ++i)
+	{
+		VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &source_complete_semaphores[i]));
+		VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &compute_complete_semaphores[i]));
+	}
+}
+
+std::vector<FilterSample::BenchmarkConfiguration> FilterSample::get_benchmark_configurations() const
+{
+	std::vector<vkb::FilterKernel> kernels;
+	for (uint32_t radius : benchmark_radii)
+	{
+		kernels.push_back(create_kernel(radius));
+	}
+
+	// grouped by variant, like the variants of the other filter samples, the half precision configurations follow
+	// the full precision one they are compared to. The async compute configuration of the variants made of compute
+	// passes comes last, there is no graphics work to overlap with offscreen
+	bool async = async_compute_supported && !is_offscreen();
+
+	std::vector<BenchmarkConfiguration> configurations;
+	for (size_t i = 0; i < variants.size(); ++i)
+	{
+		for (auto &benchmark_kernel : kernels)
+		{
+			if (!is_supported(variants[i], benchmark_kernel))
+			{
+				continue;
+			}
+
+			configurations.push_back({i, benchmark_kernel.get_radius(), FilterPrecision::Full, false});
+			if (half_float_supported && variants[i].supports_half_precision)
+			{
+				configurations.push_back({i, benchmark_kernel.get_radius(), FilterPrecision::Half, false});
+				if (uses_image(variants[i], FilterImage::Intermediate))
+				{
+					configurations.push_back({i, benchmark_kernel.get_radius(), FilterPrecision::HalfIntermediate, false});
+				}
+			}
+			if (async && is_compute_variant(variants[i]))
+			{
+				configurations.push_back({i, benchmark_kernel.get_radius(), FilterPrecision::Full, true});
+			}
+		}
+	}
+	return configurations;
+}
+
+VkPipelineShaderStageCreateInfo FilterSample::get_shader_stage(const std::string &file, VkShaderStageFlagBits stage, const vkb::ShaderVariant &shader_variant)
+{
+	std::string key = file + "#" + std::to_string(shader_variant.get_id());
+
+	auto it = shader_stages.find(key);
+	if (it == shader_stages.end())
+	{
+		it = shader_stages.emplace(key, load_shader(file, stage, shader_variant)).first;
+	}
+	return it->second;
+}
+
+vkb::ShaderVariant FilterSample::get_shader_variant(const FilterPass &pass) const
+{
+	vkb::ShaderVariant shader_variant;
+	if (precision != FilterPrecision::Full)
+	{
+		shader_variant.add_define("FILTER_FP16");
+	}
+
+	// the half precision weights are read without conversion
+	if (uses_half_float_storage())
+	{
+		shader_variant.add_define("FILTER_FP16_STORAGE");
+	}
+
+	// fragment passes draw a batch through a multiview render pass
+	if (pass.bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS && get_batch_size() > 1)
+	{
+		shader_variant.add_define("FILTER_MULTIVIEW");
+	}
+
+	// fragment passes write through the render pass of the image
+	if (pass.bind_point == VK_PIPELINE_BIND_POINT_COMPUTE && targets[static_cast<size_t>(pass.output)].format == half_float_format)
+	{
+		shader_variant.add_define("FILTER_DST_FORMAT=rgba16f");
+	}
+
+	for (auto &define : pass.defines)
+	{
+		shader_variant.add_define(define);
+	}
+	return shader_variant;
+}
+
+VkPipelineShaderStageCreateInfo FilterSample::get_pass_shader_stage(const FilterPass &pass)
+{
+	VkShaderStageFlagBits stage = pass.bind_point == VK_PIPELINE_BIND_POINT_COMPUTE ? VK_SHADER_STAGE_COMPUTE_BIT : VK_SHADER_STAGE_FRAGMENT_BIT;
+
+	// subgroup operations require SPIR-V 1.3, the target environment is part of the key of the SPIR-V cache
+	if (pass.uses_subgroups)
+	{
+		vkb::GLSLCompiler::set_target_environment(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+	}
+	auto shader_stage = get_shader_stage(pass.shader, stage, get_shader_variant(pass));
+	if (pass.uses_subgroups)
+	{
+		vkb::GLSLCompiler::reset_target_environment();
+	}
+	return shader_stage;
+}
+
+void FilterSample::compile_pass_shaders(vkb::PipelineBuilder &builder, const std::vector<const FilterPass *> &passes)
+{
+	// the shaders that have not been loaded yet, grouped by the definitions and the SPIR-V version they are compiled with
+	std::map<std::pair<size_t, bool>, std::pair<vkb::ShaderVariant, std::vector<std::string>>> pending_shaders;
+	for (auto pass : passes)
+	{
+		auto shader_variant = get_shader_variant(*pass);
+		if (shader_stages.count(pass->shader + "#" + std::to_string(shader_variant.get_id())) == 0)
+		{
+			auto &files = pending_shaders.emplace(std::make_pair(shader_variant.get_id(), pass->uses_subgroups),
+			                                      std::make_pair(shader_variant, std::vector<std::string>{}))
+			                  .first->second.second;
+			if (std::find(files.begin(), files.end(), pass->shader) == files.end())
+			{
+				files.push_back(pass->shader);
+			}
+		}
+	}
+
+	for (auto &pending : pending_shaders)
+	{
+		if (pending.first.second)
+		{
+			vkb::GLSLCompiler::set_target_environment(glslang::EShTargetSpv, glslang::EShTargetSpv_1_3);
+		}
+		builder.compile_shaders(pending.second.second, pending.second.first);
+		if (pending.first.second)
+		{
+			vkb::GLSLCompiler::reset_target_environment();
+		}
+	}
+}
+
+bool FilterSample::uses_half_float_storage() const
+{
+	return precision != FilterPrecision::Full && half_float_storage_supported;
+}
+
+VkRenderPass FilterSample::get_offscreen_pass(FilterImage image) const
+{
+	return targets[static_cast<size_t>(image)].format == half_float_format ? half_float_pass : offscreen_pass;
+}
+
+void FilterSample::prepare_pipelines()
+{
+	// resolve pipeline layout, also used to draw the source image
+	VkPipelineLayoutCreateInfo layout_info = vkb::initializers::pipeline_layout_create_info(&descriptor_set_layouts.resolve);
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &layout_info, nullptr, &pipeline_layouts.resolve));
+
+	// filter pipeline layout, shared by the graphics and compute passes
+	VkPushConstantRange range = vkb::initializers::push_constant_range(VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT, sizeof(push_constants), 0);
+
+	layout_info                        = vkb::initializers::pipeline_layout_create_info(&descriptor_set_layouts.filter);
+	layout_info.pushConstantRangeCount = 1;
+	layout_info.pPushConstantRanges    = &range;
+	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &layout_info, nullptr, &pipeline_layouts.filter));
+
+	VkPipelineVertexInputStateCreateInfo   vertex_input   = vkb::initializers::pipeline_vertex_input_state_create_info();
+	VkPipelineInputAssemblyStateCreateInfo input_assembly = vkb::initializers::pipeline_input_assembly_state_create_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0, VK_FALSE);
+	VkPipelineRasterizationStateCreateInfo raster         = vkb::initializers::pipeline_rasterization_state_create_info(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+	raster.lineWidth                                      = 1.0f;
+
+	VkPipelineMultisampleStateCreateInfo  multisample_state = vkb::initializers::pipeline_multisample_state_create_info(VK_SAMPLE_COUNT_1_BIT);
+	VkPipelineDepthStencilStateCreateInfo depth_stencil     = vkb::initializers::pipeline_depth_stencil_state_create_info(VK_FALSE, VK_FALSE, VK_COMPARE_OP_ALWAYS);
+
+	VkPipelineColorBlendAttachmentState blend_attachment = vkb::initializers::pipeline_color_blend_attachment_state(
+	    VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT, VK_FALSE);
+	VkPipelineColorBlendStateCreateInfo blend = vkb::initializers::pipeline_color_blend_state_create_info(1, &blend_attachment);
+
+	VkPipelineViewportStateCreateInfo viewport = vkb::initializers::pipeline_viewport_state_create_info(1, 1);
+
+	std::array<VkDynamicState, 2>    dynamics{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo dynamic = vkb::initializers::pipeline_dynamic_state_create_info(dynamics.data(), vkb::to_u32(dynamics.size()));
+
+	// the resolve pipeline is used by every frame, so it is never built lazily
+	vkb::PipelineBuilder resolve_pipeline_builder{get_device(), pipeline_cache};
+	resolve_pipeline_builder.compile_shaders({vertex_shader_path.data(), resolve_fragment_shader_path.data()});
+
+	std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+	stages[0] = get_shader_stage(vertex_shader_path.data(), VK_SHADER_STAGE_VERTEX_BIT);
+	stages[1] = get_shader_stage(resolve_fragment_shader_path.data(), VK_SHADER_STAGE_FRAGMENT_BIT);
+
+	VkGraphicsPipelineCreateInfo pipeline_create_info = vkb::initializers::pipeline_create_info(pipeline_layouts.resolve, resolve_pass);
+	pipeline_create_info.pVertexInputState            = &vertex_input;
+	pipeline_create_info.pInputAssemblyState          = &input_assembly;
+	pipeline_create_info.pViewportState               = &viewport;
+	pipeline_create_info.pRasterizationState          = &raster;
+	pipeline_create_info.pMultisampleState            = &multisample_state;
+	pipeline_create_info.pDepthStencilState           = &depth_stencil;
+	pipeline_create_info.pColorBlendState             = &blend;
+	pipeline_create_info.pDynamicState                = &dynamic;
+	pipeline_create_info.stageCount                   = vkb::to_u32(stages.size());
+	pipeline_create_info.pStages                      = stages.data();
+
+	resolve_pipeline_builder.add_graphics_pipeline(pipeline_create_info, &resolve_pipeline);
+
+	resolve_pipeline_builder.build();
+	resolve_pipeline_builder.wait_all();
+}
+
+void FilterSample::prepare_filter_pipelines()
+{
+	// the same fixed function state as the source and resolve pipelines
+	VkPipelineVertexInputStateCreateInfo   vertex_input   = vkb::initializers::pipeline_vertex_input_state_create_info();
+	VkPipelineInputAssemblyStateCreateInfo input_assembly = vkb::initializers::pipeline_input_assembly_state_create_info(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0, VK_FALSE);
+	VkPipelineRasterizationStateCreateInfo raster         = vkb::initializers::pipeline_rasterization_state_create_info(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE);
+	raster.lineWidth                                      = 1.0f;
+
+	VkPipelineMultisampleStateCreateInfo  multisample_state = vkb::initializers::pipeline_multisample_state_create_info(VK_SAMPLE_COUNT_1_BIT);
+	VkPipelineDepthStencilStateCreateInfo depth_stencil     = vkb::initializers::pipeline_depth_stencil_state_create_info(VK_FALSE, VK_FALSE, VK_COMPARE_OP_ALWAYS);
+
+	VkPipelineColorBlendAttachmentState blend_attachment = vkb::initializers::pipeline_color_blend_attachment_state(
+	    VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT, VK_FALSE);
+	VkPipelineColorBlendStateCreateInfo blend = vkb::initializers::pipeline_color_blend_state_create_info(1, &blend_attachment);
+
+	VkPipelineViewportStateCreateInfo viewport = vkb::initializers::pipeline_viewport_state_create_info(1, 1);
+
+	std::array<VkDynamicState, 2>    dynamics{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+	VkPipelineDynamicStateCreateInfo dynamic = vkb::initializers::pipeline_dynamic_state_create_info(dynamics.data(), vkb::to_u32(dynamics.size()));
+
+	pipeline_builder = std::make_unique<vkb::PipelineBuilder>(get_device(), pipeline_cache);
+
+	// compile the shaders of the available variants ahead of their pipelines
+	std::vector<const FilterPass *> passes;
+	for (size_t i = 0; i < variants.size(); ++i)
+	{
+		if (is_available(i))
+		{
+			for (auto &pass : variants[i].passes)
+			{
+				passes.push_back(&pass);
+			}
+		}
+	}
+	compile_pass_shaders(*pipeline_builder, passes);
+
+	std::array<VkPipelineShaderStageCreateInfo, 2> stages{};
+	stages[0] = get_shader_stage(vertex_shader_path.data(), VK_SHADER_STAGE_VERTEX_BIT);
+	stages[1] = get_shader_stage(resolve_fragment_shader_path.data(), VK_SHADER_STAGE_FRAGMENT_BIT);
+
+	// the source pipeline draws into every layer of the offscreen pass, so it is recreated with the filter pipelines
+	VkGraphicsPipelineCreateInfo pipeline_create_info = vkb::initializers::pipeline_create_info(pipeline_layouts.resolve, offscreen_pass);
+	pipeline_create_info.pVertexInputState            = &vertex_input;
+	pipeline_create_info.pInputAssemblyState          = &input_assembly;
+	pipeline_create_info.pViewportState               = &viewport;
+	pipeline_create_info.pRasterizationState          = &raster;
+	pipeline_create_info.pMultisampleState            = &multisample_state;
+	pipeline_create_info.pDepthStencilState           = &depth_stencil;
+	pipeline_create_info.pColorBlendState             = &blend;
+	pipeline_create_info.pDynamicState                = &dynamic;
+	pipeline_create_info.stageCount                   = vkb::to_u32(stages.size());
+	pipeline_create_info.pStages                      = stages.data();
+
+	pipeline_builder->add_graphics_pipeline(pipeline_create_info, &source_pipeline);
+
+	pipeline_create_info.layout = pipeline_layouts.filter;
+
+	VkComputePipelineCreateInfo compute_create_info = vkb::initializers::compute_pipeline_create_info(pipeline_layouts.filter);
+
+	// radius, workgroup size and pixels per thread
+	std::array<VkSpecializationMapEntry, 4> map_entries = {
+	    vkb::initializers::specialization_map_entry(0, 0, sizeof(int32_t)),
+	    vkb::initializers::specialization_map_entry(1, sizeof(int32_t), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(2, 2 * sizeof(int32_t), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(3, 3 * sizeof(int32_t), sizeof(int32_t)),
+	};
+
+	std::array<int32_t, 4> data{static_cast<int32_t>(kernel_radius), 1, 1, 1};
+
+	filter_pipelines.assign(variants.size(), {});
+	workgroup_configs.assign(variants.size(), {});
+	for (size_t i = 0; i < variants.size(); ++i)
+	{
+		auto &passes = variants[i].passes;
+		filter_pipelines[i].assign(passes.size(), VK_NULL_HANDLE);
+		workgroup_configs[i].assign(passes.size(), {});
+
+		if (!is_available(i))
+		{
+			continue;
+		}
+
+		for (size_t j = 0; j < passes.size(); ++j)
+		{
+			if (passes[j].bind_point == VK_PIPELINE_BIND_POINT_GRAPHICS)
+			{
+				VkSpecializationInfo spec_info = vkb::initializers::specialization_info(1, map_entries.data(), sizeof(int32_t), data.data());
+
+				stages[1]                     = get_pass_shader_stage(passes[j]);
+				stages[1].pSpecializationInfo = &spec_info;
+
+				pipeline_create_info.renderPass = get_offscreen_pass(passes[j].output);
+
+				pipeline_builder->add_graphics_pipeline(pipeline_create_info, &filter_pipelines[i][j]);
+			}
+			else
+			{
+				auto &workgroup = workgroup_configs[i][j];
+				workgroup       = get_workgroup_config(passes[j]);
+
+				data[1] = static_cast<int32_t>(workgroup.width);
+				data[2] = static_cast<int32_t>(workgroup.height);
+				data[3] = static_cast<int32_t>(workgroup.pixels_per_thread);
+
+				VkSpecializationInfo spec_info = vkb::initializers::specialization_info(vkb::to_u32(map_entries.size()), map_entries.data(),
+				                                                                        sizeof(data), data.data());
+
+				compute_create_info.stage                     = get_pass_shader_stage(passes[j]);
+				compute_create_info.stage.pSpecializationInfo = &spec_info;
+
+				pipeline_builder->add_compute_pipeline(compute_create_info, &filter_pipelines[i][j]);
+			}
+		}
+	}
+
+	// the source pipeline and the passes of the current variant come first
+	std::vector<const VkPipeline *> priority{&source_pipeline};
+	for (auto &pipeline : filter_pipelines[variant_id])
+	{
+		priority.push_back(&pipeline);
+	}
+	pipeline_builder->build(priority);
+}
+
+std::string FilterSample::get_tuning_key(const FilterPass &pass) const
+{
+	// everything the shader is specialized or compiled with, the direction changes its memory access pattern
+	return fmt::format("{}{}_r{}_d{}_{}", pass.shader, precision_suffixes[static_cast<size_t>(precision)], kernel_radius, pass.direction_x, pass.direction_y);
+}
+
+vkb::WorkgroupConfig FilterSample::get_workgroup_config(const FilterPass &pass) const
+{
+	// a tuned workgroup may not fit the pass at another setting the key does not cover, like the tile of its shared memory
+	vkb::WorkgroupConfig default_config{pass.workgroup_size.width, pass.workgroup_size.height, 1};
+	vkb::WorkgroupConfig config = default_config;
+	if (!pass.tune_workgroup || !workgroup_tuner->find(get_tuning_key(pass), config) || !is_workgroup_supported(pass, config, kernel_radius))
+	{
+		return default_config;
+	}
+	return config;
+}
+
+bool FilterSample::tune_workgroups()
+{
+	if (!vkb::WorkgroupTuner::is_enabled())
+	{
+		return false;
+	}
+
+	// radius, workgroup size and pixels per thread, as in prepare_filter_pipelines
+	std::array<VkSpecializationMapEntry, 4> map_entries = {
+	    vkb::initializers::specialization_map_entry(0, 0, sizeof(int32_t)),
+	    vkb::initializers::specialization_map_entry(1, sizeof(int32_t), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(2, 2 * sizeof(int32_t), sizeof(uint32_t)),
+	    vkb::initializers::specialization_map_entry(3, 3 * sizeof(int32_t), sizeof(int32_t)),
+	};
+
+	bool tuned = false;
+	for (size_t i = 0; i < variants.size(); ++i)
+	{
+		if (!is_available(i))
+		{
+			continue;
+		}
+
+		for (auto &pass : variants[i].passes)
+		{
+			vkb::WorkgroupConfig config;
+			if (pass.bind_point != VK_PIPELINE_BIND_POINT_COMPUTE || !pass.tune_workgroup || workgroup_tuner->find(get_tuning_key(pass), config))
+			{
+				continue;
+			}
+
+			// the candidates write to the images of the frames in flight
+			if (!tuned)
+			{
+				device->wait_idle();
+				tuned = true;
+			}
+
+			auto create_pipeline = [&](const vkb::WorkgroupConfig &candidate) {
+				// the candidates that do not fit the pass are skipped like the ones the device rejects
+				if (!is_workgroup_supported(pass, candidate, kernel_radius))
+				{
+					return VkPipeline{VK_NULL_HANDLE};
+				}
+
+				std::array<int32_t, 4> data{static_cast<int32_t>(kernel_radius), static_cast<int32_t>(candidate.width),
+				                            static_cast<int32_t>(candidate.height), static_cast<int32_t>(candidate.pixels_per_thread)};
+
+				VkSpecializationInfo spec_info = vkb::initializers::specialization_info(vkb::to_u32(map_entries.size()), map_entries.data(),
+				                                                                        sizeof(data), data.data());
+
+				VkComputePipelineCreateInfo compute_create_info = vkb::initializers::compute_pipeline_create_info(pipeline_layouts.filter);
+				compute_create_info.stage                       = get_pass_shader_stage(pass);
+				compute_create_info.stage.pSpecializationInfo   = &spec_info;
+
+				VkPipeline pipeline = VK_NULL_HANDLE;
+				if (vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_create_info, nullptr, &pipeline) != VK_SUCCESS)
+				{
+					return VkPipeline{VK_NULL_HANDLE};
+				}
+				return pipeline;
+			};
+
+			push_constants.direction_x = pass.direction_x;
+			push_constants.direction_y = pass.direction_y;
+
+			workgroup_tuner->tune(get_tuning_key(pass), get_workgroup_config(pass), create_pipeline,
+			                      [&](VkCommandBuffer cmd, VkPipeline pipeline, const vkb::WorkgroupConfig &candidate) {
+				                      record_dispatch(cmd, pass, pipeline, candidate, {});
+			                      });
+		}
+	}
+	return tuned;
+}
+
+void FilterSample::wait_active_pipelines()
+{
+	pipeline_builder->wait(source_pipeline);
+	for (auto &pipeline : filter_pipelines[variant_id])
+	{
+		pipeline_builder->wait(pipeline);
+	}
+}
+
+void FilterSample::destroy_filter_pipelines()
+{
+	// the pipelines may still be created in the background
+	pipeline_builder.reset();
+
+	reset_pass_commands();
+
+	vkDestroyPipeline(get_device().get_handle(), source_pipeline, nullptr);
+	source_pipeline = VK_NULL_HANDLE;
+
+	for (auto &pipelines : filter_pipelines)
+	{
+		for (auto pipeline : pipelines)
+		{
+			vkDestroyPipeline(get_device().get_handle(), pipeline, nullptr);
+		}
+	}
+	filter_pipelines.clear();
+}
+
+void FilterSample::update_kernel_buffer()
+{
+	// unused members are left as they are, the shaders only read the taps of the current radius
+	auto &weights = kernel->get_weights();
+	if (!weights.empty())
+	{
+		kernel_buffer->update(weights.data(), weights.size() * sizeof(float), kernel_weights_offset);
+	}
+
+	std::vector<float> linear_taps;
+	for (auto &tap : kernel->get_linear_taps())
+	{
+		linear_taps.push_back(tap.offset);
+		linear_taps.push_back(tap.weight);
+	}
+	if (!linear_taps.empty())
+	{
+		kernel_buffer->update(linear_taps.data(), linear_taps.size() * sizeof(float), kernel_linear_taps_offset);
+	}
+
+	auto weights_2d = kernel->get_weights_2d();
+	kernel_buffer->update(weights_2d.data(), weights_2d.size() * sizeof(float), kernel_weights_2d_offset);
+
+	// same kernel for the half precision variants
+	if (half_kernel_buffer)
+	{
+		if (!weights.empty())
+		{
+			auto half_weights = to_half_floats(weights);
+			half_kernel_buffer->update(half_weights.data(), half_weights.size() * sizeof(uint16_t), half_kernel_weights_offset);
+		}
+		if (!linear_taps.empty())
+		{
+			half_kernel_buffer->update(linear_taps.data(), linear_taps.size() * sizeof(float), half_kernel_linear_taps_offset);
+		}
+
+		auto half_weights_2d = to_half_floats(weights_2d);
+		half_kernel_buffer->update(half_weights_2d.data(), half_weights_2d.size() * sizeof(uint16_t), half_kernel_weights_2d_offset);
+	}
+}
+
+void FilterSample::setup_images()
+{
+	// the descriptor sets the pass commands bind are rewritten for the new images
+	pass_commands_outdated = true;
+
+	VkExtent3D extent = {get_filter_extent().width, get_filter_extent().height, 1};
+
+	// the views of the previous images go first, the images are destroyed with their pool
+	for (auto &target : targets)
+	{
+		target.image_view.reset();
+		target.layer_view.reset();
+		target.image = nullptr;
+	}
+
+	image_pool = std::make_unique<vkb::AliasedImagePool>(get_device());
+
+	// images are requested with the bitmask of the variants using them, the source and output images are used by all
+	assert(variants.size() <= 64);
+	for (size_t i = 0; i < targets.size(); ++i)
+	{
+		auto image = static_cast<FilterImage>(i);
+
+		uint64_t variant_mask = 0;
+		for (size_t j = 0; j < variants.size(); ++j)
+		{
+			if (image == FilterImage::Source || image == FilterImage::Output || uses_image(variants[j], image))
+			{
+				variant_mask |= uint64_t{1} << j;
+			}
+		}
+		if (variant_mask == 0)
+		{
+			continue;
+		}
+
+		// only the images written by compute passes are storage images, the output image is read back by the benchmark.
+		// The accumulation image is never drawn into
+		VkImageUsageFlags usage       = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		uint32_t          layer_count = get_batch_size();
+		targets[i].format             = filter_format;
+		switch (image)
+		{
+			case FilterImage::Intermediate:
+				usage |= VK_IMAGE_USAGE_STORAGE_BIT;
+				if (precision == FilterPrecision::HalfIntermediate)
+				{
+					targets[i].format = half_float_format;
+				}
+				break;
+			case FilterImage::Output:
+				usage |= VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+				break;
+			case FilterImage::Accumulation:
+				usage             = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+				layer_count       = 2 * get_batch_size();
+				targets[i].format = half_float_format;
+				break;
+			default:
+				break;
+		}
+
+		// a layer per image of the batch
+		targets[i].image = &image_pool->request(extent, targets[i].format, usage, variant_mask, layer_count);
+	}
+
+	image_pool->allocate();
+
+	for (auto &target : targets)
+	{
+		if (target.image)
+		{
+			target.image_view = std::make_unique<vkb::core::ImageView>(*target.image, VK_IMAGE_VIEW_TYPE_2D_ARRAY, target.format);
+			target.layer_view = std::make_unique<vkb::core::ImageView>(*target.image, VK_IMAGE_VIEW_TYPE_2D, target.format, 0, 0, 1, 1);
+		}
+	}
+
+	LOGI("Filter images of {}x{}: {:.1f} MB allocated, {:.1f} MB without aliasing", extent.width, extent.height,
+	     to_megabytes(image_pool->get_allocated_size()), to_megabytes(image_pool->get_requested_size()));
+}
+
+void FilterSample::update_extent_push_constants()
+{
+	VkExtent2D extent = get_filter_extent();
+
+	push_constants.width        = extent.width;
+	push_constants.height       = extent.height;
+	push_constants.texel_width  = 1.0f / extent.width;
+	push_constants.texel_height = 1.0f / extent.height;
+}
+
+const vkb::core::Image &FilterSample::get_output_image() const
+{
+	return *targets[static_cast<size_t>(FilterImage::Output)].image;
+}
+
+void FilterSample::setup_sampler()
+{
+	// clamped bilinear sampler, linear sampling variants rely on the filtering
+	VkSamplerCreateInfo sampler_create_info = vkb::initializers::sampler_create_info();
+	sampler_create_info.magFilter           = VK_FILTER_LINEAR;
+	sampler_create_info.minFilter           = VK_FILTER_LINEAR;
+	sampler_create_info.mipmapMode          = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	sampler_create_info.addressModeU        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.addressModeV        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.addressModeW        = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	sampler_create_info.maxLod              = 0.0f;
+	VK_CHECK(vkCreateSampler(get_device().get_handle(), &sampler_create_info, nullptr, &filter_sampler));
+}
+
+void FilterSample::setup_query_pool()
+{
+	size_t max_passes = 0;
+	for (auto &variant : variants)
+	{
+		max_passes = std::max(max_passes, variant.passes.size());
+	}
+
+	uint32_t valid_bits = device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT, 0).get_properties().timestampValidBits;
+
+	// a begin and an end timestamp per pass
+	timestamp_queries       = std::make_unique<vkb::TimestampQueryRing>(get_device(), vkb::to_u32(draw_cmd_buffers.size()), vkb::to_u32(2 * max_passes), valid_bits);
+	frame_timestamp_queries = std::make_unique<vkb::TimestampQueryRing>(get_device(), vkb::to_u32(draw_cmd_buffers.size()), 4, valid_bits);
+
+	if (async_compute_supported)
+	{
+		uint32_t compute_valid_bits = device->get_queue(compute_queue_family, 0).get_properties().timestampValidBits;
+		compute_timestamp_queries   = std::make_unique<vkb::TimestampQueryRing>(get_device(), vkb::to_u32(draw_cmd_buffers.size()), vkb::to_u32(2 * max_passes), compute_valid_bits);
+	}
+
+	pass_timings.resize(max_passes);
+}
+
+void FilterSample::setup_descriptor_set_layouts()
+{
+	// sampled image only, to draw the texture and the output image
+	{
+		VkDescriptorSetLayoutBinding    binding                           = vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT, 0);
+		VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info = vkb::initializers::descriptor_set_layout_create_info(&binding, 1);
+		VK_CHECK(vkCreateDescriptorSetLayout(get_device().get_handle(), &descriptor_set_layout_create_info, nullptr, &descriptor_set_layouts.resolve));
+	}
+
+	// input image, output storage image of compute passes and kernel weights
+	{
+		std::vector<VkDescriptorSetLayoutBinding> bindings =
+		    {
+		        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT, 0),
+		        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT, 1),
+		        vkb::initializers::descriptor_set_layout_binding(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT, 2),
+		    };
+		VkDescriptorSetLayoutCreateInfo descriptor_set_layout_create_info = vkb::initializers::descriptor_set_layout_create_info(bindings);
+		VK_CHECK(vkCreateDescriptorSetLayout(get_device().get_handle(), &descriptor_set_layout_create_info, nullptr, &descriptor_set_layouts.filter));
+	}
+}
+
+void FilterSample::setup_descriptor_pool()
+{
+	// source and resolve sets, and a filter set per pair of input and output images of the passes
+	uint32_t pair_count = vkb::to_u32(get_image_pairs().size());
+
+	std::array<VkDescriptorPoolSize, 3> pool_size =
+	    {
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, pair_count + 2),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, pair_count),
+	        vkb::initializers::descriptor_pool_size(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, pair_count),
+	    };
+
+	VkDescriptorPoolCreateInfo descriptor_pool_create_info = vkb::initializers::descriptor_pool_create_info(vkb::to_u32(pool_size.size()), pool_size.data(), pair_count + 2);
+	VK_CHECK(vkCreateDescriptorPool(get_device().get_handle(), &descriptor_pool_create_info, nullptr, &descriptor_pool));
+}
+
+void FilterSample::setup_descriptor_sets()
+{
+	VkDescriptorSetAllocateInfo allocate_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layouts.resolve, 1);
+	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &allocate_info, &descriptor_sets.source));
+	VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &allocate_info, &descriptor_sets.resolve));
+
+	allocate_info = vkb::initializers::descriptor_set_allocate_info(descriptor_pool, &descriptor_set_layouts.filter, 1);
+	for (auto &images : get_image_pairs())
+	{
+		VK_CHECK(vkAllocateDescriptorSets(get_device().get_handle(), &allocate_info, &filter_descriptor_sets[images]));
+	}
+}
+
+void FilterSample::update_descriptor_sets()
+{
+	std::vector<VkWriteDescriptorSet> writes;
+
+	// the image infos have to outlive the update below
+	VkDescriptorImageInfo texture_descriptor = vkb::initializers::descriptor_image_info(texture.sampler, texture.image->get_vk_image_view().get_handle(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkDescriptorImageInfo output_descriptor  = vkb::initializers::descriptor_image_info(filter_sampler, targets[static_cast<size_t>(FilterImage::Output)].layer_view->get_handle(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+	VkDescriptorBufferInfo kernel_descriptor = uses_half_float_storage() ? VkDescriptorBufferInfo{half_kernel_buffer->get_handle(), 0, half_kernel_buffer_size} :
+	                                                                       VkDescriptorBufferInfo{kernel_buffer->get_handle(), 0, kernel_buffer_size};
+
+	writes.push_back(vkb::initializers::write_descriptor_set(descriptor_sets.source, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, &texture_descriptor));
+	writes.push_back(vkb::initializers::write_descriptor_set(descriptor_sets.resolve, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, &output_descriptor));
+
+	std::vector<std::pair<VkDescriptorImageInfo, VkDescriptorImageInfo>> image_descriptors;
+	image_descriptors.reserve(filter_descriptor_sets.size());
+
+	for (auto &filter_set : filter_descriptor_sets)
+	{
+		auto &input  = targets[static_cast<size_t>(filter_set.first.first)];
+		auto &output = targets[static_cast<size_t>(filter_set.first.second)];
+
+		image_descriptors.emplace_back(vkb::initializers::descriptor_image_info(filter_sampler, input.image_view->get_handle(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL),
+		                               vkb::initializers::descriptor_image_info(VK_NULL_HANDLE, output.image_view->get_handle(), VK_IMAGE_LAYOUT_GENERAL));
+
+		writes.push_back(vkb::initializers::write_descriptor_set(filter_set.second, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 0, &image_descriptors.back().first));
+		writes.push_back(vkb::initializers::write_descriptor_set(filter_set.second, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, &image_descriptors.back().second));
+		writes.push_back(vkb::initializers::write_descriptor_set(filter_set.second, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2, &kernel_descriptor));
+	}
+
+	vkUpdateDescriptorSets(get_device().get_handle(), vkb::to_u32(writes.size()), writes.data(), 0, nullptr);
+}
+
+void FilterSample::get_frame_time()
+{
+	// Reads the frame previously submitted with the current command buffer, whose fence has signaled
+	auto                   &passes = variants[variant_id].passes;
+	std::vector<uint64_t>   timestamps(2 * passes.size());
+	std::array<uint64_t, 4> frame_timestamps;
+
+	// with async compute the passes are timed on the compute queue
+	bool  async        = uses_async_compute();
+	auto &pass_queries = async ? *compute_timestamp_queries : *timestamp_queries;
+
+	if (!pass_queries.read(current_buffer, vkb::to_u32(timestamps.size()), timestamps.data()) ||
+	    !frame_timestamp_queries->read(current_buffer, 4, frame_timestamps.data()))
+	{
+		// the next frame read does not follow the previous one
+		previous_queue_intervals.reset();
+		return;
+	}
+
+	auto pass_track = async ? vkb::TraceRecorder::Track::AsyncCompute : vkb::TraceRecorder::Track::GPU;
+	for (size_t i = 0; i < passes.size(); ++i)
+	{
+		pass_timings[i].push(pass_queries.elapsed_ms(timestamps[2 * i], timestamps[2 * i + 1]));
+		pass_queries.trace(passes[i].name, timestamps[2 * i], timestamps[2 * i + 1], pass_track);
+	}
+
+	double frame_time = frame_timestamp_queries->elapsed_ms(frame_timestamps[0], frame_timestamps[3]);
+	frame_timings.push(frame_time);
+	frame_timestamp_queries->trace("frame", frame_timestamps[0], frame_timestamps[3]);
+
+	if (async)
+	{
+		double graphics_busy = frame_timestamp_queries->elapsed_ms(frame_timestamps[0], frame_timestamps[1]) +
+		                       frame_timestamp_queries->elapsed_ms(frame_timestamps[2], frame_timestamps[3]);
+		double compute_busy  = pass_queries.elapsed_ms(timestamps.front(), timestamps.back());
+
+		graphics_busy_timings.push(graphics_busy);
+		compute_busy_timings.push(compute_busy);
+
+		// the semaphores order the dispatches between the source and the resolve pass of their frame, so they can
+		// only overlap with the graphics work of the previous and the next frame. Timestamps of different queues are
+		// only comparable on the calibrated timeline
+		if (measures_queue_overlap())
+		{
+			QueueIntervals intervals;
+			intervals.graphics = {{{frame_timestamp_queries->to_trace_time(frame_timestamps[0]), frame_timestamp_queries->to_trace_time(frame_timestamps[1])},
+			                       {frame_timestamp_queries->to_trace_time(frame_timestamps[2]), frame_timestamp_queries->to_trace_time(frame_timestamps[3])}}};
+			intervals.compute  = {pass_queries.to_trace_time(timestamps.front()), pass_queries.to_trace_time(timestamps.back())};
+
+			auto overlap = [](const std::pair<double, double> &compute, const std::array<std::pair<double, double>, 2> &graphics) {
+				double time = 0.0;
+				for (auto &interval : graphics)
+				{
+					time += std::max(0.0, std::min(compute.second, interval.second) - std::max(compute.first, interval.first));
+				}
+				return time;
+			};
+
+			// each pair of neighbouring frames is measured once, when the later one is read
+			double time = overlap(intervals.compute, intervals.graphics);
+			if (previous_queue_intervals)
+			{
+				time += overlap(intervals.compute, previous_queue_intervals->graphics) + overlap(previous_queue_intervals->compute, intervals.graphics);
+			}
+			queue_overlap_timings.push(time * 1e-3);
+			previous_queue_intervals = intervals;
+		}
+	}
+}
+
+void FilterSample::reset_timings()
+{
+	for (auto &timings : pass_timings)
+	{
+		timings.reset();
+	}
+	frame_timings.reset();
+	graphics_busy_timings.reset();
+	compute_busy_timings.reset();
+	queue_overlap_timings.reset();
+	previous_queue_intervals.reset();
+
+	for (auto queries : {timestamp_queries.get(), frame_timestamp_queries.get(), compute_timestamp_queries.get()})
+	{
+		if (queries)
+		{
+			queries->discard();
+		}
+	}
+}
+
+void FilterSample::on_processing_extent_changed()
+{
+	// the times of the other variants were measured at the previous resolution
+	variant_times.clear();
+}
@@ -0,0 +1,470 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <map>
+#include <optional>
+#include <set>
+#include <utility>
+
+#include "aliased_image_pool.h"
+#include "core/shader_module.h"
+#include "filter_benchmark_sample.h"
+#include "filter_kernel.h"
+#include "pipeline_builder.h"
+#include "stats/timestamp_query_ring.h"
+#include "stats/timing_statistics.h"
+#include "workgroup_tuner.h"
+
+/**
+ * @brief Base class of samples benchmarking convolution filters on a fullscreen image
+ *
+ * Every frame the source texture is drawn into a source image, the passes of the selected
+ * filter variant read from it and write to an intermediate and an output image, and the
+ * output image is drawn to the swapchain. Derived classes only describe their variants and
+ * kernels: the pipelines are generated for the radius of the current kernel through
+ * specialization constants, and the weights are computed on the CPU and read by the
+ * shaders from a storage buffer (see shaders/filters/convolution.h).
+ *
+ * If the device supports half precision arithmetic, every variant can also be built with its
+ * shaders computing in half precision, optionally with a half precision intermediate image.
+ * The benchmark measures these next to the full precision variants and reports their speedup
+ * and their error against the full precision output.
+ *
+ * The source, intermediate and output images have the processing resolution, which is the
+ * window size unless set through set_processing_extent(). Only the resolve pass depends on
+ * the window size, it scales the output image to the swapchain.
+ *
+ * Offscreen (see --offscreen) the source image is drawn once and the frames only hold the
+ * filter passes, without the resolve and UI passes.
+ *
+ * The filters can process a batch of images per frame (see set_batch_size()), the images being
+ * the layers of the source, intermediate and output array images. Compute passes dispatch a
+ * z of the batch size, fragment passes draw every layer at once through a multiview render
+ * pass, so batches of more than one image require VK_KHR_multiview. Only the first layer is
+ * resolved to the swapchain and read back.
+ *
+ * Once a variant has been measured, each of its passes is submitted once more on its own to
+ * collect its pipeline statistics and, with VK_KHR_performance_query, its performance counters.
+ *
+ * The filter passes of every variant are recorded once per frame in secondary command buffers,
+ * which are kept until the images, framebuffers or pipelines they use are recreated. Selecting
+ * another variant of the same kernel only re-records the primary command buffer of each frame
+ * once its previous submission completed, without waiting for the device.
+ *
+ * Compute passes use the workgroup shape and pixels per thread tuned for the device if the tuning
+ * database has an entry for them (see vkb::WorkgroupTuner), and their default workgroup size
+ * otherwise. With --tune-workgroups the passes without an entry are tuned for each kernel radius
+ * and precision the first time the sample uses it.
+ *
+ * The images are allocated from a vkb::AliasedImagePool, so the intermediate and accumulation
+ * images share their memory as no variant uses both. The memory of the images each variant uses
+ * is shown in the UI and reported by the benchmark.
+ *
+ * If the device has a compute queue family without graphics, the variants made of compute passes
+ * only can run their dispatches on it (async compute), between a graphics submit drawing the source
+ * image and one drawing the output image to the swapchain. The benchmark measures them as variants
+ * of their own, with how long each queue was busy during the frame. With VK_EXT_calibrated_timestamps
+ * the timestamps of both queues are on one timeline, and the benchmark also measures how long the
+ * dispatches ran concurrently with the graphics work of the same and the neighbouring frames.
+ * Offscreen there is no graphics work for the dispatches to overlap with, so async compute is not offered.
+ */
+class FilterSample : public FilterBenchmarkSample
+{
+  public:
+	FilterSample();
+	virtual ~FilterSample();
+
+	// Override basic framework functionality
+	virtual void build_command_buffers() override;
+	virtual void render(float delta_time) override;
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
+	virtual bool resize(uint32_t width, uint32_t height) override;
+	virtual void setup_framebuffer() override;
+	virtual void setup_render_pass() override;
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
+
+	// Benchmark runner interface
+	virtual std::vector<Variant> get_benchmark_variants() const override;
+	virtual void set_benchmark_variant(size_t index) override;
+	virtual std::vector<PassTime> get_benchmark_pass_times() override;
+	virtual std::vector<Metric>   finish_benchmark_variant() override;
+
+  protected:
+	/// Images the filter passes read from and write to
+	enum class FilterImage
+	{
+		Source,
+		Intermediate,
+		Output,
+
+		/// Half precision image with two layers per image of the batch, for compute passes writing partial sums
+		Accumulation,
+	};
+
+	struct FilterPass
+	{
+		/// Name the pass is reported with
+		std::string name;
+
+		/// Fragment shader drawn as a fullscreen triangle, or compute shader
+		std::string shader;
+
+		VkPipelineBindPoint bind_point{VK_PIPELINE_BIND_POINT_GRAPHICS};
+
+		FilterImage input{FilterImage::Source};
+
+		FilterImage output{FilterImage::Output};
+
+		/// Sampling direction in texels of one-dimensional passes
+		int32_t direction_x{0};
+
+		int32_t direction_y{0};
+
+		/// Workgroup size of compute passes unless tuned, passed as specialization constants 1 and 2
+		VkExtent2D workgroup_size{16, 16};
+
+		/// Texels each invocation of a compute pass writes along x and y, in addition to its pixels per thread
+		VkExtent2D texels_per_invocation{1, 1};
+
+		/// False for compute passes whose workgroup size is part of the variant, they are never tuned
+		bool tune_workgroup{true};
+
+		/// Compiles the shader for SPIR-V 1.3, in which subgroup operations are core
+		bool uses_subgroups{false};
+
+		/// Definitions the shader is compiled with, in addition to the ones of the precision and the images
+		std::vector<std::string> defines;
+	};
+
+	struct FilterVariant
+	{
+		/// Short name the variant is reported with
+		std::string name;
+
+		std::vector<FilterPass> passes;
+
+		bool requires_separable{false};
+
+		bool requires_linear_sampling{false};
+
+		/// False for variants that are only built in full precision, like the ones accumulating long sums
+		bool supports_half_precision{true};
+	};
+
+	/**
+	 * @brief Describes the variants of the filter, called once during prepare
+	 *        The last pass of each variant has to write to the output image
+	 */
+	virtual std::vector<FilterVariant> get_filter_variants() const = 0;
+
+	/**
+	 * @brief Creates the kernel of the given radius from the current parameters of the sample
+	 */
+	virtual vkb::FilterKernel create_kernel(uint32_t radius) const = 0;
+
+	/**
+	 * @brief Draws the kernel parameters of the sample
+	 * @returns True if a parameter changed and the kernel has to be recreated
+	 */
+	virtual bool on_update_kernel_ui(vkb::Drawer &drawer);
+
+	/**
+	 * @brief Returns the filter parameters of the current kernel parameters at the given radius
+	 *        Passed to the shaders as pc.parameters (see shaders/filters/convolution.h), zero by default
+	 */
+	virtual glm::vec2 get_filter_parameters(uint32_t radius) const;
+
+	/**
+	 * @brief Checks whether a compute pass can run with a workgroup at the given radius, e.g. within the shared memory
+	 *        The variants whose default workgroups are not supported at a radius are not available at that radius,
+	 *        and tuned workgroups are only used if they are supported. True by default
+	 */
+	virtual bool is_workgroup_supported(const FilterPass &pass, const vkb::WorkgroupConfig &workgroup, uint32_t radius) const;
+
+	/**
+	 * @brief Returns the kernel parameters the filter actually uses at the given radius, where they differ from the UI
+	 *        Written to the benchmark output of every variant, none by default
+	 */
+	virtual std::vector<Metric> get_kernel_metrics(uint32_t radius) const;
+
+	/**
+	 * @brief Returns the radius of the current kernel
+	 */
+	uint32_t get_kernel_radius() const;
+
+	/**
+	 * @brief Recreates the kernel, its filter parameters and the pipelines that depend on its radius
+	 */
+	void set_kernel_radius(uint32_t radius);
+
+	/// Kernel radii swept in benchmark mode
+	std::vector<uint32_t> benchmark_radii{1, 2, 4, 8, 16, 32};
+
+  private:
+	static constexpr std::string_view texture_path = "textures/Lenna.ktx";
+
+	// common vertex shader of the fullscreen passes
+	static constexpr std::string_view vertex_shader_path = "quad3_vert.vert";
+
+	// draws the texture into the source image and the output image to the swapchain
+	static constexpr std::string_view resolve_fragment_shader_path = "simple.frag";
+
+	// format of the source, intermediate and output images
+	static constexpr VkFormat filter_format = VK_FORMAT_R8G8B8A8_UNORM;
+
+	// format of the intermediate image of the half precision intermediate variants, and of the accumulation image
+	static constexpr VkFormat half_float_format = VK_FORMAT_R16G16B16A16_SFLOAT;
+
+	enum class FilterPrecision
+	{
+		Full,
+		Half,
+		HalfIntermediate,
+	};
+
+	struct BenchmarkConfiguration
+	{
+		size_t variant_id;
+
+		uint32_t radius;
+
+		FilterPrecision precision;
+
+		bool async_compute;
+	};
+
+	std::vector<FilterVariant> variants;
+
+	size_t variant_id = 0;
+
+	std::unique_ptr<vkb::FilterKernel> kernel;
+
+	uint32_t kernel_radius = 2;
+
+	FilterPrecision precision = FilterPrecision::Full;
+
+	// multiview of VK_KHR_multiview, required by batches of more than one image
+	bool multiview_supported = false;
+
+	// largest batch of images, limited by the views of a multiview render pass
+	uint32_t max_batch_size = 1;
+
+	// pipelines of each pass of each variant, null for the variants the kernel does not support
+	std::vector<std::vector<VkPipeline>> filter_pipelines;
+
+	// workgroups the compute pipelines were created with, by variant then pass
+	std::vector<std::vector<vkb::WorkgroupConfig>> workgroup_configs;
+
+	std::unique_ptr<vkb::WorkgroupTuner> workgroup_tuner;
+
+	// creates the filter pipelines, in the background in lazy mode
+	std::unique_ptr<vkb::PipelineBuilder> pipeline_builder;
+
+	// shader stages loaded once, the pipelines are recreated whenever the radius changes
+	std::map<std::string, VkPipelineShaderStageCreateInfo> shader_stages;
+
+	std::unique_ptr<vkb::core::Buffer> kernel_buffer;
+
+	// half precision weights of the kernel, for the half precision variants if the device has 16-bit storage
+	std::unique_ptr<vkb::core::Buffer> half_kernel_buffer;
+
+	VkSampler filter_sampler = VK_NULL_HANDLE;
+
+	struct FilterTarget
+	{
+		vkb::core::Image                     *image = nullptr;        // owned by the image pool, null if no variant uses it
+		std::unique_ptr<vkb::core::ImageView> image_view;
+		std::unique_ptr<vkb::core::ImageView> layer_view;        // first layer, drawn by the resolve pass
+		VkFramebuffer                         framebuffer = VK_NULL_HANDLE;
+		VkFormat                              format      = filter_format;
+	};
+
+	Texture texture;
+
+	// source, intermediate, output and accumulation images, indexed by FilterImage
+	std::array<FilterTarget, 4> targets;
+
+	// owns the images, requested with the bitmask of the variants using them
+	std::unique_ptr<vkb::AliasedImagePool> image_pool;
+
+	VkPipeline source_pipeline  = VK_NULL_HANDLE;
+	VkPipeline resolve_pipeline = VK_NULL_HANDLE;
+
+	// render pass of the source, intermediate and output images, with a view per layer
+	VkRenderPass offscreen_pass = VK_NULL_HANDLE;
+
+	// render pass of a half precision intermediate image
+	VkRenderPass half_float_pass = VK_NULL_HANDLE;
+
+	// render pass drawing the output image to the swapchain
+	VkRenderPass resolve_pass = VK_NULL_HANDLE;
+
+	std::vector<VkFramebuffer> resolve_framebuffers;
+
+	struct
+	{
+		VkPipelineLayout resolve;
+		VkPipelineLayout filter;
+	} pipeline_layouts{};
+
+	struct
+	{
+		VkDescriptorSetLayout resolve;
+		VkDescriptorSetLayout filter;
+	} descriptor_set_layouts{};
+
+	struct
+	{
+		VkDescriptorSet source;
+		VkDescriptorSet resolve;
+	} descriptor_sets{};
+
+	// filter descriptor sets by input and output image
+	std::map<std::pair<FilterImage, FilterImage>, VkDescriptorSet> filter_descriptor_sets;
+
+	struct
+	{
+		int32_t width;
+		int32_t height;
+		float   texel_width;
+		float   texel_height;
+		int32_t direction_x;
+		int32_t direction_y;
+		glm::vec2 parameters;
+	} push_constants{};
+
+	// timestamps of the filter passes, and of the frame: source pass begin and end, resolve and UI begin and end
+	std::unique_ptr<vkb::TimestampQueryRing> timestamp_queries;
+	std::unique_ptr<vkb::TimestampQueryRing> frame_timestamp_queries;
+
+	// async compute: the dispatches of the compute variants run on a dedicated compute queue family,
+	// between a graphics submit of the source pass and a graphics submit of the resolve and the UI
+	bool                         async_compute           = false;
+	bool                         async_compute_supported = false;
+	uint32_t                     graphics_queue_family   = 0;
+	uint32_t                     compute_queue_family    = 0;
+	VkQueue                      compute_queue           = VK_NULL_HANDLE;
+	VkCommandPool                compute_cmd_pool        = VK_NULL_HANDLE;
+	VkCommandPool                source_cmd_pool         = VK_NULL_HANDLE;
+	std::vector<VkCommandBuffer> source_cmd_buffers;
+	std::vector<VkCommandBuffer> compute_cmd_buffers;
+	std::vector<VkSemaphore>     source_complete_semaphores;
+	std::vector<VkSemaphore>     compute_complete_semaphores;
+
+	// timestamps of the filter passes written on the compute queue
+	std::unique_ptr<vkb::TimestampQueryRing> compute_timestamp_queries;
+
+	// allocates the pass commands, kept across rebuilds of the frames, on the graphics and on the compute queue family
+	VkCommandPool pass_command_pool         = VK_NULL_HANDLE;
+	VkCommandPool compute_pass_command_pool = VK_NULL_HANDLE;
+
+	// secondary command buffers of the passes of each variant with and without async compute, by frame then pass, recorded on first use
+	std::map<std::pair<size_t, bool>, std::vector<VkCommandBuffer>> pass_commands;
+
+	// set when the images, framebuffers or pipelines the pass commands use are recreated
+	bool pass_commands_outdated = true;
+
+	// GPU time in ms of each pass of the current variant
+	std::vector<vkb::TimingStatistics> pass_timings;
+
+	// GPU time in ms from the beginning of the source pass to the end of the UI pass
+	vkb::TimingStatistics frame_timings;
+
+	// with async compute, GPU time in ms each queue was busy during the frame
+	vkb::TimingStatistics graphics_busy_timings;
+	vkb::TimingStatistics compute_busy_timings;
+
+	// with async compute and calibrated timestamps, GPU time in ms the compute queue was busy while the graphics queue was
+	vkb::TimingStatistics queue_overlap_timings;
+
+	// begin and end in us on the trace clock of the graphics and compute work of a frame
+	struct QueueIntervals
+	{
+		std::array<std::pair<double, double>, 2> graphics;
+
+		std::pair<double, double> compute;
+	};
+
+	// intervals of the previously read frame, to measure its overlap with the next one
+	std::optional<QueueIntervals> previous_queue_intervals;
+
+	// median time of the variants measured at the current kernel, precision and resolution, with and without async compute
+	std::map<std::pair<size_t, bool>, double> variant_times;
+
+	bool is_supported(const FilterVariant &variant, const vkb::FilterKernel &filter_kernel) const;
+	bool is_available(size_t id) const;
+	bool uses_image(const FilterVariant &variant, FilterImage image) const;
+	bool is_compute_variant(const FilterVariant &variant) const;
+	bool uses_async_compute() const;
+	bool measures_queue_overlap() const;
+	std::set<std::pair<FilterImage, FilterImage>> get_image_pairs() const;
+	std::vector<BenchmarkConfiguration> get_benchmark_configurations() const;
+	VkPipelineShaderStageCreateInfo get_shader_stage(const std::string &file, VkShaderStageFlagBits stage, const vkb::ShaderVariant &shader_variant = {});
+	vkb::ShaderVariant get_shader_variant(const FilterPass &pass) const;
+	VkPipelineShaderStageCreateInfo get_pass_shader_stage(const FilterPass &pass);
+	void compile_pass_shaders(vkb::PipelineBuilder &builder, const std::vector<const FilterPass *> &passes);
+	bool uses_half_float_storage() const;
+	VkRenderPass get_offscreen_pass(FilterImage image) const;
+	void set_precision(FilterPrecision filter_precision);
+	void select_available_variant();
+	bool check_async_compute_support();
+	void setup_async_compute();
+	void prepare_pipelines();
+	void prepare_filter_pipelines();
+	void wait_active_pipelines();
+	void destroy_filter_pipelines();
+	void update_kernel_buffer();
+	void setup_offscreen_passes();
+	virtual void setup_images() override;
+	virtual void update_extent_push_constants() override;
+	virtual uint32_t get_max_batch_size() override;
+	virtual void on_batch_size_changed() override;
+	virtual const vkb::core::Image &get_output_image() const override;
+	void setup_sampler();
+	void setup_query_pool();
+	void setup_descriptor_set_layouts();
+	void setup_descriptor_pool();
+	void setup_descriptor_sets();
+	void update_descriptor_sets();
+	void get_frame_time();
+	virtual void reset_timings() override;
+	virtual void on_processing_extent_changed() override;
+	void update_variant_time();
+	void draw_variant_comparison(vkb::Drawer &drawer);
+	void setup_pass_command_pool();
+	void reset_pass_commands();
+	void select_variant(size_t id, bool async);
+	virtual void record_frame(uint32_t frame) override;
+	void record_ownership_transfer(VkCommandBuffer cmd, FilterImage image, bool to_compute, bool release);
+	void record_filter_pass(VkCommandBuffer cmd, uint32_t frame, uint32_t pass_index);
+	VkCommandBuffer get_pass_commands(uint32_t frame, uint32_t pass_index);
+	void record_dispatch(VkCommandBuffer cmd, uint32_t frame, uint32_t pass_index, vkb::TimestampQueryRing *queries);
+	void record_dispatch(VkCommandBuffer cmd, const FilterPass &pass, VkPipeline pipeline, const vkb::WorkgroupConfig &workgroup,
+	                     const std::function<void(VkPipelineStageFlagBits)> &write_timestamp);
+	std::string get_tuning_key(const FilterPass &pass) const;
+	vkb::WorkgroupConfig get_workgroup_config(const FilterPass &pass) const;
+	bool tune_workgroups();
+	std::vector<Metric> profile_variant_passes();
+	void begin_offscreen_pass(VkCommandBuffer cmd, VkRenderPass render_pass, VkFramebuffer framebuffer, const VkExtent2D &extent,
+	                          VkSubpassContents contents);
+	void record_fullscreen_draw(VkCommandBuffer cmd, const VkExtent2D &extent, VkPipeline pipeline, VkPipelineLayout layout, VkDescriptorSet descriptor_set);
+	void draw_fullscreen(VkCommandBuffer cmd, VkRenderPass render_pass, VkFramebuffer framebuffer, const VkExtent2D &extent,
+	                     VkPipeline pipeline, VkPipelineLayout layout, VkDescriptorSet descriptor_set);
+};
@@ -17,6 +17,10 @@
 
 #include "glsl_compiler.h"
 
+#include <mutex>
+
+#include "spirv_cache.h"
+
 VKBP_DISABLE_WARNINGS()
 #include <SPIRV/GLSL.std.450.h>
 #include <SPIRV/GlslangToSpv.h>
@@ -80,6 +84,19 @@ inline EShLanguage FindShaderLanguage(VkShaderStageFlagBits stage)
 			return EShLangVertex;
 	}
 }
+
+/**
+ * @brief Returns the version of glslang and of its SPIR-V generator, which the generated code depends on
+ */
+const std::string &get_compiler_version()
+{
+	static const std::string compiler_version = [] {
+		auto version = glslang::GetVersion();
+		return fmt::format("glslang {}.{}.{}{} generator {}", version.major, version.minor, version.patch,
+		                   version.flavor ? version.flavor : "", glslang::GetSpirvGeneratorVersion());
+	}();
+	return compiler_version;
+}
 }        // namespace
 
 glslang::EShTargetLanguage        GLSLCompiler::env_target_language         = glslang::EShTargetLanguage::EShTargetNone;
@@ -104,8 +121,34 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
                                     std::vector<std::uint32_t> &spirv,
                                     std::string                &info_log)
 {
-	// Initialize glslang library.
-	glslang::InitializeProcess();
+	// Look up the SPIR-V before initializing glslang, a hit skips the compiler entirely
+	uint64_t key       = 0;
+	bool     cacheable = SpirvCache::is_enabled() && SpirvCache::hash_source(glsl_source, key);
+	if (cacheable)
+	{
+		key = SpirvCache::hash(&stage, sizeof(stage), key);
+		key = SpirvCache::hash(entry_point, key);
+		key = SpirvCache::hash(shader_variant.get_preamble(), key);
+		for (auto &process : shader_variant.get_processes())
+		{
+			key = SpirvCache::hash(process, key);
+		}
+		key = SpirvCache::hash(&GLSLCompiler::env_target_language, sizeof(GLSLCompiler::env_target_language), key);
+		key = SpirvCache::hash(&GLSLCompiler::env_target_language_version, sizeof(GLSLCompiler::env_target_language_version), key);
+
+		// another glslang may generate different code from the same source
+		key = SpirvCache::hash(get_compiler_version(), key);
+
+		if (SpirvCache::load(key, spirv))
+		{
+			return true;
+		}
+	}
+
+	// Initialize glslang library once, initializing and finalizing it around every compilation is not
+	// safe while other threads compile
+	static std::once_flag glslang_initialized;
+	std::call_once(glslang_initialized, [] { glslang::InitializeProcess(); });
 
 	EShMessages messages = static_cast<EShMessages>(EShMsgDefault | EShMsgVulkanRules | EShMsgSpvRules);
 
@@ -172,8 +215,10 @@ bool GLSLCompiler::compile_to_spirv(VkShaderStageFlagBits       stage,
 
 	info_log += logger.getAllMessages() + "\n";
 
-	// Shutdown glslang library.
-	glslang::FinalizeProcess();
+	if (cacheable)
+	{
+		SpirvCache::store(key, spirv);
+	}
 
 	return true;
 }
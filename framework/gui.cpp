@@ -440,6 +440,54 @@ bool Gui::update_buffers()
 	return updated;
 }
 
+void Gui::update_frame_buffers(uint32_t frame)
+{
+	ImDrawData *draw_data = ImGui::GetDrawData();
+	if (!draw_data)
+	{
+		return;
+	}
+
+	size_t vertex_buffer_size = draw_data->TotalVtxCount * sizeof(ImDrawVert);
+	size_t index_buffer_size  = draw_data->TotalIdxCount * sizeof(ImDrawIdx);
+
+	if ((vertex_buffer_size == 0) || (index_buffer_size == 0))
+	{
+		return;
+	}
+
+	if (frame >= frame_buffers.size())
+	{
+		frame_buffers.resize(frame + 1);
+	}
+	auto &buffers = frame_buffers[frame];
+
+	// the buffers only grow, so that the text changing every frame does not reallocate them
+	if (!buffers.vertex_buffer || buffers.vertex_buffer->get_size() < vertex_buffer_size)
+	{
+		buffers.vertex_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), vertex_buffer_size,
+		                                                       VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		                                                       VMA_MEMORY_USAGE_GPU_TO_CPU);
+		buffers.vertex_buffer->set_debug_name(fmt::format("GUI vertex buffer {}", frame));
+	}
+
+	if (!buffers.index_buffer || buffers.index_buffer->get_size() < index_buffer_size)
+	{
+		buffers.index_buffer = std::make_unique<core::Buffer>(sample.get_render_context().get_device(), index_buffer_size,
+		                                                      VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+		                                                      VMA_MEMORY_USAGE_GPU_TO_CPU);
+		buffers.index_buffer->set_debug_name(fmt::format("GUI index buffer {}", frame));
+	}
+
+	upload_draw_data(draw_data, buffers.vertex_buffer->map(), buffers.index_buffer->map());
+
+	buffers.vertex_buffer->flush();
+	buffers.index_buffer->flush();
+
+	buffers.vertex_buffer->unmap();
+	buffers.index_buffer->unmap();
+}
+
 void Gui::update_buffers(CommandBuffer &command_buffer, RenderFrame &render_frame)
 {
 	ImDrawData *draw_data = ImGui::GetDrawData();
@@ -652,6 +700,21 @@ void Gui::draw(CommandBuffer &command_buffer)
 }
 
 void Gui::draw(VkCommandBuffer command_buffer)
+{
+	draw(command_buffer, vertex_buffer->get_handle(), index_buffer->get_handle());
+}
+
+void Gui::draw(VkCommandBuffer command_buffer, uint32_t frame)
+{
+	if (frame >= frame_buffers.size() || !frame_buffers[frame].vertex_buffer)
+	{
+		return;
+	}
+
+	draw(command_buffer, frame_buffers[frame].vertex_buffer->get_handle(), frame_buffers[frame].index_buffer->get_handle());
+}
+
+void Gui::draw(VkCommandBuffer command_buffer, VkBuffer vertex_buffer_handle, VkBuffer index_buffer_handle)
 {
 	if (!visible)
 	{
@@ -679,10 +742,8 @@ void Gui::draw(VkCommandBuffer command_buffer)
 
 	VkDeviceSize offsets[1] = {0};
 
-	VkBuffer vertex_buffer_handle = vertex_buffer->get_handle();
 	vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer_handle, offsets);
 
-	VkBuffer index_buffer_handle = index_buffer->get_handle();
 	vkCmdBindIndexBuffer(command_buffer, index_buffer_handle, 0, VK_INDEX_TYPE_UINT16);
 
 	for (int32_t i = 0; i < draw_data->CmdListsCount; i++)
@@ -180,6 +180,14 @@ class Gui
 
 	bool update_buffers();
 
+	/**
+	 * @brief Uploads the draw data to the buffers of a frame in flight, for samples recording a command buffer per frame
+	 *        The buffers of a frame are only read by the commands of that frame, so they can be updated as soon as
+	 *        its previous submission has completed, without waiting for the other frames
+	 * @param frame Index of the frame
+	 */
+	void update_frame_buffers(uint32_t frame);
+
 	/**
 	 * @brief Draws the Gui
 	 * @param command_buffer Command buffer to register draw-commands
@@ -192,6 +200,13 @@ class Gui
 	 */
 	void draw(VkCommandBuffer command_buffer);
 
+	/**
+	 * @brief Draws the Gui from the buffers of a frame in flight, filled by update_frame_buffers()
+	 * @param command_buffer Command buffer to register draw-commands
+	 * @param frame Index of the frame, nothing is drawn if its buffers were never filled
+	 */
+	void draw(VkCommandBuffer command_buffer, uint32_t frame);
+
 	/**
 	 * @brief Shows an overlay top window with app info and maybe stats
 	 * @param app_name Application name
@@ -282,6 +297,18 @@ class Gui
 
 	size_t last_index_buffer_size;
 
+	/// Vertex and index buffers of each frame in flight, see update_frame_buffers()
+	struct FrameBuffers
+	{
+		std::unique_ptr<core::Buffer> vertex_buffer;
+
+		std::unique_ptr<core::Buffer> index_buffer;
+	};
+
+	std::vector<FrameBuffers> frame_buffers;
+
+	void draw(VkCommandBuffer command_buffer, VkBuffer vertex_buffer_handle, VkBuffer index_buffer_handle);
+
 	///  Scale factor to apply due to a difference between the window and GL pixel sizes
 	float content_scale_factor{1.0f};
 
@@ -47,7 +47,7 @@ bool HPPApiVulkanSample::prepare(const vkb::ApplicationOptions &options)
 	submit_info                   = vk::SubmitInfo();
 	submit_info.pWaitDstStageMask = &submit_pipeline_stages;
 
-	if (window->get_window_mode() != vkb::Window::Mode::Headless)
+	if (get_render_context().has_swapchain())
 	{
 		submit_info.setWaitSemaphores(semaphores.acquired_image_ready);
 		submit_info.setSignalSemaphores(semaphores.render_complete);
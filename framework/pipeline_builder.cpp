@@ -0,0 +1,442 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pipeline_builder.h"
+
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+#include <ctpl_stl.h>
+
+#include "common/error.h"
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+void check_no_next(const void *next)
+{
+	if (next != nullptr)
+	{
+		throw std::runtime_error("PipelineBuilder cannot copy pNext chains of pipeline create infos");
+	}
+}
+
+template <typename T>
+const T *copy_array(const T *data, uint32_t count, std::vector<T> &storage)
+{
+	if (data == nullptr || count == 0)
+	{
+		return data;
+	}
+	storage.assign(data, data + count);
+	return storage.data();
+}
+
+/**
+ * @brief Shader stage with its own copy of the entry point and specialization info
+ */
+struct ShaderStage
+{
+	VkPipelineShaderStageCreateInfo create_info;
+
+	std::string name;
+
+	VkSpecializationInfo specialization_info;
+
+	std::vector<VkSpecializationMapEntry> map_entries;
+
+	std::vector<uint8_t> data;
+
+	explicit ShaderStage(const VkPipelineShaderStageCreateInfo &source) :
+	    create_info{source},
+	    name{source.pName}
+	{
+		check_no_next(source.pNext);
+		create_info.pName = name.c_str();
+
+		if (source.pSpecializationInfo)
+		{
+			specialization_info = *source.pSpecializationInfo;
+
+			specialization_info.pMapEntries = copy_array(specialization_info.pMapEntries, specialization_info.mapEntryCount, map_entries);
+
+			auto bytes = static_cast<const uint8_t *>(specialization_info.pData);
+			if (bytes && specialization_info.dataSize > 0)
+			{
+				data.assign(bytes, bytes + specialization_info.dataSize);
+				specialization_info.pData = data.data();
+			}
+
+			create_info.pSpecializationInfo = &specialization_info;
+		}
+	}
+
+	// the create info points into the stage itself
+	ShaderStage(const ShaderStage &) = delete;
+};
+}        // namespace
+
+struct PipelineBuilder::Pipeline
+{
+	VkPipeline *pipeline;
+
+	// the pipeline is created by whichever thread gets to it first
+	std::once_flag created;
+
+	VkResult result{VK_NOT_READY};
+
+	explicit Pipeline(VkPipeline *pipeline) :
+	    pipeline{pipeline}
+	{}
+
+	virtual ~Pipeline() = default;
+
+	void create(VkDevice device, VkPipelineCache cache)
+	{
+		std::call_once(created, [this, device, cache]() { result = create_pipeline(device, cache); });
+	}
+
+	virtual VkResult create_pipeline(VkDevice device, VkPipelineCache cache) = 0;
+};
+
+struct PipelineBuilder::GraphicsPipeline : PipelineBuilder::Pipeline
+{
+	VkGraphicsPipelineCreateInfo create_info;
+
+	std::vector<std::unique_ptr<ShaderStage>> shader_stages;
+
+	std::vector<VkPipelineShaderStageCreateInfo> stages;
+
+	VkPipelineVertexInputStateCreateInfo           vertex_input;
+	std::vector<VkVertexInputBindingDescription>   vertex_bindings;
+	std::vector<VkVertexInputAttributeDescription> vertex_attributes;
+
+	VkPipelineInputAssemblyStateCreateInfo input_assembly;
+
+	VkPipelineTessellationStateCreateInfo tessellation;
+
+	VkPipelineViewportStateCreateInfo viewport;
+	std::vector<VkViewport>           viewports;
+	std::vector<VkRect2D>             scissors;
+
+	VkPipelineRasterizationStateCreateInfo rasterization;
+
+	VkPipelineMultisampleStateCreateInfo multisample;
+	std::vector<VkSampleMask>            sample_mask;
+
+	VkPipelineDepthStencilStateCreateInfo depth_stencil;
+
+	VkPipelineColorBlendStateCreateInfo              color_blend;
+	std::vector<VkPipelineColorBlendAttachmentState> blend_attachments;
+
+	VkPipelineDynamicStateCreateInfo dynamic;
+	std::vector<VkDynamicState>      dynamic_states;
+
+	GraphicsPipeline(const VkGraphicsPipelineCreateInfo &source, VkPipeline *pipeline) :
+	    Pipeline{pipeline},
+	    create_info{source}
+	{
+		check_no_next(source.pNext);
+
+		for (uint32_t i = 0; i < source.stageCount; ++i)
+		{
+			shader_stages.push_back(std::make_unique<ShaderStage>(source.pStages[i]));
+			stages.push_back(shader_stages.back()->create_info);
+		}
+		create_info.pStages = stages.data();
+
+		if (source.pVertexInputState)
+		{
+			check_no_next(source.pVertexInputState->pNext);
+			vertex_input                              = *source.pVertexInputState;
+			vertex_input.pVertexBindingDescriptions   = copy_array(vertex_input.pVertexBindingDescriptions, vertex_input.vertexBindingDescriptionCount, vertex_bindings);
+			vertex_input.pVertexAttributeDescriptions = copy_array(vertex_input.pVertexAttributeDescriptions, vertex_input.vertexAttributeDescriptionCount, vertex_attributes);
+			create_info.pVertexInputState             = &vertex_input;
+		}
+
+		if (source.pInputAssemblyState)
+		{
+			check_no_next(source.pInputAssemblyState->pNext);
+			input_assembly                  = *source.pInputAssemblyState;
+			create_info.pInputAssemblyState = &input_assembly;
+		}
+
+		if (source.pTessellationState)
+		{
+			check_no_next(source.pTessellationState->pNext);
+			tessellation                   = *source.pTessellationState;
+			create_info.pTessellationState = &tessellation;
+		}
+
+		if (source.pViewportState)
+		{
+			check_no_next(source.pViewportState->pNext);
+			viewport                   = *source.pViewportState;
+			viewport.pViewports        = copy_array(viewport.pViewports, viewport.viewportCount, viewports);
+			viewport.pScissors         = copy_array(viewport.pScissors, viewport.scissorCount, scissors);
+			create_info.pViewportState = &viewport;
+		}
+
+		if (source.pRasterizationState)
+		{
+			check_no_next(source.pRasterizationState->pNext);
+			rasterization                   = *source.pRasterizationState;
+			create_info.pRasterizationState = &rasterization;
+		}
+
+		if (source.pMultisampleState)
+		{
+			check_no_next(source.pMultisampleState->pNext);
+			multisample                   = *source.pMultisampleState;
+			multisample.pSampleMask       = copy_array(multisample.pSampleMask, (multisample.rasterizationSamples + 31) / 32, sample_mask);
+			create_info.pMultisampleState = &multisample;
+		}
+
+		if (source.pDepthStencilState)
+		{
+			check_no_next(source.pDepthStencilState->pNext);
+			depth_stencil                  = *source.pDepthStencilState;
+			create_info.pDepthStencilState = &depth_stencil;
+		}
+
+		if (source.pColorBlendState)
+		{
+			check_no_next(source.pColorBlendState->pNext);
+			color_blend                  = *source.pColorBlendState;
+			color_blend.pAttachments     = copy_array(color_blend.pAttachments, color_blend.attachmentCount, blend_attachments);
+			create_info.pColorBlendState = &color_blend;
+		}
+
+		if (source.pDynamicState)
+		{
+			check_no_next(source.pDynamicState->pNext);
+			dynamic                   = *source.pDynamicState;
+			dynamic.pDynamicStates    = copy_array(dynamic.pDynamicStates, dynamic.dynamicStateCount, dynamic_states);
+			create_info.pDynamicState = &dynamic;
+		}
+	}
+
+	VkResult create_pipeline(VkDevice device, VkPipelineCache cache) override
+	{
+		return vkCreateGraphicsPipelines(device, cache, 1, &create_info, nullptr, pipeline);
+	}
+};
+
+struct PipelineBuilder::ComputePipeline : PipelineBuilder::Pipeline
+{
+	VkComputePipelineCreateInfo create_info;
+
+	ShaderStage stage;
+
+	ComputePipeline(const VkComputePipelineCreateInfo &source, VkPipeline *pipeline) :
+	    Pipeline{pipeline},
+	    create_info{source},
+	    stage{source.stage}
+	{
+		check_no_next(source.pNext);
+		create_info.stage = stage.create_info;
+	}
+
+	VkResult create_pipeline(VkDevice device, VkPipelineCache cache) override
+	{
+		return vkCreateComputePipelines(device, cache, 1, &create_info, nullptr, pipeline);
+	}
+};
+
+bool PipelineBuilder::lazy_enabled = false;
+
+PipelineBuilder::PipelineBuilder(Device &device, VkPipelineCache pipeline_cache, uint32_t thread_count) :
+    device{device},
+    pipeline_cache{pipeline_cache}
+{
+	if (thread_count == 0)
+	{
+		thread_count = std::max(1u, std::thread::hardware_concurrency());
+	}
+	thread_pool = std::make_unique<ctpl::thread_pool>(static_cast<int>(thread_count));
+}
+
+PipelineBuilder::~PipelineBuilder()
+{
+	wait_all();
+}
+
+void PipelineBuilder::compile_shaders(const std::vector<std::string> &files, const ShaderVariant &shader_variant)
+{
+	std::vector<std::future<void>> futures;
+	for (auto &file : files)
+	{
+		futures.push_back(thread_pool->push([&file, &shader_variant](size_t) {
+			std::vector<uint32_t> spirv;
+			compile_glsl_shader(file, shader_variant, spirv);
+		}));
+	}
+
+	for (auto &future : futures)
+	{
+		try
+		{
+			future.get();
+		}
+		catch (const std::exception &)
+		{
+			// load_shader reports the error once the shader is actually used
+		}
+	}
+}
+
+void PipelineBuilder::add_graphics_pipeline(const VkGraphicsPipelineCreateInfo &create_info, VkPipeline *pipeline)
+{
+	queued_pipelines.push_back(std::make_unique<GraphicsPipeline>(create_info, pipeline));
+}
+
+void PipelineBuilder::add_compute_pipeline(const VkComputePipelineCreateInfo &create_info, VkPipeline *pipeline)
+{
+	queued_pipelines.push_back(std::make_unique<ComputePipeline>(create_info, pipeline));
+}
+
+void PipelineBuilder::build(const std::vector<const VkPipeline *> &priority)
+{
+	wait_all();
+
+	if (queued_pipelines.empty())
+	{
+		return;
+	}
+
+	VkDevice device_handle = device.get_handle();
+
+	// every worker starts from the contents of the main cache
+	std::vector<uint8_t> initial_data;
+	if (pipeline_cache != VK_NULL_HANDLE)
+	{
+		size_t size = 0;
+		if (vkGetPipelineCacheData(device_handle, pipeline_cache, &size, nullptr) == VK_SUCCESS && size > 0)
+		{
+			initial_data.resize(size);
+			if (vkGetPipelineCacheData(device_handle, pipeline_cache, &size, initial_data.data()) != VK_SUCCESS)
+			{
+				initial_data.clear();
+			}
+		}
+	}
+
+	worker_caches.assign(thread_pool->size(), VK_NULL_HANDLE);
+	for (auto &worker_cache : worker_caches)
+	{
+		VkPipelineCacheCreateInfo pipeline_cache_create_info = {};
+		pipeline_cache_create_info.sType                     = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		pipeline_cache_create_info.initialDataSize           = initial_data.size();
+		pipeline_cache_create_info.pInitialData              = initial_data.empty() ? nullptr : initial_data.data();
+		VK_CHECK(vkCreatePipelineCache(device_handle, &pipeline_cache_create_info, nullptr, &worker_cache));
+	}
+
+	// the prioritized pipelines move to the front, in the given order
+	building_pipelines = std::move(queued_pipelines);
+	queued_pipelines.clear();
+
+	auto next = building_pipelines.begin();
+	for (auto handle : priority)
+	{
+		auto it = std::find_if(next, building_pipelines.end(), [handle](const std::unique_ptr<Pipeline> &job) { return job->pipeline == handle; });
+		if (it != building_pipelines.end())
+		{
+			std::rotate(next, it, it + 1);
+			++next;
+		}
+	}
+
+	for (auto &building_pipeline : building_pipelines)
+	{
+		auto job = building_pipeline.get();
+		building_handles[job->pipeline] = job;
+		futures.push_back(thread_pool->push([this, device_handle, job](size_t thread) {
+			job->create(device_handle, worker_caches[thread]);
+		}));
+	}
+
+	if (!lazy_enabled)
+	{
+		wait_all();
+	}
+}
+
+VkPipeline PipelineBuilder::wait(const VkPipeline &pipeline)
+{
+	auto it = building_handles.find(&pipeline);
+	if (it != building_handles.end())
+	{
+		// the main cache is only written to by this thread until the worker caches are merged
+		it->second->create(device.get_handle(), pipeline_cache);
+		VK_CHECK(it->second->result);
+		building_handles.erase(it);
+	}
+	return pipeline;
+}
+
+void PipelineBuilder::wait_all()
+{
+	if (building_pipelines.empty())
+	{
+		return;
+	}
+
+	for (auto &future : futures)
+	{
+		future.get();
+	}
+	futures.clear();
+
+	VkDevice device_handle = device.get_handle();
+	if (pipeline_cache != VK_NULL_HANDLE)
+	{
+		VK_CHECK(vkMergePipelineCaches(device_handle, pipeline_cache, static_cast<uint32_t>(worker_caches.size()), worker_caches.data()));
+	}
+	for (auto worker_cache : worker_caches)
+	{
+		vkDestroyPipelineCache(device_handle, worker_cache, nullptr);
+	}
+	worker_caches.clear();
+
+	VkResult result = VK_SUCCESS;
+	for (auto &building_pipeline : building_pipelines)
+	{
+		if (building_pipeline->result != VK_SUCCESS && result == VK_SUCCESS)
+		{
+			result = building_pipeline->result;
+		}
+	}
+
+	building_pipelines.clear();
+	building_handles.clear();
+
+	VK_CHECK(result);
+}
+
+void PipelineBuilder::set_lazy_enabled(bool enabled)
+{
+	lazy_enabled = enabled;
+}
+
+bool PipelineBuilder::is_lazy_enabled()
+{
+	return lazy_enabled;
+}
+}        // namespace vkb
@@ -0,0 +1,144 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <future>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "core/shader_module.h"
+
+namespace ctpl
+{
+class thread_pool;
+}        // namespace ctpl
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Builds the pipelines of a sample on a pool of worker threads
+ *
+ * Shaders are compiled in parallel ahead of the pipelines that use them. Their SPIR-V stays in
+ * the in-memory layer of the SPIR-V cache, so the load_shader calls that set up the pipeline
+ * create infos afterwards only create the shader modules.
+ *
+ * Pipelines are queued with a deep copy of their create info, so the caller can reuse and
+ * modify the structures it passed, and are created in parallel by build(). Every worker
+ * creates its pipelines into its own pipeline cache, initialized from the main cache; the
+ * worker caches are merged back into the main cache once all pipelines have been created.
+ * The pNext chains of the create infos and of their states are not copied and have to be null.
+ *
+ * In lazy mode (see set_lazy_enabled) build() only starts creating the pipelines in the
+ * background and returns, so a sample can draw its first frame as soon as the pipelines it
+ * uses exist. wait() has to be called before a pipeline is used: it creates the pipeline on
+ * the calling thread if no worker has started it yet, or waits for the worker creating it.
+ */
+class PipelineBuilder
+{
+  public:
+	/**
+	 * @param device The logical device
+	 * @param pipeline_cache Cache the pipelines are looked up in and merged into, may be null
+	 * @param thread_count Number of worker threads, 0 for one per hardware thread
+	 */
+	PipelineBuilder(Device &device, VkPipelineCache pipeline_cache, uint32_t thread_count = 0);
+
+	~PipelineBuilder();
+
+	PipelineBuilder(const PipelineBuilder &) = delete;
+
+	PipelineBuilder &operator=(const PipelineBuilder &) = delete;
+
+	/**
+	 * @brief Compiles GLSL shaders on the worker threads and waits for them
+	 * @param files The shader locations relative to the shaders folder
+	 * @param shader_variant The definitions the shaders are compiled with
+	 */
+	void compile_shaders(const std::vector<std::string> &files, const ShaderVariant &shader_variant = {});
+
+	/**
+	 * @brief Queues a graphics pipeline, written to pipeline by build()
+	 */
+	void add_graphics_pipeline(const VkGraphicsPipelineCreateInfo &create_info, VkPipeline *pipeline);
+
+	/**
+	 * @brief Queues a compute pipeline, written to pipeline by build()
+	 */
+	void add_compute_pipeline(const VkComputePipelineCreateInfo &create_info, VkPipeline *pipeline);
+
+	/**
+	 * @brief Creates the queued pipelines
+	 *        Waits for all of them unless lazy mode is enabled, in which case the pipelines
+	 *        are created in the background, the ones in priority first and in that order
+	 * @param priority The pipelines the sample uses first
+	 */
+	void build(const std::vector<const VkPipeline *> &priority = {});
+
+	/**
+	 * @brief Waits until a pipeline queued by the last build() has been created
+	 *        A failure is handled like VK_CHECK
+	 * @returns The created pipeline
+	 */
+	VkPipeline wait(const VkPipeline &pipeline);
+
+	/**
+	 * @brief Waits for all pipelines of the last build() and merges the worker caches into the main cache
+	 *        A failure is handled like VK_CHECK, once all other pipelines have finished
+	 */
+	void wait_all();
+
+	/**
+	 * @brief Enables building the pipelines in the background
+	 */
+	static void set_lazy_enabled(bool enabled);
+
+	static bool is_lazy_enabled();
+
+  private:
+	struct Pipeline;
+
+	struct GraphicsPipeline;
+
+	struct ComputePipeline;
+
+	static bool lazy_enabled;
+
+	Device &device;
+
+	VkPipelineCache pipeline_cache;
+
+	std::unique_ptr<ctpl::thread_pool> thread_pool;
+
+	// pipelines queued for the next build()
+	std::vector<std::unique_ptr<Pipeline>> queued_pipelines;
+
+	// pipelines of the last build() and, by the handle they are written to, the ones still to be waited for
+	std::vector<std::unique_ptr<Pipeline>> building_pipelines;
+
+	std::unordered_map<const VkPipeline *, Pipeline *> building_handles;
+
+	std::vector<std::future<void>> futures;
+
+	std::vector<VkPipelineCache> worker_caches;
+};
+}        // namespace vkb
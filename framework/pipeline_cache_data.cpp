@@ -0,0 +1,51 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pipeline_cache_data.h"
+
+#include <cstring>
+
+#include <fmt/format.h>
+
+namespace vkb
+{
+std::string get_pipeline_cache_filename(const VkPhysicalDeviceProperties &properties)
+{
+	std::string uuid;
+	for (uint8_t byte : properties.pipelineCacheUUID)
+	{
+		uuid += fmt::format("{:02x}", byte);
+	}
+	return fmt::format("pipeline_cache_{:04x}_{:04x}_{:08x}_{}.bin", properties.vendorID, properties.deviceID, properties.driverVersion, uuid);
+}
+
+bool is_valid_pipeline_cache(const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties)
+{
+	VkPipelineCacheHeaderVersionOne header{};
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	return header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+	       header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+	       header.vendorID == properties.vendorID &&
+	       header.deviceID == properties.deviceID &&
+	       std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+}        // namespace vkb
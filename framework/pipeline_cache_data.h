@@ -0,0 +1,42 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief File name of the pipeline cache of a device in the cache directory, the driver version
+ *        is part of the name since the header of the cache data does not contain it
+ */
+std::string get_pipeline_cache_filename(const VkPhysicalDeviceProperties &properties);
+
+/**
+ * @brief Checks that pipeline cache data was created by the same device, drivers reject mismatching
+ *        data on their own but not all of them do it gracefully
+ * @param data The cache data, starting with a VkPipelineCacheHeaderVersionOne
+ * @param properties The properties of the device the data is passed to
+ * @return True if the header is complete and matches the vendor, device and pipeline cache UUID
+ */
+bool is_valid_pipeline_cache(const std::vector<uint8_t> &data, const VkPhysicalDeviceProperties &properties);
+}        // namespace vkb
@@ -26,6 +26,11 @@ VKBP_ENABLE_WARNINGS()
 
 #include "platform/platform.h"
 
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include <thread>
+
 namespace vkb
 {
 namespace fs
@@ -38,6 +43,7 @@ const std::unordered_map<Type, std::string> relative_paths = {
     {Type::Storage, "output/"},
     {Type::Screenshots, "output/images/"},
     {Type::Logs, "output/logs/"},
+    {Type::Cache, "output/cache/"},
 };
 
 const std::string get(const Type type, const std::string &file)
@@ -204,6 +210,46 @@ void write_temp(const std::vector<uint8_t> &data, const std::string &filename, c
 	write_binary_file(data, path::get(path::Type::Temp) + filename, count);
 }
 
+std::vector<uint8_t> read_cache(const std::string &filename)
+{
+	auto path = path::get(path::Type::Cache) + filename;
+	if (!is_file(path))
+	{
+		return {};
+	}
+	return read_binary_file(path, 0);
+}
+
+bool write_cache(const std::vector<uint8_t> &data, const std::string &filename)
+{
+	auto path = path::get(path::Type::Cache) + filename;
+
+	// unique per process and thread, several runs may share the cache directory
+	std::stringstream temp_path;
+	temp_path << path << "." << std::this_thread::get_id() << "." << std::chrono::steady_clock::now().time_since_epoch().count() << ".tmp";
+
+	try
+	{
+		write_binary_file(data, temp_path.str(), 0);
+	}
+	catch (const std::runtime_error &)
+	{
+		return false;
+	}
+
+	// rename() does not replace an existing file on every platform
+	if (std::rename(temp_path.str().c_str(), path.c_str()) != 0)
+	{
+		std::remove(path.c_str());
+		if (std::rename(temp_path.str().c_str(), path.c_str()) != 0)
+		{
+			std::remove(temp_path.str().c_str());
+			return false;
+		}
+	}
+	return true;
+}
+
 void write_image(const uint8_t *data, const std::string &filename, const uint32_t width, const uint32_t height, const uint32_t components, const uint32_t row_stride)
 {
 	stbi_write_png((path::get(path::Type::Screenshots) + filename + ".png").c_str(), width, height, components, data, row_stride);
@@ -41,6 +41,7 @@ enum Type
 	Storage,
 	Screenshots,
 	Logs,
+	Cache,
 	/* NewFolder */
 	TotalRelativePathTypes,
 
@@ -135,6 +136,25 @@ std::vector<uint8_t> read_temp(const std::string &filename, const uint32_t count
  */
 void write_temp(const std::vector<uint8_t> &data, const std::string &filename, const uint32_t count = 0);
 
+/**
+ * @brief Helper to read a file from the cache directory into a byte-array
+ *
+ * @param filename The path to the file (relative to the cache directory)
+ * @return A vector filled with data read from the file, empty if the file does not exist
+ */
+std::vector<uint8_t> read_cache(const std::string &filename);
+
+/**
+ * @brief Helper to replace a file in the cache directory
+ *        The data is written to a temporary file first and then renamed, so that
+ *        concurrent runs never read a partially written file
+ *
+ * @param data A vector filled with data to write
+ * @param filename The path to the file (relative to the cache directory)
+ * @return True if the file was written
+ */
+bool write_cache(const std::vector<uint8_t> &data, const std::string &filename);
+
 /**
  * @brief Helper to write to a png image in permanent storage
  *
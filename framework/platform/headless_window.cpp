@@ -17,6 +17,9 @@
 
 #include "headless_window.h"
 
+#include "common/logging.h"
+#include "common/strings.h"
+
 namespace vkb
 {
 HeadlessWindow::HeadlessWindow(const Window::Properties &properties) :
@@ -26,12 +29,33 @@ HeadlessWindow::HeadlessWindow(const Window::Properties &properties) :
 
 VkSurfaceKHR HeadlessWindow::create_surface(Instance &instance)
 {
-	return VK_NULL_HANDLE;
+	if (properties.mode == Mode::Offscreen || !instance.is_enabled(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME))
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	return create_surface(instance.get_handle(), VK_NULL_HANDLE);
 }
 
-VkSurfaceKHR HeadlessWindow::create_surface(VkInstance, VkPhysicalDevice)
+VkSurfaceKHR HeadlessWindow::create_surface(VkInstance instance, VkPhysicalDevice)
 {
-	return VK_NULL_HANDLE;
+	if (instance == VK_NULL_HANDLE || vkCreateHeadlessSurfaceEXT == nullptr)
+	{
+		return VK_NULL_HANDLE;
+	}
+
+	VkSurfaceKHR surface{VK_NULL_HANDLE};
+
+	VkHeadlessSurfaceCreateInfoEXT create_info{VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT};
+
+	VkResult result = vkCreateHeadlessSurfaceEXT(instance, &create_info, nullptr, &surface);
+	if (result != VK_SUCCESS)
+	{
+		LOGW("Failed to create headless surface ({}), continuing without a surface", to_string(result));
+		return VK_NULL_HANDLE;
+	}
+
+	return surface;
 }
 
 bool HeadlessWindow::should_close()
@@ -23,6 +23,8 @@ namespace vkb
 {
 /**
  * @brief Surface-less implementation of a Window, for use in headless rendering
+ *
+ * In offscreen mode no surface is created at all, samples render to their offscreen images only.
  */
 class HeadlessWindow : public Window
 {
@@ -32,14 +34,14 @@ class HeadlessWindow : public Window
 	virtual ~HeadlessWindow() = default;
 
 	/**
-	 * @brief A direct window doesn't have a surface
-	 * @returns VK_NULL_HANDLE
+	 * @brief Creates a headless surface if VK_EXT_headless_surface is enabled on the instance
+	 * @returns The surface, or VK_NULL_HANDLE if the extension is not available or in offscreen mode
 	 */
 	VkSurfaceKHR create_surface(Instance &instance) override;
 
 	/**
-	 * @brief A direct window doesn't have a surface
-	 * @returns nullptr
+	 * @brief Creates a headless surface using VK_EXT_headless_surface
+	 * @returns The surface, or VK_NULL_HANDLE on failure
 	 */
 	VkSurfaceKHR create_surface(VkInstance instance, VkPhysicalDevice physical_device) override;
 
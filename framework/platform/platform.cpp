@@ -34,6 +34,7 @@
 #include "platform/filesystem.h"
 #include "platform/parsers/CLI11.h"
 #include "platform/plugins/plugin.h"
+#include "stats/trace_recorder.h"
 #include "vulkan_sample.h"
 
 namespace plugins
@@ -193,6 +194,8 @@ ExitCode Platform::main_loop()
 
 void Platform::update()
 {
+	ScopedTrace trace{"Platform::update"};
+
 	auto delta_time = static_cast<float>(timer.tick<Timer::Seconds>());
 
 	if (focused)
@@ -261,6 +264,16 @@ void Platform::terminate(ExitCode code)
 #endif
 }
 
+void Platform::set_failed()
+{
+	failed = true;
+}
+
+bool Platform::has_failed() const
+{
+	return failed;
+}
+
 void Platform::close()
 {
 	if (window)
@@ -86,6 +86,14 @@ class Platform
 	 */
 	virtual void close();
 
+	/**
+	 * @brief Makes the application exit with a non-zero status once it terminates, without closing it
+	 *        Used by plugins whose checks failed, e.g. a performance regression
+	 */
+	void set_failed();
+
+	bool has_failed() const;
+
 	/**
 	 * @brief Returns the working directory of the application set by the platform
 	 * @returns The path to the working directory
@@ -168,6 +176,7 @@ class Platform
 	bool               process_input_events{true};     /* App should continue processing input events */
 	bool               focused{true};                  /* App is currently in focus at an operating system level */
 	bool               close_requested{false};         /* Close requested */
+	bool               failed{false};                  /* A plugin reported a failure, the exit status is non-zero */
 
   private:
 	Timer timer;
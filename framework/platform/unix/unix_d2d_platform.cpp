@@ -55,7 +55,7 @@ UnixD2DPlatform::UnixD2DPlatform(const PlatformContext &context) :
 
 void UnixD2DPlatform::create_window(const Window::Properties &properties)
 {
-	if (properties.mode == vkb::Window::Mode::Headless)
+	if (properties.mode == vkb::Window::Mode::Headless || properties.mode == vkb::Window::Mode::Offscreen)
 	{
 		window = std::make_unique<HeadlessWindow>(properties);
 	}
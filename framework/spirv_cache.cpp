@@ -0,0 +1,270 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "spirv_cache.h"
+
+#include <cstring>
+#include <set>
+#include <sstream>
+
+#include "common/logging.h"
+#include "platform/filesystem.h"
+
+namespace vkb
+{
+namespace
+{
+// bump whenever the key or the file layout changes, or the SPIR-V generation changes without the key
+constexpr uint32_t cache_version = 1;
+
+constexpr uint32_t cache_magic = 0x53425643;        // "CVBS"
+
+constexpr uint32_t spirv_magic = 0x07230203;
+
+// FNV-1a, stable across runs and platforms unlike std::hash
+constexpr uint64_t fnv_offset_basis = 0xcbf29ce484222325ull;
+constexpr uint64_t fnv_prime        = 0x100000001b3ull;
+
+struct CacheFileHeader
+{
+	uint32_t magic;
+	uint32_t version;
+	uint64_t key;
+	uint64_t word_count;
+};
+
+/**
+ * @brief Returns the file name of an #include directive
+ */
+bool parse_include(const std::string &line, std::string &name)
+{
+	size_t pos = line.find_first_not_of(" \t");
+	if (pos == std::string::npos || line[pos] != '#')
+	{
+		return false;
+	}
+
+	pos = line.find_first_not_of(" \t", pos + 1);
+	if (pos == std::string::npos || line.compare(pos, 7, "include") != 0)
+	{
+		return false;
+	}
+
+	pos = line.find_first_not_of(" \t", pos + 7);
+	if (pos == std::string::npos || (line[pos] != '"' && line[pos] != '<'))
+	{
+		return false;
+	}
+
+	size_t end = line.find(line[pos] == '"' ? '"' : '>', pos + 1);
+	if (end == std::string::npos)
+	{
+		return false;
+	}
+
+	name = line.substr(pos + 1, end - pos - 1);
+	return true;
+}
+
+/**
+ * @brief Hashes the files included by a source, relative to the directory of the including file
+ *        first and then to the shaders directory, like the includer of GLSLCompiler
+ */
+bool hash_includes(const std::string &source, const std::string &directory, std::set<std::string> &included, uint64_t &hash)
+{
+	std::istringstream lines(source);
+	std::string        line;
+	while (std::getline(lines, line))
+	{
+		std::string name;
+		if (!parse_include(line, name))
+		{
+			continue;
+		}
+
+		std::string path = directory + name;
+		if (directory.empty() || !fs::is_file(fs::path::get(fs::path::Type::Shaders, path)))
+		{
+			path = name;
+		}
+
+		// include guards make the content of a repeated include irrelevant
+		if (!included.insert(path).second)
+		{
+			continue;
+		}
+
+		std::string include_source;
+		try
+		{
+			include_source = fs::read_shader(path);
+		}
+		catch (const std::runtime_error &)
+		{
+			return false;
+		}
+
+		hash = SpirvCache::hash(path, hash);
+		hash = SpirvCache::hash(include_source, hash);
+
+		size_t separator = path.find_last_of('/');
+		if (!hash_includes(include_source, separator == std::string::npos ? "" : path.substr(0, separator + 1), included, hash))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}        // namespace
+
+std::mutex SpirvCache::mutex;
+
+std::unordered_map<uint64_t, std::vector<uint32_t>> SpirvCache::entries;
+
+bool SpirvCache::enabled = true;
+
+bool SpirvCache::hash_source(const std::vector<uint8_t> &glsl_source, uint64_t &source_hash)
+{
+	source_hash = hash(glsl_source.data(), glsl_source.size(), fnv_offset_basis);
+
+	std::set<std::string> included;
+	return hash_includes(std::string(glsl_source.begin(), glsl_source.end()), "", included, source_hash);
+}
+
+uint64_t SpirvCache::hash(const void *data, size_t size, uint64_t seed)
+{
+	uint64_t hash  = seed;
+	auto     bytes = static_cast<const uint8_t *>(data);
+	for (size_t i = 0; i < size; ++i)
+	{
+		hash = (hash ^ bytes[i]) * fnv_prime;
+	}
+
+	// the size separates consecutive fields
+	for (size_t i = 0; i < sizeof(uint64_t); ++i)
+	{
+		hash = (hash ^ ((static_cast<uint64_t>(size) >> (8 * i)) & 0xff)) * fnv_prime;
+	}
+	return hash;
+}
+
+uint64_t SpirvCache::hash(const std::string &data, uint64_t seed)
+{
+	return hash(data.data(), data.size(), seed);
+}
+
+bool SpirvCache::load(uint64_t key, std::vector<uint32_t> &spirv)
+{
+	if (!enabled)
+	{
+		return false;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+
+		auto it = entries.find(key);
+		if (it != entries.end())
+		{
+			spirv = it->second;
+			return true;
+		}
+	}
+
+	std::vector<uint8_t> data;
+	try
+	{
+		data = fs::read_cache(get_filename(key));
+	}
+	catch (const std::runtime_error &)
+	{
+		return false;
+	}
+
+	CacheFileHeader header{};
+	if (data.size() < sizeof(header))
+	{
+		return false;
+	}
+	std::memcpy(&header, data.data(), sizeof(header));
+
+	if (header.magic != cache_magic || header.version != cache_version || header.key != key || header.word_count == 0 ||
+	    data.size() != sizeof(header) + header.word_count * sizeof(uint32_t))
+	{
+		LOGW("Ignoring invalid SPIR-V cache entry {}", get_filename(key));
+		return false;
+	}
+
+	spirv.resize(static_cast<size_t>(header.word_count));
+	std::memcpy(spirv.data(), data.data() + sizeof(header), spirv.size() * sizeof(uint32_t));
+	if (spirv[0] != spirv_magic)
+	{
+		LOGW("Ignoring invalid SPIR-V cache entry {}", get_filename(key));
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+	entries.emplace(key, spirv);
+	return true;
+}
+
+void SpirvCache::store(uint64_t key, const std::vector<uint32_t> &spirv)
+{
+	if (!enabled || spirv.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		entries[key] = spirv;
+	}
+
+	CacheFileHeader header{cache_magic, cache_version, key, spirv.size()};
+
+	std::vector<uint8_t> data(sizeof(header) + spirv.size() * sizeof(uint32_t));
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), spirv.data(), spirv.size() * sizeof(uint32_t));
+
+	try
+	{
+		if (!fs::write_cache(data, get_filename(key)))
+		{
+			LOGW("Failed to write SPIR-V cache entry {}", get_filename(key));
+		}
+	}
+	catch (const std::runtime_error &)
+	{
+		LOGW("Failed to write SPIR-V cache entry {}", get_filename(key));
+	}
+}
+
+void SpirvCache::set_enabled(bool enable)
+{
+	enabled = enable;
+}
+
+bool SpirvCache::is_enabled()
+{
+	return enabled;
+}
+
+std::string SpirvCache::get_filename(uint64_t key)
+{
+	return fmt::format("spirv_{:016x}.spv", key);
+}
+}        // namespace vkb
@@ -0,0 +1,82 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Content-addressed cache of the SPIR-V generated by GLSLCompiler
+ *
+ * A compilation is identified by the hash of its source with all includes expanded, and of
+ * the stage, entry point, shader variant and target environment, and of the version of glslang. The SPIR-V is kept in memory
+ * for the rest of the run and stored on disk in the cache directory (output/cache/), so that
+ * warm starts do not have to run glslang at all. Stale entries are never read, since any change
+ * to a shader or one of its includes changes its key; the directory can be deleted at any time.
+ */
+class SpirvCache
+{
+  public:
+	/**
+	 * @brief Hashes the source of a shader together with the sources of all files it includes
+	 * @param glsl_source The GLSL source code
+	 * @param[out] source_hash The hash of the source
+	 * @return False if an included file cannot be read, in which case the shader cannot be cached
+	 */
+	static bool hash_source(const std::vector<uint8_t> &glsl_source, uint64_t &source_hash);
+
+	/**
+	 * @brief Hashes data, continuing from the hash of the previous data
+	 */
+	static uint64_t hash(const void *data, size_t size, uint64_t seed);
+
+	static uint64_t hash(const std::string &data, uint64_t seed);
+
+	/**
+	 * @brief Looks up the SPIR-V of a key in memory and then on disk
+	 * @return True if the SPIR-V was found
+	 */
+	static bool load(uint64_t key, std::vector<uint32_t> &spirv);
+
+	/**
+	 * @brief Stores the SPIR-V of a key in memory and on disk
+	 */
+	static void store(uint64_t key, const std::vector<uint32_t> &spirv);
+
+	/**
+	 * @brief Enables or disables the cache, it is enabled by default
+	 */
+	static void set_enabled(bool enabled);
+
+	static bool is_enabled();
+
+  private:
+	static std::mutex mutex;
+
+	static std::unordered_map<uint64_t, std::vector<uint32_t>> entries;
+
+	static bool enabled;
+
+	static std::string get_filename(uint64_t key);
+};
+}        // namespace vkb
@@ -0,0 +1,251 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pass_statistics_queries.h"
+
+#include <cctype>
+
+#include "common/error.h"
+#include "common/helpers.h"
+#include "common/logging.h"
+#include "core/device.h"
+#include "stats/vulkan_stats_provider.h"
+
+namespace vkb
+{
+namespace
+{
+// statistics collected for every pass, their results follow the order of their bits
+constexpr std::pair<VkQueryPipelineStatisticFlagBits, const char *> pipeline_statistics[] = {
+    {VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT, "clipping_invocations"},
+    {VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT, "clipping_primitives"},
+    {VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT, "fragment_shader_invocations"},
+    {VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT, "compute_shader_invocations"},
+};
+
+std::string to_snake_case(const std::string &name)
+{
+	std::string result;
+	for (char c : name)
+	{
+		if (std::isalnum(static_cast<unsigned char>(c)))
+		{
+			result += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+		}
+		else if (!result.empty() && result.back() != '_')
+		{
+			result += '_';
+		}
+	}
+
+	if (!result.empty() && result.back() == '_')
+	{
+		result.pop_back();
+	}
+	return result;
+}
+}        // namespace
+
+PassStatisticsQueries::PassStatisticsQueries(Device &device, uint32_t queue_family_index, uint32_t pass_count) :
+    device{device},
+    pass_count{pass_count}
+{
+	setup_statistics();
+	setup_counters(queue_family_index);
+}
+
+PassStatisticsQueries::~PassStatisticsQueries()
+{
+	if (statistics_pool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(device.get_handle(), statistics_pool, nullptr);
+	}
+
+	if (counter_pool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(device.get_handle(), counter_pool, nullptr);
+	}
+
+	if (profiling_lock)
+	{
+		vkReleaseProfilingLockKHR(device.get_handle());
+	}
+}
+
+void PassStatisticsQueries::setup_statistics()
+{
+	if (!device.get_gpu().get_requested_features().pipelineStatisticsQuery)
+	{
+		return;
+	}
+
+	VkQueryPipelineStatisticFlags flags = 0;
+	for (auto &statistic : pipeline_statistics)
+	{
+		flags |= statistic.first;
+		statistic_names.push_back(statistic.second);
+	}
+
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.queryType          = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+	query_pool_info.queryCount         = pass_count;
+	query_pool_info.pipelineStatistics = flags;
+
+	VK_CHECK(vkCreateQueryPool(device.get_handle(), &query_pool_info, nullptr, &statistics_pool));
+}
+
+void PassStatisticsQueries::setup_counters(uint32_t queue_family_index)
+{
+	// the device enables both extensions together, only if their features are supported
+	if (!device.is_enabled("VK_KHR_performance_query"))
+	{
+		return;
+	}
+
+	std::vector<VkPerformanceCounterKHR>            counters;
+	std::vector<VkPerformanceCounterDescriptionKHR> descriptions;
+	VulkanStatsProvider::enumerate_counters(device.get_gpu(), queue_family_index, counters, descriptions);
+
+	// passes are submitted once, so only the counters that fit in a single pass are collected
+	VkQueryPoolPerformanceCreateInfoKHR perf_create_info{VK_STRUCTURE_TYPE_QUERY_POOL_PERFORMANCE_CREATE_INFO_KHR};
+	perf_create_info.queueFamilyIndex = queue_family_index;
+
+	for (uint32_t i = 0; i < counters.size(); ++i)
+	{
+		counter_indices.push_back(i);
+		perf_create_info.counterIndexCount = to_u32(counter_indices.size());
+		perf_create_info.pCounterIndices   = counter_indices.data();
+
+		if (device.get_gpu().get_queue_family_performance_query_passes(&perf_create_info) != 1)
+		{
+			counter_indices.pop_back();
+			continue;
+		}
+
+		counter_names.push_back(to_snake_case(descriptions[i].name));
+		counter_storages.push_back(counters[i].storage);
+	}
+
+	if (counter_indices.empty())
+	{
+		return;
+	}
+
+	if (counter_indices.size() < counters.size())
+	{
+		LOGW("Collecting {} of {} performance counters, the others require further passes", counter_indices.size(), counters.size());
+	}
+
+	VkAcquireProfilingLockInfoKHR lock_info{VK_STRUCTURE_TYPE_ACQUIRE_PROFILING_LOCK_INFO_KHR};
+	lock_info.timeout = 2000000000;        // 2 seconds (in ns)
+
+	if (vkAcquireProfilingLockKHR(device.get_handle(), &lock_info) != VK_SUCCESS)
+	{
+		LOGW("Profiling lock acquisition timed-out, no performance counters are collected");
+		counter_indices.clear();
+		counter_names.clear();
+		counter_storages.clear();
+		return;
+	}
+	profiling_lock = true;
+
+	perf_create_info.counterIndexCount = to_u32(counter_indices.size());
+	perf_create_info.pCounterIndices   = counter_indices.data();
+
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.pNext      = &perf_create_info;
+	query_pool_info.queryType  = VK_QUERY_TYPE_PERFORMANCE_QUERY_KHR;
+	query_pool_info.queryCount = pass_count;
+
+	VK_CHECK(vkCreateQueryPool(device.get_handle(), &query_pool_info, nullptr, &counter_pool));
+
+	// performance queries cannot be reset in the command buffer that begins them
+	vkResetQueryPoolEXT(device.get_handle(), counter_pool, 0, pass_count);
+}
+
+bool PassStatisticsQueries::is_available() const
+{
+	return statistics_pool != VK_NULL_HANDLE || counter_pool != VK_NULL_HANDLE;
+}
+
+void PassStatisticsQueries::begin(VkCommandBuffer command_buffer, uint32_t pass)
+{
+	assert(pass < pass_count);
+
+	// counters of command buffer scope have to be begun by the first command
+	if (counter_pool != VK_NULL_HANDLE)
+	{
+		vkCmdBeginQuery(command_buffer, counter_pool, pass, 0);
+	}
+
+	if (statistics_pool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(command_buffer, statistics_pool, pass, 1);
+		vkCmdBeginQuery(command_buffer, statistics_pool, pass, 0);
+	}
+}
+
+void PassStatisticsQueries::end(VkCommandBuffer command_buffer, uint32_t pass)
+{
+	assert(pass < pass_count);
+
+	if (statistics_pool != VK_NULL_HANDLE)
+	{
+		vkCmdEndQuery(command_buffer, statistics_pool, pass);
+	}
+
+	if (counter_pool != VK_NULL_HANDLE)
+	{
+		vkCmdEndQuery(command_buffer, counter_pool, pass);
+	}
+}
+
+std::vector<std::pair<std::string, double>> PassStatisticsQueries::read(uint32_t pass)
+{
+	assert(pass < pass_count);
+
+	std::vector<std::pair<std::string, double>> results;
+
+	if (statistics_pool != VK_NULL_HANDLE)
+	{
+		std::vector<uint64_t> statistics(statistic_names.size());
+		VK_CHECK(vkGetQueryPoolResults(device.get_handle(), statistics_pool, pass, 1, statistics.size() * sizeof(uint64_t),
+		                               statistics.data(), statistics.size() * sizeof(uint64_t),
+		                               VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT));
+
+		for (size_t i = 0; i < statistics.size(); ++i)
+		{
+			results.emplace_back(statistic_names[i], static_cast<double>(statistics[i]));
+		}
+	}
+
+	if (counter_pool != VK_NULL_HANDLE)
+	{
+		std::vector<VkPerformanceCounterResultKHR> counters(counter_indices.size());
+		VK_CHECK(vkGetQueryPoolResults(device.get_handle(), counter_pool, pass, 1, counters.size() * sizeof(VkPerformanceCounterResultKHR),
+		                               counters.data(), counters.size() * sizeof(VkPerformanceCounterResultKHR),
+		                               VK_QUERY_RESULT_WAIT_BIT));
+
+		for (size_t i = 0; i < counters.size(); ++i)
+		{
+			results.emplace_back(counter_names[i], VulkanStatsProvider::get_counter_value(counters[i], counter_storages[i]));
+		}
+	}
+
+	return results;
+}
+}        // namespace vkb
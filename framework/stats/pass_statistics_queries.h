@@ -0,0 +1,108 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Pipeline statistics and performance counter queries of single passes
+ *
+ * Every pass is recorded on its own in a primary command buffer, whose first and last commands
+ * are begin() and end(), so that counters of any scope can be collected. Its results are read
+ * once that command buffer has completed.
+ *
+ * Pipeline statistics require the pipelineStatisticsQuery feature. Performance counters require
+ * VK_KHR_performance_query and VK_EXT_host_query_reset: as many counters of the queue family as
+ * can be collected in a single pass are queried, under the profiling lock held by this object.
+ */
+class PassStatisticsQueries
+{
+  public:
+	/**
+	 * @brief Creates the query pools and acquires the profiling lock
+	 * @param device The device to create the pools on
+	 * @param queue_family_index Queue family the passes are submitted to
+	 * @param pass_count Number of passes, each with its own queries
+	 */
+	PassStatisticsQueries(Device &device, uint32_t queue_family_index, uint32_t pass_count);
+
+	PassStatisticsQueries(const PassStatisticsQueries &) = delete;
+
+	PassStatisticsQueries(PassStatisticsQueries &&) = delete;
+
+	~PassStatisticsQueries();
+
+	PassStatisticsQueries &operator=(const PassStatisticsQueries &) = delete;
+
+	PassStatisticsQueries &operator=(PassStatisticsQueries &&) = delete;
+
+	/**
+	 * @returns True if pipeline statistics or performance counters are collected
+	 */
+	bool is_available() const;
+
+	/**
+	 * @brief Begins the queries of a pass, must be the first command of the command buffer
+	 */
+	void begin(VkCommandBuffer command_buffer, uint32_t pass);
+
+	/**
+	 * @brief Ends the queries of a pass, must be the last command of the command buffer
+	 */
+	void end(VkCommandBuffer command_buffer, uint32_t pass);
+
+	/**
+	 * @brief Reads the results of a completed pass
+	 * @returns The name and value of every statistic and counter, in snake case
+	 */
+	std::vector<std::pair<std::string, double>> read(uint32_t pass);
+
+  private:
+	Device &device;
+
+	uint32_t pass_count;
+
+	VkQueryPool statistics_pool{VK_NULL_HANDLE};
+
+	VkQueryPool counter_pool{VK_NULL_HANDLE};
+
+	bool profiling_lock{false};
+
+	// names of the collected statistics, in the order of their bits
+	std::vector<std::string> statistic_names;
+
+	// index, name and storage of the collected performance counters
+	std::vector<uint32_t> counter_indices;
+
+	std::vector<std::string> counter_names;
+
+	std::vector<VkPerformanceCounterStorageKHR> counter_storages;
+
+	void setup_statistics();
+
+	void setup_counters(uint32_t queue_family_index);
+};
+}        // namespace vkb
@@ -0,0 +1,190 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timestamp_query_ring.h"
+
+#include <algorithm>
+
+#include "common/error.h"
+#include "core/device.h"
+
+namespace vkb
+{
+TimestampQueryRing::TimestampQueryRing(Device &device, uint32_t frame_count, uint32_t queries_per_frame, uint32_t timestamp_valid_bits) :
+    device{device},
+    frame_count{frame_count},
+    queries_per_frame{queries_per_frame},
+    timestamp_period{device.get_gpu().get_properties().limits.timestampPeriod},
+    pending(frame_count, false),
+    results(2 * queries_per_frame)
+{
+	if (timestamp_valid_bits == 0)
+	{
+		throw std::runtime_error("The queue does not support timestamp queries");
+	}
+
+	mask = timestamp_valid_bits >= 64 ? ~0ULL : (1ULL << timestamp_valid_bits) - 1;
+
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	query_pool_info.queryCount = frame_count * queries_per_frame;
+
+	VK_CHECK(vkCreateQueryPool(device.get_handle(), &query_pool_info, nullptr, &handle));
+
+	calibrated = calibrate();
+}
+
+TimestampQueryRing::~TimestampQueryRing()
+{
+	if (handle != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(device.get_handle(), handle, nullptr);
+	}
+}
+
+void TimestampQueryRing::reset(VkCommandBuffer command_buffer, uint32_t frame)
+{
+	vkCmdResetQueryPool(command_buffer, handle, frame * queries_per_frame, queries_per_frame);
+}
+
+void TimestampQueryRing::write(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage, uint32_t frame, uint32_t query)
+{
+	assert(query < queries_per_frame);
+	vkCmdWriteTimestamp(command_buffer, stage, handle, frame * queries_per_frame + query);
+}
+
+void TimestampQueryRing::submitted(uint32_t frame)
+{
+	pending[frame] = true;
+}
+
+void TimestampQueryRing::discard()
+{
+	std::fill(pending.begin(), pending.end(), false);
+}
+
+bool TimestampQueryRing::read(uint32_t frame, uint32_t count, uint64_t *timestamps)
+{
+	assert(count <= queries_per_frame);
+
+	if (!pending[frame])
+	{
+		return false;
+	}
+
+	// Each result is followed by its availability value
+	VkResult result = vkGetQueryPoolResults(device.get_handle(), handle, frame * queries_per_frame, count,
+	                                        count * 2 * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+	                                        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+	if (result != VK_SUCCESS && result != VK_NOT_READY)
+	{
+		VK_CHECK(result);
+	}
+
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		if (results[2 * i + 1] == 0)
+		{
+			return false;
+		}
+		timestamps[i] = results[2 * i] & mask;
+	}
+
+	pending[frame] = false;
+
+	// without calibration the frame ended at the latest just before it is read
+	if (!calibrated && count > 0 && TraceRecorder::is_enabled())
+	{
+		double offset = TraceRecorder::now() - *std::max_element(timestamps, timestamps + count) * timestamp_period * 1e-3;
+		trace_offset  = estimated ? std::min(trace_offset, offset) : offset;
+		estimated     = true;
+	}
+
+	return true;
+}
+
+double TimestampQueryRing::elapsed_ms(uint64_t begin, uint64_t end) const
+{
+	return ((end - begin) & mask) * timestamp_period * 1e-6;
+}
+
+double TimestampQueryRing::to_trace_time(uint64_t timestamp) const
+{
+	return (timestamp & mask) * timestamp_period * 1e-3 + trace_offset;
+}
+
+void TimestampQueryRing::trace(const std::string &name, uint64_t begin, uint64_t end, TraceRecorder::Track track) const
+{
+	if (TraceRecorder::is_enabled())
+	{
+		TraceRecorder::add_event(name, track, to_trace_time(begin), to_trace_time(end));
+	}
+}
+
+bool TimestampQueryRing::calibrate()
+{
+	if (!device.is_enabled(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME))
+	{
+		return false;
+	}
+
+	uint32_t domain_count = 0;
+	VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &domain_count, nullptr));
+	std::vector<VkTimeDomainEXT> domains(domain_count);
+	VK_CHECK(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(device.get_gpu().get_handle(), &domain_count, domains.data()));
+
+	if (std::find(domains.begin(), domains.end(), VK_TIME_DOMAIN_DEVICE_EXT) == domains.end())
+	{
+		return false;
+	}
+
+	// the device domain is the clock of the timestamp queries, the host clock is read around it
+	// instead of being queried in its own domain, which depends on the platform
+	VkCalibratedTimestampInfoEXT timestamp_info{VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT};
+	timestamp_info.timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+
+	uint64_t timestamp     = 0;
+	uint64_t max_deviation = 0;
+
+	double before = TraceRecorder::now();
+	VK_CHECK(vkGetCalibratedTimestampsEXT(device.get_handle(), 1, &timestamp_info, &timestamp, &max_deviation));
+	double after = TraceRecorder::now();
+
+	trace_offset = 0.5 * (before + after) - (timestamp & mask) * timestamp_period * 1e-3;
+	return true;
+}
+
+bool TimestampQueryRing::is_calibrated() const
+{
+	return calibrated;
+}
+
+uint32_t TimestampQueryRing::get_frame_count() const
+{
+	return frame_count;
+}
+
+uint32_t TimestampQueryRing::get_queries_per_frame() const
+{
+	return queries_per_frame;
+}
+
+VkQueryPool TimestampQueryRing::get_handle() const
+{
+	return handle;
+}
+}        // namespace vkb
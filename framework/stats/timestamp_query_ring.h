@@ -0,0 +1,150 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "stats/trace_recorder.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief A timestamp query pool split into one range of queries per frame in flight
+ *
+ * Every command buffer resets and writes only its own range, so the results of a frame
+ * can be read back once its fence has signaled, without waiting on the frames that were
+ * submitted after it. Results are read with VK_QUERY_RESULT_WITH_AVAILABILITY_BIT and
+ * are never waited on.
+ *
+ * For a timeline trace the timestamps are converted to the clock of TraceRecorder. With
+ * VK_EXT_calibrated_timestamps the device clock is sampled between two reads of the host clock,
+ * otherwise the offset is estimated from the host time at which the frames are read, which
+ * follows the end of their last timestamp by at least the latency of the fence.
+ */
+class TimestampQueryRing
+{
+  public:
+	/**
+	 * @brief Creates the query pool
+	 * @param device The device to create the pool on
+	 * @param frame_count Number of ranges, usually the number of draw command buffers
+	 * @param queries_per_frame Number of timestamps in each range
+	 * @param timestamp_valid_bits timestampValidBits of the queue family the timestamps are written on
+	 */
+	TimestampQueryRing(Device &device, uint32_t frame_count, uint32_t queries_per_frame, uint32_t timestamp_valid_bits);
+
+	TimestampQueryRing(const TimestampQueryRing &) = delete;
+
+	TimestampQueryRing(TimestampQueryRing &&) = delete;
+
+	~TimestampQueryRing();
+
+	TimestampQueryRing &operator=(const TimestampQueryRing &) = delete;
+
+	TimestampQueryRing &operator=(TimestampQueryRing &&) = delete;
+
+	/**
+	 * @brief Records the reset of a frame's range, must precede any write to that range
+	 */
+	void reset(VkCommandBuffer command_buffer, uint32_t frame);
+
+	/**
+	 * @brief Records a timestamp write
+	 * @param query Index of the query within the frame's range
+	 */
+	void write(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage, uint32_t frame, uint32_t query);
+
+	/**
+	 * @brief Marks a frame's range as submitted, so that its results are read back
+	 */
+	void submitted(uint32_t frame);
+
+	/**
+	 * @brief Drops the results of all submitted frames, e.g. after the recorded work changed
+	 */
+	void discard();
+
+	/**
+	 * @brief Reads the first count timestamps of a submitted frame without waiting
+	 * @param timestamps Receives count timestamps, masked to the valid bits
+	 * @returns True if the frame was submitted and all its timestamps were available
+	 */
+	bool read(uint32_t frame, uint32_t count, uint64_t *timestamps);
+
+	/**
+	 * @brief Converts the difference of two timestamps to milliseconds
+	 */
+	double elapsed_ms(uint64_t begin, uint64_t end) const;
+
+	/**
+	 * @brief Converts a timestamp to microseconds on the clock of TraceRecorder
+	 */
+	double to_trace_time(uint64_t timestamp) const;
+
+	/**
+	 * @brief Records the range between two timestamps as an event of the trace, if recording is enabled
+	 */
+	void trace(const std::string &name, uint64_t begin, uint64_t end, TraceRecorder::Track track = TraceRecorder::Track::GPU) const;
+
+	/**
+	 * @brief Returns true if the timestamps were calibrated with VK_EXT_calibrated_timestamps
+	 *        The trace times of calibrated rings are on the same clock, even if the rings are written on different queues
+	 */
+	bool is_calibrated() const;
+
+	uint32_t get_frame_count() const;
+
+	uint32_t get_queries_per_frame() const;
+
+	VkQueryPool get_handle() const;
+
+  private:
+	Device &device;
+
+	VkQueryPool handle{VK_NULL_HANDLE};
+
+	uint32_t frame_count;
+
+	uint32_t queries_per_frame;
+
+	uint64_t mask;
+
+	/// Nanoseconds per tick
+	double timestamp_period;
+
+	std::vector<bool> pending;
+
+	/// Microseconds to add to a timestamp converted to microseconds to get the time of TraceRecorder
+	double trace_offset{0.0};
+
+	/// True if trace_offset was measured with VK_EXT_calibrated_timestamps
+	bool calibrated{false};
+
+	/// True once trace_offset holds an estimate
+	bool estimated{false};
+
+	bool calibrate();
+
+	/// Scratch buffer for the interleaved results and availability values
+	std::vector<uint64_t> results;
+};
+}        // namespace vkb
@@ -0,0 +1,331 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timing_statistics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace vkb
+{
+namespace
+{
+// Minimum number of samples for the quartiles to be meaningful
+constexpr size_t min_outlier_samples = 8;
+
+// Two-sided 95% quantile of the normal distribution
+constexpr double z_95 = 1.959964;
+
+/**
+ * @brief Linearly interpolated percentile of an already sorted range
+ */
+double percentile(const std::vector<double> &sorted, double fraction)
+{
+	if (sorted.empty())
+	{
+		return 0.0;
+	}
+
+	double position = fraction * (sorted.size() - 1);
+	size_t index    = static_cast<size_t>(position);
+	if (index + 1 >= sorted.size())
+	{
+		return sorted.back();
+	}
+
+	double weight = position - index;
+	return sorted[index] * (1.0 - weight) + sorted[index + 1] * weight;
+}
+
+/**
+ * @brief Same as percentile, for an unsorted range which is partially reordered in place
+ *        Runs in linear time instead of sorting the whole range
+ */
+double select_percentile(std::vector<double> &values, double fraction)
+{
+	if (values.empty())
+	{
+		return 0.0;
+	}
+
+	double position = fraction * (values.size() - 1);
+	size_t index    = static_cast<size_t>(position);
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	if (index + 1 >= values.size())
+	{
+		return values[index];
+	}
+
+	// after nth_element the next order statistic is the smallest value of the upper part
+	double next   = *std::min_element(values.begin() + index + 1, values.end());
+	double weight = position - index;
+	return values[index] * (1.0 - weight) + next * weight;
+}
+}        // namespace
+
+TimingStatistics::TimingStatistics(size_t capacity) :
+    capacity{std::max<size_t>(capacity, 1)}
+{
+	samples.reserve(this->capacity);
+}
+
+bool TimingStatistics::push(double sample)
+{
+	bool outlier = is_outlier(sample);
+	if (outlier)
+	{
+		++outlier_count;
+	}
+
+	if (samples.size() < capacity)
+	{
+		samples.push_back(sample);
+	}
+	else
+	{
+		samples[head] = sample;
+	}
+	head = (head + 1) % capacity;
+	++push_count;
+
+	if (!fences_valid || ++pushes_since_fences >= fence_refresh_interval)
+	{
+		update_fences();
+	}
+
+	return outlier;
+}
+
+void TimingStatistics::reset()
+{
+	samples.clear();
+	head                = 0;
+	outlier_count       = 0;
+	pushes_since_fences = 0;
+	fences_valid        = false;
+}
+
+void TimingStatistics::set_capacity(size_t new_capacity)
+{
+	capacity = std::max<size_t>(new_capacity, 1);
+	reset();
+	samples.reserve(capacity);
+}
+
+size_t TimingStatistics::size() const
+{
+	return samples.size();
+}
+
+bool TimingStatistics::empty() const
+{
+	return samples.empty();
+}
+
+double TimingStatistics::last() const
+{
+	if (samples.empty())
+	{
+		return 0.0;
+	}
+
+	return samples[(head + capacity - 1) % capacity];
+}
+
+uint64_t TimingStatistics::get_push_count() const
+{
+	return push_count;
+}
+
+uint64_t TimingStatistics::get_outlier_count() const
+{
+	return outlier_count;
+}
+
+std::vector<double> TimingStatistics::get_samples() const
+{
+	if (samples.size() < capacity)
+	{
+		return samples;
+	}
+
+	std::vector<double> ordered;
+	ordered.reserve(samples.size());
+	ordered.insert(ordered.end(), samples.begin() + head, samples.end());
+	ordered.insert(ordered.end(), samples.begin(), samples.begin() + head);
+	return ordered;
+}
+
+TimingStatistics::Summary TimingStatistics::get_summary() const
+{
+	Summary summary;
+	summary.count = samples.size();
+	if (samples.empty())
+	{
+		return summary;
+	}
+
+	std::vector<double> sorted = samples;
+	std::sort(sorted.begin(), sorted.end());
+
+	summary.min    = sorted.front();
+	summary.max    = sorted.back();
+	summary.median = percentile(sorted, 0.5);
+	summary.p90    = percentile(sorted, 0.9);
+	summary.p99    = percentile(sorted, 0.99);
+
+	double sum = 0.0;
+	for (double sample : sorted)
+	{
+		sum += sample;
+	}
+	summary.mean = sum / sorted.size();
+
+	if (sorted.size() > 1)
+	{
+		double squares = 0.0;
+		for (double sample : sorted)
+		{
+			squares += (sample - summary.mean) * (sample - summary.mean);
+		}
+		summary.stddev = std::sqrt(squares / (sorted.size() - 1));
+		summary.ci95   = z_95 * summary.stddev / std::sqrt(static_cast<double>(sorted.size()));
+	}
+
+	if (sorted.size() >= min_outlier_samples)
+	{
+		double q1  = percentile(sorted, 0.25);
+		double q3  = percentile(sorted, 0.75);
+		double iqr = q3 - q1;
+
+		summary.outliers = std::count_if(sorted.begin(), sorted.end(), [&](double sample) {
+			return sample < q1 - 1.5 * iqr || sample > q3 + 1.5 * iqr;
+		});
+	}
+
+	return summary;
+}
+
+bool TimingStatistics::is_outlier(double value) const
+{
+	if (!fences_valid)
+	{
+		return false;
+	}
+
+	return value < low_fence || value > high_fence;
+}
+
+bool TimingStatistics::is_converged(double relative_precision, size_t min_samples) const
+{
+	if (samples.size() < std::max<size_t>(min_samples, 2))
+	{
+		return false;
+	}
+
+	auto summary = get_summary();
+	if (summary.mean <= 0.0)
+	{
+		return false;
+	}
+
+	return summary.ci95 / summary.mean <= relative_precision;
+}
+
+double TimingStatistics::mann_whitney_greater(const std::vector<double> &a, const std::vector<double> &b)
+{
+	if (a.empty() || b.empty())
+	{
+		return 1.0;
+	}
+
+	// pooled values, flagged with whether they belong to a
+	std::vector<std::pair<double, bool>> pooled;
+	pooled.reserve(a.size() + b.size());
+	for (double value : a)
+	{
+		pooled.emplace_back(value, true);
+	}
+	for (double value : b)
+	{
+		pooled.emplace_back(value, false);
+	}
+	std::sort(pooled.begin(), pooled.end());
+
+	// tied values share the mean of their ranks
+	double rank_sum = 0.0;
+	double ties     = 0.0;
+	for (size_t i = 0; i < pooled.size();)
+	{
+		size_t j = i;
+		while (j < pooled.size() && pooled[j].first == pooled[i].first)
+		{
+			++j;
+		}
+
+		double rank = 0.5 * static_cast<double>(i + 1 + j);
+		for (size_t k = i; k < j; ++k)
+		{
+			if (pooled[k].second)
+			{
+				rank_sum += rank;
+			}
+		}
+
+		double count = static_cast<double>(j - i);
+		ties += count * count * count - count;
+		i = j;
+	}
+
+	double n1 = static_cast<double>(a.size());
+	double n2 = static_cast<double>(b.size());
+	double n  = n1 + n2;
+
+	double u        = rank_sum - n1 * (n1 + 1.0) / 2.0;
+	double mean     = n1 * n2 / 2.0;
+	double variance = n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)));
+	if (variance <= 0.0)
+	{
+		// all values are equal
+		return 1.0;
+	}
+
+	// upper tail of the normal distribution, with continuity correction
+	double z = (u - mean - 0.5) / std::sqrt(variance);
+	return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+void TimingStatistics::update_fences()
+{
+	pushes_since_fences = 0;
+	fences_valid        = samples.size() >= min_outlier_samples;
+	if (!fences_valid)
+	{
+		return;
+	}
+
+	std::vector<double> values = samples;
+
+	double q1  = select_percentile(values, 0.25);
+	double q3  = select_percentile(values, 0.75);
+	double iqr = q3 - q1;
+
+	low_fence  = q1 - 1.5 * iqr;
+	high_fence = q3 + 1.5 * iqr;
+}
+}        // namespace vkb
@@ -0,0 +1,164 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Keeps the most recent timing samples of a measurement in a bounded ring
+ *        and derives order statistics, dispersion and a confidence interval from them
+ *
+ * Outliers are detected with Tukey fences (1.5 interquartile ranges outside the quartiles).
+ * The fences are refreshed every few pushes rather than on every push, so that pushing
+ * a sample stays cheap for large rings.
+ * A measurement is considered converged when the 95% confidence interval of the mean
+ * is narrower than a requested fraction of the mean.
+ */
+class TimingStatistics
+{
+  public:
+	struct Summary
+	{
+		size_t count{0};
+
+		double min{0.0};
+
+		double max{0.0};
+
+		double mean{0.0};
+
+		double median{0.0};
+
+		double p90{0.0};
+
+		double p99{0.0};
+
+		double stddev{0.0};
+
+		/// Half width of the 95% confidence interval of the mean
+		double ci95{0.0};
+
+		/// Number of samples in the ring outside of the Tukey fences
+		size_t outliers{0};
+	};
+
+	/**
+	 * @brief Constructs an empty TimingStatistics
+	 * @param capacity Maximum number of samples kept, older samples are overwritten
+	 */
+	explicit TimingStatistics(size_t capacity = 1024);
+
+	/**
+	 * @brief Adds a sample, overwriting the oldest one if the ring is full
+	 * @param sample The measured value
+	 * @returns True if the sample is an outlier with respect to the samples already in the ring
+	 */
+	bool push(double sample);
+
+	/**
+	 * @brief Removes all samples
+	 */
+	void reset();
+
+	/**
+	 * @brief Changes the capacity of the ring, dropping all samples
+	 */
+	void set_capacity(size_t capacity);
+
+	size_t size() const;
+
+	bool empty() const;
+
+	/**
+	 * @returns The most recently pushed sample, or 0 if the ring is empty
+	 */
+	double last() const;
+
+	/**
+	 * @returns The number of samples pushed since construction, not cleared by reset()
+	 *          Readers compare it to the count they last saw to tell whether a new sample was pushed
+	 */
+	uint64_t get_push_count() const;
+
+	/**
+	 * @returns The number of pushed samples flagged as outliers since the last reset
+	 */
+	uint64_t get_outlier_count() const;
+
+	/**
+	 * @returns The samples in the ring, oldest first
+	 */
+	std::vector<double> get_samples() const;
+
+	/**
+	 * @brief Computes the statistics of the samples currently in the ring
+	 */
+	Summary get_summary() const;
+
+	/**
+	 * @brief Checks a value against the Tukey fences of the samples in the ring
+	 *        The fences lag behind the ring by at most fence_refresh_interval pushes
+	 * @returns False while the ring holds fewer than 8 samples
+	 */
+	bool is_outlier(double value) const;
+
+	/**
+	 * @brief Checks whether the mean is known precisely enough to stop measuring
+	 * @param relative_precision Maximum ratio of the 95% confidence interval half width to the mean
+	 * @param min_samples Minimum number of samples required before converging
+	 */
+	bool is_converged(double relative_precision, size_t min_samples = 30) const;
+
+	/**
+	 * @brief One-sided Mann-Whitney U test of whether the values of a tend to be larger than the values of b
+	 *        Makes no assumption about the distribution of the values, which is rarely normal for frame times
+	 * @returns The p-value from the normal approximation of U with tie correction, 1 if either set is empty
+	 */
+	static double mann_whitney_greater(const std::vector<double> &a, const std::vector<double> &b);
+
+	/// Number of pushes after which the Tukey fences are recomputed
+	static constexpr size_t fence_refresh_interval = 16;
+
+  private:
+	std::vector<double> samples;
+
+	size_t capacity;
+
+	/// Index the next sample will be written to
+	size_t head{0};
+
+	uint64_t outlier_count{0};
+
+	uint64_t push_count{0};
+
+	/// Pushes since the fences were last computed
+	size_t pushes_since_fences{0};
+
+	bool fences_valid{false};
+
+	double low_fence{0.0};
+
+	double high_fence{0.0};
+
+	void update_fences();
+};
+}        // namespace vkb
@@ -0,0 +1,78 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "trace_recorder.h"
+
+#include <chrono>
+
+namespace vkb
+{
+bool TraceRecorder::enabled = false;
+
+std::mutex TraceRecorder::mutex;
+
+std::vector<TraceRecorder::Event> TraceRecorder::events;
+
+void TraceRecorder::set_enabled(bool enabled)
+{
+	TraceRecorder::enabled = enabled;
+}
+
+bool TraceRecorder::is_enabled()
+{
+	return enabled;
+}
+
+double TraceRecorder::now()
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void TraceRecorder::add_event(const std::string &name, Track track, double begin, double end)
+{
+	if (!enabled)
+	{
+		return;
+	}
+
+	std::lock_guard<std::mutex> lock{mutex};
+	events.push_back({name, track, begin, end - begin});
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::get_events()
+{
+	std::lock_guard<std::mutex> lock{mutex};
+	return events;
+}
+
+ScopedTrace::ScopedTrace(const char *name) :
+    name{name}
+{
+	if (TraceRecorder::is_enabled())
+	{
+		begin = TraceRecorder::now();
+	}
+}
+
+ScopedTrace::~ScopedTrace()
+{
+	if (TraceRecorder::is_enabled() && begin > 0.0)
+	{
+		TraceRecorder::add_event(name, TraceRecorder::Track::CPU, begin, TraceRecorder::now());
+	}
+}
+}        // namespace vkb
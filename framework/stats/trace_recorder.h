@@ -0,0 +1,109 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace vkb
+{
+/**
+ * @brief Records the CPU and GPU events of the frames for a timeline trace
+ *
+ * CPU events are the scopes of ScopedTrace objects, GPU events are timestamp ranges converted
+ * to the clock of the recorder (see TimestampQueryRing::to_trace_time()). Both are kept in memory
+ * until written, for example as Chrome JSON trace events to be opened in Perfetto.
+ *
+ * Recording is disabled by default, events are then dropped without taking the lock.
+ */
+class TraceRecorder
+{
+  public:
+	enum class Track
+	{
+		CPU,
+		GPU,
+		AsyncCompute,
+	};
+
+	struct Event
+	{
+		std::string name;
+
+		Track track;
+
+		/// Start and duration in microseconds on the clock of the recorder
+		double begin;
+
+		double duration;
+	};
+
+	static void set_enabled(bool enabled);
+
+	static bool is_enabled();
+
+	/**
+	 * @brief Returns the current time in microseconds on the clock of the recorder, the steady clock
+	 */
+	static double now();
+
+	/**
+	 * @brief Records an event if recording is enabled
+	 * @param begin Start in microseconds on the clock of the recorder
+	 * @param end End in microseconds on the clock of the recorder
+	 */
+	static void add_event(const std::string &name, Track track, double begin, double end);
+
+	/**
+	 * @brief Returns the events recorded so far, in the order they were added
+	 */
+	static std::vector<Event> get_events();
+
+  private:
+	static bool enabled;
+
+	static std::mutex mutex;
+
+	static std::vector<Event> events;
+};
+
+/**
+ * @brief Records a CPU event spanning the lifetime of the object
+ */
+class ScopedTrace
+{
+  public:
+	explicit ScopedTrace(const char *name);
+
+	ScopedTrace(const ScopedTrace &) = delete;
+
+	ScopedTrace(ScopedTrace &&) = delete;
+
+	~ScopedTrace();
+
+	ScopedTrace &operator=(const ScopedTrace &) = delete;
+
+	ScopedTrace &operator=(ScopedTrace &&) = delete;
+
+  private:
+	const char *name;
+
+	double begin{0.0};
+};
+}        // namespace vkb
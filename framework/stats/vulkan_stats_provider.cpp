@@ -45,31 +45,15 @@ VulkanStatsProvider::VulkanStatsProvider(std::set<StatIndex>         &requested_
 	// Interrogate device for supported stats
 	uint32_t queue_family_index = device.get_queue_family_index(VK_QUEUE_GRAPHICS_BIT);
 
-	// Query number of available counters
-	uint32_t count = 0;
-	gpu.enumerate_queue_family_performance_query_counters(queue_family_index, &count,
-	                                                      nullptr, nullptr);
+	std::vector<VkPerformanceCounterKHR>            counters;
+	std::vector<VkPerformanceCounterDescriptionKHR> descs;
+	enumerate_counters(gpu, queue_family_index, counters, descs);
 
-	if (count == 0)
+	if (counters.empty())
 	{
 		return;        // No counters available
 	}
 
-	std::vector<VkPerformanceCounterKHR>            counters(count);
-	std::vector<VkPerformanceCounterDescriptionKHR> descs(count);
-
-	for (uint32_t i = 0; i < count; i++)
-	{
-		counters[i].sType = VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR;
-		counters[i].pNext = nullptr;
-		descs[i].sType    = VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR;
-		descs[i].pNext    = nullptr;
-	}
-
-	// Now get the list of counters and their descriptions
-	gpu.enumerate_queue_family_performance_query_counters(queue_family_index, &count,
-	                                                      counters.data(), descs.data());
-
 	// Every vendor has a different set of performance counters each
 	// with different names. Match them to the stats we want, where available.
 	if (!fill_vendor_data())
@@ -381,8 +365,38 @@ void VulkanStatsProvider::end_sampling(CommandBuffer &cb)
 	}
 }
 
-static double get_counter_value(const VkPerformanceCounterResultKHR &result,
-                                VkPerformanceCounterStorageKHR       storage)
+void VulkanStatsProvider::enumerate_counters(const PhysicalDevice &gpu, uint32_t queue_family_index,
+                                             std::vector<VkPerformanceCounterKHR>            &counters,
+                                             std::vector<VkPerformanceCounterDescriptionKHR> &descriptions)
+{
+	// Query number of available counters
+	uint32_t count = 0;
+	gpu.enumerate_queue_family_performance_query_counters(queue_family_index, &count,
+	                                                      nullptr, nullptr);
+
+	counters.resize(count);
+	descriptions.resize(count);
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		counters[i].sType     = VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_KHR;
+		counters[i].pNext     = nullptr;
+		descriptions[i].sType = VK_STRUCTURE_TYPE_PERFORMANCE_COUNTER_DESCRIPTION_KHR;
+		descriptions[i].pNext = nullptr;
+	}
+
+	if (count == 0)
+	{
+		return;
+	}
+
+	// Now get the list of counters and their descriptions
+	gpu.enumerate_queue_family_performance_query_counters(queue_family_index, &count,
+	                                                      counters.data(), descriptions.data());
+}
+
+double VulkanStatsProvider::get_counter_value(const VkPerformanceCounterResultKHR &result,
+                                              VkPerformanceCounterStorageKHR       storage)
 {
 	switch (storage)
 	{
@@ -22,6 +22,7 @@
 
 namespace vkb
 {
+class PhysicalDevice;
 class RenderContext;
 
 class VulkanStatsProvider : public StatsProvider
@@ -122,6 +123,25 @@ class VulkanStatsProvider : public StatsProvider
 	 */
 	void end_sampling(CommandBuffer &cb) override;
 
+	/**
+	 * @brief Enumerates the performance counters of a queue family
+	 * @param gpu The physical device, VK_KHR_performance_query must be available
+	 * @param queue_family_index The queue family the counters are collected on
+	 * @param counters Receives the counters
+	 * @param descriptions Receives the description of each counter
+	 */
+	static void enumerate_counters(const PhysicalDevice &gpu, uint32_t queue_family_index,
+	                               std::vector<VkPerformanceCounterKHR>            &counters,
+	                               std::vector<VkPerformanceCounterDescriptionKHR> &descriptions);
+
+	/**
+	 * @brief Converts a performance counter result to a double
+	 * @param result The result of the counter
+	 * @param storage The storage of the counter
+	 */
+	static double get_counter_value(const VkPerformanceCounterResultKHR &result,
+	                                VkPerformanceCounterStorageKHR       storage);
+
   private:
 	bool is_supported(const CounterSamplingConfig &sampling_config) const;
 
@@ -87,7 +87,8 @@ bool VulkanSample::prepare(const ApplicationOptions &options)
 
 	LOGI("Initializing Vulkan sample");
 
-	bool headless = window->get_window_mode() == Window::Mode::Headless;
+	// offscreen samples run without a surface, like headless ones without VK_EXT_headless_surface
+	bool headless = window->get_window_mode() == Window::Mode::Headless || window->get_window_mode() == Window::Mode::Offscreen;
 
 	VkResult result = volkInitialize();
 	if (result)
@@ -134,7 +135,7 @@ bool VulkanSample::prepare(const ApplicationOptions &options)
 
 	// Getting a valid vulkan surface from the platform
 	surface = window->create_surface(*instance);
-	if (!surface)
+	if (!surface && !headless)
 	{
 		throw std::runtime_error("Failed to create window surface.");
 	}
@@ -0,0 +1,145 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "workgroup_database.h"
+
+#include "common/logging.h"
+#include "platform/filesystem.h"
+
+namespace vkb
+{
+namespace
+{
+// Tuning database in the cache directory
+constexpr const char *database_filename = "workgroup_tuning.json";
+
+constexpr int database_version = 1;
+
+nlohmann::json read_database()
+{
+	auto data = fs::read_cache(database_filename);
+	if (data.empty())
+	{
+		return {};
+	}
+
+	auto database = nlohmann::json::parse(data.begin(), data.end(), nullptr, false);
+	if (database.is_discarded() || !database.is_object() || database.value("version", 0) != database_version ||
+	    !database.value("devices", nlohmann::json::object()).is_object())
+	{
+		LOGW("Ignoring invalid workgroup tuning database {}", database_filename);
+		return {};
+	}
+	return database;
+}
+}        // namespace
+
+VkExtent2D WorkgroupConfig::get_tile_extent() const
+{
+	return {width * pixels_per_thread, height};
+}
+
+bool WorkgroupConfig::operator==(const WorkgroupConfig &other) const
+{
+	return width == other.width && height == other.height && pixels_per_thread == other.pixels_per_thread;
+}
+
+WorkgroupDatabase::WorkgroupDatabase(const std::string &device_key, const std::string &device_name) :
+    device_key{device_key},
+    device_name{device_name}
+{
+	auto database = read_database();
+	if (database.contains("devices") && database["devices"].contains(device_key))
+	{
+		entries = database["devices"][device_key].value("passes", nlohmann::json::object());
+	}
+}
+
+bool WorkgroupDatabase::find(const std::string &key, WorkgroupConfig &config) const
+{
+	if (!entries.is_object() || !entries.contains(key))
+	{
+		return false;
+	}
+
+	try
+	{
+		auto &entry = entries.at(key);
+
+		// negative sizes would wrap around when read as unsigned
+		for (auto field : {"width", "height", "pixels_per_thread"})
+		{
+			if (!entry.at(field).is_number_unsigned())
+			{
+				return false;
+			}
+		}
+
+		WorkgroupConfig found{entry.at("width").get<uint32_t>(), entry.at("height").get<uint32_t>(), entry.at("pixels_per_thread").get<uint32_t>()};
+		if (found.width == 0 || found.height == 0 || found.pixels_per_thread == 0)
+		{
+			return false;
+		}
+
+		config = found;
+		return true;
+	}
+	catch (const nlohmann::json::exception &)
+	{
+		return false;
+	}
+}
+
+void WorkgroupDatabase::store(const std::string &key, const WorkgroupConfig &config, double time)
+{
+	if (!entries.is_object())
+	{
+		entries = nlohmann::json::object();
+	}
+
+	entries[key] = {{"width", config.width}, {"height", config.height}, {"pixels_per_thread", config.pixels_per_thread}, {"time_ms", time}};
+
+	// read again, other runs may have tuned other devices or passes in the meantime
+	auto database = read_database();
+	if (!database.is_object())
+	{
+		database = {{"version", database_version}, {"devices", nlohmann::json::object()}};
+	}
+
+	auto &device_entry     = database["devices"][device_key];
+	device_entry["device"] = device_name;
+
+	auto &passes = device_entry["passes"];
+	for (auto &entry : entries.items())
+	{
+		passes[entry.key()] = entry.value();
+	}
+
+	std::string text = database.dump(2);
+	try
+	{
+		if (!fs::write_cache(std::vector<uint8_t>(text.begin(), text.end()), database_filename))
+		{
+			LOGW("Failed to write the workgroup tuning database {}", database_filename);
+		}
+	}
+	catch (const std::runtime_error &)
+	{
+		LOGW("Failed to write the workgroup tuning database {}", database_filename);
+	}
+}
+}        // namespace vkb
@@ -0,0 +1,85 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <json.hpp>
+
+#include "common/vk_common.h"
+
+namespace vkb
+{
+/**
+ * @brief Shape of the workgroups of a compute pass, passed to its shader as specialization constants
+ */
+struct WorkgroupConfig
+{
+	uint32_t width{16};
+
+	uint32_t height{16};
+
+	/// Pixels each invocation writes along a row, gl_WorkGroupSize.x apart
+	uint32_t pixels_per_thread{1};
+
+	/**
+	 * @brief Returns the pixels written by a single workgroup
+	 */
+	VkExtent2D get_tile_extent() const;
+
+	bool operator==(const WorkgroupConfig &other) const;
+};
+
+/**
+ * @brief Tuned workgroup configurations of a device, stored in the tuning database in the cache directory
+ *
+ * The database (workgroup_tuning.json) holds the passes of every device it was tuned on, keyed by
+ * a string identifying the device and its driver. Databases of another version, or that cannot be
+ * parsed, are ignored and replaced on the next store.
+ */
+class WorkgroupDatabase
+{
+  public:
+	/**
+	 * @brief Loads the entries of a device from the tuning database
+	 * @param device_key Identifies the device and its driver, e.g. its deviceUUID and driver version
+	 * @param device_name Name of the device, stored next to its entries for reference
+	 */
+	WorkgroupDatabase(const std::string &device_key, const std::string &device_name);
+
+	/**
+	 * @brief Looks up the configuration of a pass
+	 * @return True if the pass has a complete entry with non-zero sizes
+	 */
+	bool find(const std::string &key, WorkgroupConfig &config) const;
+
+	/**
+	 * @brief Stores the configuration of a pass and writes the database, keeping the entries other runs wrote
+	 * @param time GPU time in ms of the configuration, for reference
+	 */
+	void store(const std::string &key, const WorkgroupConfig &config, double time);
+
+  private:
+	std::string device_key;
+
+	std::string device_name;
+
+	// entries of the device, by pass key
+	nlohmann::json entries;
+};
+}        // namespace vkb
@@ -0,0 +1,218 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "workgroup_tuner.h"
+
+#include <algorithm>
+
+#include "core/device.h"
+
+namespace vkb
+{
+namespace
+{
+// Dispatches of a candidate that are not timed, e.g. while the device raises its clocks
+constexpr uint32_t warmup_dispatches = 2;
+
+constexpr uint32_t timed_dispatches = 5;
+
+std::string get_device_key(Device &device)
+{
+	return fmt::format("{}_{}", device.get_gpu().get_uuid(), device.get_gpu().get_properties().driverVersion);
+}
+}        // namespace
+
+bool WorkgroupTuner::enabled = false;
+
+WorkgroupTuner::WorkgroupTuner(Device &device) :
+    device{device},
+    database{get_device_key(device), device.get_gpu().get_properties().deviceName}
+{
+}
+
+bool WorkgroupTuner::find(const std::string &key, WorkgroupConfig &config) const
+{
+	WorkgroupConfig found;
+	if (!database.find(key, found))
+	{
+		return false;
+	}
+
+	// e.g. an entry written by another version of the samples
+	auto &limits = device.get_gpu().get_properties().limits;
+	if (found.width > limits.maxComputeWorkGroupSize[0] || found.height > limits.maxComputeWorkGroupSize[1] ||
+	    found.width * found.height > limits.maxComputeWorkGroupInvocations)
+	{
+		return false;
+	}
+
+	config = found;
+	return true;
+}
+
+WorkgroupConfig WorkgroupTuner::tune(const std::string &key, const WorkgroupConfig &default_config,
+                                     const CreatePipeline &create_pipeline, const RecordDispatch &record_dispatch)
+{
+	WorkgroupConfig best_config  = default_config;
+	double          best_time    = -1.0;
+	double          default_time = -1.0;
+
+	auto candidates = get_candidates(default_config);
+	for (auto &candidate : candidates)
+	{
+		VkPipeline pipeline = create_pipeline(candidate);
+		if (pipeline == VK_NULL_HANDLE)
+		{
+			continue;
+		}
+
+		double time = measure(pipeline, candidate, record_dispatch);
+		vkDestroyPipeline(device.get_handle(), pipeline, nullptr);
+
+		if (time < 0.0)
+		{
+			continue;
+		}
+
+		if (candidate == default_config)
+		{
+			default_time = time;
+		}
+
+		if (best_time < 0.0 || time < best_time)
+		{
+			best_config = candidate;
+			best_time   = time;
+		}
+	}
+
+	if (best_time < 0.0)
+	{
+		LOGW("Failed to tune {}, keeping workgroups of {}x{}", key, default_config.width, default_config.height);
+		return default_config;
+	}
+
+	LOGI("Tuned {} over {} candidates: workgroups of {}x{} with {} pixels per thread, {:.4f} ms against {:.4f} ms untuned",
+	     key, candidates.size(), best_config.width, best_config.height, best_config.pixels_per_thread, best_time, default_time);
+
+	database.store(key, best_config, best_time);
+	return best_config;
+}
+
+void WorkgroupTuner::set_enabled(bool enable)
+{
+	enabled = enable;
+}
+
+bool WorkgroupTuner::is_enabled()
+{
+	return enabled;
+}
+
+std::vector<WorkgroupConfig> WorkgroupTuner::get_candidates(const WorkgroupConfig &default_config) const
+{
+	auto &limits = device.get_gpu().get_properties().limits;
+
+	// the default configuration comes first, so it is kept on ties
+	std::vector<WorkgroupConfig> candidates{default_config};
+
+	// shapes of one to eight wavefronts of 32, from square to a single row
+	for (uint32_t invocations : {64u, 128u, 256u})
+	{
+		for (uint32_t width = 4; width <= invocations; width *= 2)
+		{
+			uint32_t height = invocations / width;
+			if (height > 16 || invocations > limits.maxComputeWorkGroupInvocations ||
+			    width > limits.maxComputeWorkGroupSize[0] || height > limits.maxComputeWorkGroupSize[1])
+			{
+				continue;
+			}
+
+			for (uint32_t pixels_per_thread : {1u, 2u, 4u})
+			{
+				WorkgroupConfig candidate{width, height, pixels_per_thread};
+				if (!(candidate == default_config))
+				{
+					candidates.push_back(candidate);
+				}
+			}
+		}
+	}
+	return candidates;
+}
+
+double WorkgroupTuner::measure(VkPipeline pipeline, const WorkgroupConfig &config, const RecordDispatch &record_dispatch)
+{
+	auto &queue = device.get_queue_by_flags(VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT, 0);
+
+	uint32_t valid_bits = queue.get_properties().timestampValidBits;
+	if (valid_bits == 0)
+	{
+		return -1.0;
+	}
+
+	VkQueryPoolCreateInfo query_pool_info{VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO};
+	query_pool_info.queryType  = VK_QUERY_TYPE_TIMESTAMP;
+	query_pool_info.queryCount = 2 * timed_dispatches;
+
+	VkQueryPool query_pool = VK_NULL_HANDLE;
+	VK_CHECK(vkCreateQueryPool(device.get_handle(), &query_pool_info, nullptr, &query_pool));
+
+	VkCommandBuffer cmd = device.create_command_buffer(VK_COMMAND_BUFFER_LEVEL_PRIMARY, true);
+	vkCmdResetQueryPool(cmd, query_pool, 0, query_pool_info.queryCount);
+
+	// the barriers of a dispatch are timed with it, they are the same for every candidate
+	for (uint32_t i = 0; i < warmup_dispatches + timed_dispatches; ++i)
+	{
+		if (i >= warmup_dispatches)
+		{
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, 2 * (i - warmup_dispatches));
+		}
+		record_dispatch(cmd, pipeline, config);
+		if (i >= warmup_dispatches)
+		{
+			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 2 * (i - warmup_dispatches) + 1);
+		}
+	}
+
+	device.flush_command_buffer(cmd, queue.get_handle());
+
+	std::vector<uint64_t> timestamps(query_pool_info.queryCount);
+	VkResult              result = vkGetQueryPoolResults(device.get_handle(), query_pool, 0, query_pool_info.queryCount,
+	                                                     timestamps.size() * sizeof(uint64_t), timestamps.data(), sizeof(uint64_t),
+	                                                     VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
+	vkDestroyQueryPool(device.get_handle(), query_pool, nullptr);
+
+	if (result != VK_SUCCESS)
+	{
+		return -1.0;
+	}
+
+	uint64_t mask   = valid_bits < 64 ? (uint64_t{1} << valid_bits) - 1 : ~uint64_t{0};
+	double   period = device.get_gpu().get_properties().limits.timestampPeriod;
+
+	std::vector<double> times;
+	for (uint32_t i = 0; i < timed_dispatches; ++i)
+	{
+		times.push_back(static_cast<double>((timestamps[2 * i + 1] - timestamps[2 * i]) & mask) * period * 1e-6);
+	}
+
+	std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+	return times[times.size() / 2];
+}
+
+}        // namespace vkb
@@ -0,0 +1,104 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/vk_common.h"
+#include "workgroup_database.h"
+
+namespace vkb
+{
+class Device;
+
+/**
+ * @brief Searches the workgroup shape and pixels per thread of compute passes on the current device
+ *
+ * Every candidate is created as a compute pipeline and dispatched a few times between timestamps,
+ * the fastest one is stored in the tuning database (see WorkgroupDatabase) in output/cache/. Entries are
+ * keyed by the deviceUUID and driver version of the device and by a key the sample chooses for the
+ * pass, so later runs on the same device find the tuned configuration without tuning again.
+ *
+ * The database is always read, tuning only runs when enabled (see set_enabled). Passes are tuned at
+ * the resolution the sample filters at when it first needs the configuration.
+ */
+class WorkgroupTuner
+{
+  public:
+	/// Creates the pipeline of a candidate, or returns null if the candidate is not supported
+	using CreatePipeline = std::function<VkPipeline(const WorkgroupConfig &)>;
+
+	/// Records the dispatch of a candidate, with the barriers it needs
+	using RecordDispatch = std::function<void(VkCommandBuffer, VkPipeline, const WorkgroupConfig &)>;
+
+	/**
+	 * @brief Loads the entries of the device from the tuning database
+	 * @param device The device the passes are tuned on, its graphics and compute queue runs the candidates
+	 */
+	WorkgroupTuner(Device &device);
+
+	WorkgroupTuner(const WorkgroupTuner &) = delete;
+
+	WorkgroupTuner(WorkgroupTuner &&) = delete;
+
+	~WorkgroupTuner() = default;
+
+	WorkgroupTuner &operator=(const WorkgroupTuner &) = delete;
+
+	WorkgroupTuner &operator=(WorkgroupTuner &&) = delete;
+
+	/**
+	 * @brief Looks up the tuned configuration of a pass
+	 * @return True if the pass was tuned on this device and driver
+	 */
+	bool find(const std::string &key, WorkgroupConfig &config) const;
+
+	/**
+	 * @brief Times every candidate within the limits of the device and stores the fastest one
+	 * @param key Identifies the pass, including everything that changes its shader
+	 * @param default_config The configuration the pass uses untuned, always a candidate
+	 * @return The fastest configuration, the default one if no candidate could be timed
+	 */
+	WorkgroupConfig tune(const std::string &key, const WorkgroupConfig &default_config,
+	                     const CreatePipeline &create_pipeline, const RecordDispatch &record_dispatch);
+
+	/**
+	 * @brief Enables or disables tuning the passes that have no entry in the database, it is disabled by default
+	 */
+	static void set_enabled(bool enabled);
+
+	static bool is_enabled();
+
+  private:
+	static bool enabled;
+
+	Device &device;
+
+	// entries of the device, keyed by its deviceUUID and driver version
+	WorkgroupDatabase database;
+
+	std::vector<WorkgroupConfig> get_candidates(const WorkgroupConfig &default_config) const;
+
+	/**
+	 * @brief Returns the median GPU time in ms of the dispatches of a candidate, or a negative value if it failed
+	 */
+	double measure(VkPipeline pipeline, const WorkgroupConfig &config, const RecordDispatch &record_dispatch);
+};
+}        // namespace vkb
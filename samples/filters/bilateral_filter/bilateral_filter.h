@@ -17,137 +17,36 @@
 
 #pragma once
 
-#include "api_vulkan_sample.h"
+#include "filter_sample.h"
 
-class BilateralFilter : public ApiVulkanSample
+/**
+ * @brief Compares fragment and compute bilateral filters, including compute filters that load the tile
+ *        of their workgroup into shared memory, with a variant per workgroup size
+ */
+class BilateralFilter : public FilterSample
 {
-public:
+  public:
 	BilateralFilter();
-	virtual ~BilateralFilter();
-
-	// Override basic framework functionality
-	virtual void build_command_buffers() override;
-	virtual void render(float delta_time) override;
-	virtual bool prepare(const vkb::ApplicationOptions &options) override;
-	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
-	virtual bool resize(uint32_t width, uint32_t height) override;
-	virtual void setup_framebuffer() override;
-	virtual void setup_render_pass() override;
-private:
-	static constexpr std::string_view texture_path = "textures/Lenna.ktx";
-
-	// Sample specific data
-	uint32_t pipeline_id = 0; // same for all shader kinds
-
-	// how many shaders of each kind
-	static constexpr uint32_t window_count = 3;
-
-	// compute shaders and pipelines
-	static constexpr std::string_view bilateral_filter_comp_path = 
-		"bilateral_filter/bilateral_compute_template.comp";
-	static constexpr uint32_t workgroup_axis_size = 16u;
-	std::array<VkPipeline, window_count> bilateral_filter_comp_pipelines {};
-
-	// common vertex shader for default, optimized and resolve shaders
-	static constexpr std::string_view vertex_shader_path = "quad3_vert.vert";
-	
-	// default frag shaders and pipelines
-	static constexpr std::string_view bilateral_filter_def_path = "bilateral_filter/bilateral_default_template.frag";
-	std::array<VkPipeline, window_count> bilateral_filter_def_pipelines {};
-	
-	// optimized frag shaders and pipelines
-	static constexpr std::array<std::string_view, window_count> fragment_shaders_optimized_path = 
-	{
-		"bilateral_filter/bilateral_optimized_3x3.frag",
-		"bilateral_filter/bilateral_optimized_5x5.frag",
-		"bilateral_filter/bilateral_optimized_7x7.frag",
-	};
-	std::array<VkPipeline, window_count> bilateral_filter_opt_pipelines {};
-	
-	// resolve shader and pipeline
-	static constexpr std::string_view resolve_fragment_shader_path = "simple.frag";
-	VkPipeline 				resolve_pipeline {};
-
-	struct
-	{
-		VkPipelineLayout resolve;
-		VkPipelineLayout graphics;
-		VkPipelineLayout compute;
-	} pipeline_layouts;
-
-	struct 
-	{
-		VkDescriptorSetLayout graphics_resolve; // common layout
-		VkDescriptorSetLayout compute;
-	} descriptor_set_layouts;
-
-	struct
-	{
-		VkDescriptorSet graphics;
-		VkDescriptorSet compute;
-		VkDescriptorSet resolve;
-	} descriptor_sets;
+	virtual ~BilateralFilter() = default;
 
-	VkQueryPool query_pool;
+  protected:
+	virtual std::vector<FilterVariant> get_filter_variants() const override;
+	virtual vkb::FilterKernel create_kernel(uint32_t radius) const override;
+	virtual bool on_update_kernel_ui(vkb::Drawer &drawer) override;
+	virtual glm::vec2 get_filter_parameters(uint32_t radius) const override;
+	virtual bool is_workgroup_supported(const FilterPass &pass, const vkb::WorkgroupConfig &workgroup, uint32_t radius) const override;
 
-	std::unique_ptr<vkb::core::Image> storage_image;
-	std::unique_ptr<vkb::core::ImageView> storage_image_view;
+  private:
+	static constexpr std::string_view tiled_shader = "filters/bilateral_tiled.comp";
 
-	struct
-	{
-		Texture 								texture;
-		std::unique_ptr<vkb::core::Image> 		image;
-		std::unique_ptr<vkb::core::ImageView> 	image_view;
-		VkFramebuffer							framebuffer;
-		VkRenderPass 							render_pass;
-		VkDescriptorSet							set;
-		VkPipeline								pipeline;
-	} main_pass {};
-
-	VkRenderPass filter_pass;
-	std::vector<VkFramebuffer> filter_pass_framebuffers;
-
-	enum Type 
-	{
-		DEF,
-		OPT,
-		COMP,
-	} type = DEF;
-
-	struct
-	{
-		float offset_width;
-		float offset_height;
-		float gaussian_divisor;
-	    float intensities_divisor;
-	} pushConstGraphics;
-
-	struct
-	{
-		uint32_t width;
-		uint32_t height;
-		float gaussian_divisor;
-		float intensities_divisor;
-	} pushConstCompute;
+	// workgroups of the tiled variants, the size of the tile in shared memory is what they compare
+	static constexpr std::array<VkExtent2D, 3> tiled_workgroup_sizes = {{{8, 8}, {16, 16}, {32, 8}}};
 
+	// spatial sigma in texels
 	float sigma_d = 3.0f;
-	float sigma_r = 0.1f;
 
-	double frametime_filter  = 0.0;
-	double avg_frametime_filter  = 0.0;
-
-	uint64_t n_frames = 0;
-
-	uint64_t mask; 
-
-	void prepare_pipelines();
-	void setup_query_pool();
-	void setup_descriptor_set_layouts();
-	void setup_descriptor_pool();
-	void setup_descriptor_sets();
-	void get_frame_time();
-	void update_descriptor_sets();
-	void setup_images();
+	// range sigma, in the units of the colors
+	float sigma_r = 0.1f;
 };
 
 std::unique_ptr<vkb::VulkanSample> create_bilateral_filter();
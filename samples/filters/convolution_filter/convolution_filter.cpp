@@ -0,0 +1,113 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "convolution_filter.h"
+
+#include <algorithm>
+
+ConvolutionFilter::ConvolutionFilter()
+{
+	title = "Convolution filters collection";
+}
+
+std::vector<FilterSample::FilterVariant> ConvolutionFilter::get_filter_variants() const
+{
+	FilterPass horizontal{"first_pass", "filters/convolution_1d.frag"};
+	horizontal.output      = FilterImage::Intermediate;
+	horizontal.direction_x = 1;
+
+	FilterPass vertical{"second_pass", "filters/convolution_1d.frag"};
+	vertical.input       = FilterImage::Intermediate;
+	vertical.direction_y = 1;
+
+	FilterPass linear_horizontal = horizontal;
+	FilterPass linear_vertical   = vertical;
+	linear_horizontal.shader     = "filters/convolution_linear.frag";
+	linear_vertical.shader       = "filters/convolution_linear.frag";
+
+	FilterPass comp{"filter", "filters/convolution_2d.comp", VK_PIPELINE_BIND_POINT_COMPUTE};
+
+	FilterPass comp_horizontal = horizontal;
+	FilterPass comp_vertical   = vertical;
+	comp_horizontal.shader     = "filters/convolution_1d.comp";
+	comp_vertical.shader       = "filters/convolution_1d.comp";
+	comp_horizontal.bind_point = VK_PIPELINE_BIND_POINT_COMPUTE;
+	comp_vertical.bind_point   = VK_PIPELINE_BIND_POINT_COMPUTE;
+
+	return {
+	    {"DEF", {{"filter", "filters/convolution_2d.frag"}}},
+	    {"SEP", {horizontal, vertical}, true},
+	    {"LINEAR", {linear_horizontal, linear_vertical}, true, true},
+	    {"COMP", {comp}},
+	    {"COMP_SEP", {comp_horizontal, comp_vertical}, true},
+	};
+}
+
+vkb::FilterKernel ConvolutionFilter::create_kernel(uint32_t radius) const
+{
+	switch (kernel_family)
+	{
+		case Box:
+			return vkb::FilterKernel::box(radius);
+		case Tent:
+			return vkb::FilterKernel::tent(radius);
+		case Disc:
+		{
+			// texels whose center lies within the disc, normalized to sum 1
+			uint32_t           size = 2 * radius + 1;
+			float              r2   = (radius + 0.5f) * (radius + 0.5f);
+			std::vector<float> weights(size * size, 0.0f);
+			float              sum = 0.0f;
+			for (uint32_t y = 0; y < size; ++y)
+			{
+				for (uint32_t x = 0; x < size; ++x)
+				{
+					float dx = static_cast<float>(x) - radius;
+					float dy = static_cast<float>(y) - radius;
+					if (dx * dx + dy * dy <= r2)
+					{
+						weights[y * size + x] = 1.0f;
+						sum += 1.0f;
+					}
+				}
+			}
+			for (float &weight : weights)
+			{
+				weight /= sum;
+			}
+			return vkb::FilterKernel::from_weights("disc", std::move(weights));
+		}
+		default:
+			// a zero sigma would divide by zero, the kernel of radius 0 is the identity anyway
+			return vkb::FilterKernel::gaussian(radius, std::max(radius * sigma_scale, 0.1f));
+	}
+}
+
+bool ConvolutionFilter::on_update_kernel_ui(vkb::Drawer &drawer)
+{
+	bool changed = drawer.combo_box("kernel", &kernel_family, {"gaussian", "box", "tent", "disc"});
+	if (kernel_family == Gaussian)
+	{
+		changed |= drawer.slider_float("sigma / radius", &sigma_scale, 0.1f, 1.0f);
+	}
+	return changed;
+}
+
+std::unique_ptr<vkb::VulkanSample> create_convolution_filter()
+{
+	return std::make_unique<ConvolutionFilter>();
+}
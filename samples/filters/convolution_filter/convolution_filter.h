@@ -0,0 +1,51 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "filter_sample.h"
+
+/**
+ * @brief Compares one- and two-pass, fragment and compute convolutions over a range of kernel radii
+ */
+class ConvolutionFilter : public FilterSample
+{
+  public:
+	ConvolutionFilter();
+	virtual ~ConvolutionFilter() = default;
+
+  protected:
+	virtual std::vector<FilterVariant> get_filter_variants() const override;
+	virtual vkb::FilterKernel create_kernel(uint32_t radius) const override;
+	virtual bool on_update_kernel_ui(vkb::Drawer &drawer) override;
+
+  private:
+	enum KernelFamily : int32_t
+	{
+		Gaussian,
+		Box,
+		Tent,
+		Disc,        // non-separable
+	};
+
+	int32_t kernel_family = Gaussian;
+
+	// sigma of the gaussian kernel relative to its radius
+	float sigma_scale = 1.0f / 3.0f;
+};
+
+std::unique_ptr<vkb::VulkanSample> create_convolution_filter();
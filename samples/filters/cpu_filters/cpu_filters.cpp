@@ -0,0 +1,368 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "cpu_filters.h"
+
+#include <algorithm>
+
+#include "scene_graph/components/image.h"
+#include "timer.h"
+
+namespace
+{
+constexpr std::array<const char *, 4> filter_names = {"GAUSSIAN", "BILATERAL", "TENT", "TAA_STATISTICS"};
+}        // namespace
+
+CpuFilters::CpuFilters()
+{
+	title = "CPU filters";
+}
+
+CpuFilters::~CpuFilters()
+{
+	if (device)
+	{
+		device->wait_idle();
+	}
+}
+
+void CpuFilters::build_command_buffers()
+{
+	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
+
+	std::array<VkClearValue, 2> clear_values;
+	clear_values[0].color        = default_clear_color;
+	clear_values[1].depthStencil = {1.0f, 0};
+
+	VkRenderPassBeginInfo render_pass_begin_info    = vkb::initializers::render_pass_begin_info();
+	render_pass_begin_info.renderPass               = render_pass;
+	render_pass_begin_info.renderArea.extent.width  = width;
+	render_pass_begin_info.renderArea.extent.height = height;
+	render_pass_begin_info.clearValueCount          = vkb::to_u32(clear_values.size());
+	render_pass_begin_info.pClearValues             = clear_values.data();
+
+	for (int32_t i = 0; i < draw_cmd_buffers.size(); ++i)
+	{
+		render_pass_begin_info.framebuffer = framebuffers[i];
+
+		VK_CHECK(vkBeginCommandBuffer(draw_cmd_buffers[i], &command_buffer_begin_info));
+
+		// The filters run on the CPU, the frame only draws their statistics
+		vkCmdBeginRenderPass(draw_cmd_buffers[i], &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+		draw_ui(draw_cmd_buffers[i]);
+		vkCmdEndRenderPass(draw_cmd_buffers[i]);
+
+		VK_CHECK(vkEndCommandBuffer(draw_cmd_buffers[i]));
+	}
+}
+
+void CpuFilters::render(float delta_time)
+{
+	if (!prepared)
+	{
+		return;
+	}
+
+	update_configuration();
+	run_filter();
+
+	ApiVulkanSample::prepare_frame();
+	submit_info.commandBufferCount = 1;
+	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
+	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
+	ApiVulkanSample::submit_frame();
+}
+
+bool CpuFilters::prepare(const vkb::ApplicationOptions &options)
+{
+	if (!ApiVulkanSample::prepare(options))
+	{
+		return false;
+	}
+
+	cpu_filter       = std::make_unique<vkb::CpuFilter>();
+	instruction_sets = vkb::CpuFilter::get_supported_instruction_sets();
+	LOGI("CPU filters use {} threads, the widest instruction set is {}", cpu_filter->get_thread_count(),
+	     vkb::CpuFilter::to_string(cpu_filter->get_instruction_set()));
+
+	load_texture_image();
+	resample_source();
+
+	build_command_buffers();
+	insert_configurations(get_configuration());
+	prepared = true;
+	return true;
+}
+
+void CpuFilters::load_texture_image()
+{
+	auto image = vkb::sg::Image::load(texture_path.data(), texture_path.data(), vkb::sg::Image::Color);
+
+	VkFormat format = image->get_format();
+	if (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB)
+	{
+		// the first mip level comes first in the data
+		texture.width  = image->get_extent().width;
+		texture.height = image->get_extent().height;
+		texture.pixels.assign(image->get_data().begin(), image->get_data().begin() + texture.width * texture.height * 4);
+		return;
+	}
+
+	// The filters need uncompressed RGBA8 texels, fall back to a gradient with some detail
+	LOGW("{} has format {}, the CPU filters use a generated image instead", texture_path, vkb::to_string(format));
+
+	texture.width  = 512;
+	texture.height = 512;
+	texture.pixels.resize(texture.width * texture.height * 4);
+	for (uint32_t y = 0; y < texture.height; ++y)
+	{
+		for (uint32_t x = 0; x < texture.width; ++x)
+		{
+			uint8_t *texel = &texture.pixels[(y * texture.width + x) * 4];
+			texel[0]       = static_cast<uint8_t>(x / 2);
+			texel[1]       = static_cast<uint8_t>(y / 2);
+			texel[2]       = ((x / 8 + y / 8) % 2) ? 255 : 0;
+			texel[3]       = 255;
+		}
+	}
+}
+
+void CpuFilters::resample_source()
+{
+	// nearest neighbour is enough for a benchmark source, the filters only depend on its size
+	source.width  = width;
+	source.height = height;
+	source.pixels.resize(static_cast<size_t>(width) * height * 4);
+	for (uint32_t y = 0; y < height; ++y)
+	{
+		uint32_t ty = static_cast<uint32_t>(static_cast<uint64_t>(y) * texture.height / height);
+		for (uint32_t x = 0; x < width; ++x)
+		{
+			uint32_t tx = static_cast<uint32_t>(static_cast<uint64_t>(x) * texture.width / width);
+			std::copy_n(&texture.pixels[(static_cast<size_t>(ty) * texture.width + tx) * 4], 4, &source.pixels[(static_cast<size_t>(y) * width + x) * 4]);
+		}
+	}
+}
+
+void CpuFilters::run_filter()
+{
+	if (source.pixels.empty())
+	{
+		return;
+	}
+
+	uint32_t radius = window_id + 1;
+
+	vkb::Timer timer;
+	timer.start();
+
+	// the divisors are computed like the push constants of the GPU samples
+	switch (filter)
+	{
+		case GAUSSIAN:
+			cpu_filter->gaussian(source, output, radius, -0.5f / (sigma * sigma));
+			break;
+		case BILATERAL:
+			cpu_filter->bilateral(source, output, radius, -0.5f / (sigma_d * sigma_d), -0.5f / (sigma_r * sigma_r));
+			break;
+		case TENT:
+			cpu_filter->tent(source, output, radius, k, b);
+			break;
+		case TAA_STATISTICS:
+			filter_supported = cpu_filter->taa_statistics(source, output, radius, gamma, t);
+			break;
+		default:
+			break;
+	}
+
+	double time = timer.stop<vkb::Timer::Milliseconds>();
+	if (filter_supported)
+	{
+		filter_timings.push(time);
+	}
+}
+
+double CpuFilters::get_megapixels_per_second(double time) const
+{
+	return time > 0.0 ? static_cast<double>(source.width) * source.height / (time * 1000.0) : 0.0;
+}
+
+void CpuFilters::on_update_ui_overlay(vkb::Drawer &drawer)
+{
+	bool reset = false;
+	if (drawer.header("Select filter"))
+	{
+		for (uint32_t i = 0; i < window_count; ++i)
+		{
+			if (i > 0)
+			{
+				ImGui::SameLine();
+			}
+			if (drawer.button(fmt::format("{0}x{0}", 2 * i + 3).c_str()))
+			{
+				window_id = i;
+				reset     = true;
+			}
+		}
+
+		int32_t filter_index = filter;
+		if (drawer.combo_box("filter", &filter_index, {"gaussian", "bilateral", "tent", "taa statistics"}))
+		{
+			filter           = static_cast<Filter>(filter_index);
+			filter_supported = true;
+			reset            = true;
+		}
+
+		std::vector<std::string> instruction_set_names;
+		int32_t                  instruction_set_index = 0;
+		for (size_t i = 0; i < instruction_sets.size(); ++i)
+		{
+			instruction_set_names.push_back(vkb::CpuFilter::to_string(instruction_sets[i]));
+			if (instruction_sets[i] == cpu_filter->get_instruction_set())
+			{
+				instruction_set_index = static_cast<int32_t>(i);
+			}
+		}
+		if (drawer.combo_box("instruction set", &instruction_set_index, instruction_set_names))
+		{
+			cpu_filter->set_instruction_set(instruction_sets[instruction_set_index]);
+			reset = true;
+		}
+	}
+
+	if (drawer.header("Parameters"))
+	{
+		switch (filter)
+		{
+			case GAUSSIAN:
+				drawer.slider_float("sigma", &sigma, 0.5f, 5.0f);
+				break;
+			case BILATERAL:
+				drawer.slider_float("sigma_d", &sigma_d, 0.5f, 5.0f);
+				drawer.slider_float("sigma_r", &sigma_r, 0.01f, 1.0f);
+				break;
+			case TENT:
+				drawer.slider_float("k", &k, 7.0f, 12.0f);
+				// b up to the limit of the 3x3 window, the filter limits it for larger windows
+				drawer.slider_float("b", &b, 0.5f, (k - 0.5f) / 2.0f);
+				drawer.text("effective b: %.3f", std::min(b, (k - 0.5f) / (2.0f * (window_id + 1))));
+				break;
+			case TAA_STATISTICS:
+				drawer.slider_float("gamma", &gamma, 0.75f, 1.25f);
+				drawer.slider_float("t", &t, 0.0f, 1.0f);
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (drawer.header("Frametime"))
+	{
+		drawer.text("%u threads, %ux%u", cpu_filter->get_thread_count(), source.width, source.height);
+		if (filter_supported)
+		{
+			drawer.text("filter: %lf ms, %.1lf Mpix/s", filter_timings.last(), get_megapixels_per_second(filter_timings.last()));
+		}
+		else
+		{
+			drawer.text("filter: unsupported, no CPU implementation");
+		}
+	}
+
+	if (drawer.header("Statistics"))
+	{
+		drawer.text("%zu frames, %llu outliers", filter_timings.size(), static_cast<unsigned long long>(filter_timings.get_outlier_count()));
+		drawer.timing_statistics("filter", filter_timings);
+	}
+
+	if (reset)
+	{
+		filter_timings.reset();
+	}
+}
+
+bool CpuFilters::resize(uint32_t _width, uint32_t _height)
+{
+	if (!ApiVulkanSample::resize(_width, _height))
+	{
+		return false;
+	}
+
+	resample_source();
+	filter_timings.reset();
+	return true;
+}
+
+std::vector<vkb::BenchmarkTarget::Variant> CpuFilters::get_benchmark_variants() const
+{
+	std::vector<Variant> variants;
+	for (uint32_t filter_index = 0; filter_index < FILTER_COUNT; ++filter_index)
+	{
+		// the filters without a CPU implementation have no variants, see get_benchmark_notes()
+		if (filter_index == TAA_STATISTICS)
+		{
+			continue;
+		}
+
+		const char *filter_name = filter_names[filter_index];
+		for (auto instruction_set : instruction_sets)
+		{
+			for (uint32_t i = 0; i < window_count; ++i)
+			{
+				variants.push_back({fmt::format("{}_{}", filter_name, vkb::CpuFilter::to_string(instruction_set)),
+				                    fmt::format("{0}x{0}", 2 * i + 3)});
+			}
+		}
+	}
+	return variants;
+}
+
+void CpuFilters::set_benchmark_variant(size_t index)
+{
+	size_t variants_per_filter = instruction_sets.size() * window_count;
+
+	filter    = static_cast<Filter>(index / variants_per_filter);
+	window_id = static_cast<uint32_t>(index % window_count);
+	cpu_filter->set_instruction_set(instruction_sets[index % variants_per_filter / window_count]);
+
+	filter_timings.reset();
+}
+
+std::vector<vkb::BenchmarkTarget::PassTime> CpuFilters::get_benchmark_pass_times()
+{
+	if (filter_timings.get_push_count() == reported_push_count)
+	{
+		return {};
+	}
+	reported_push_count = filter_timings.get_push_count();
+	return {{"cpu", filter_timings.last()}};
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> CpuFilters::finish_benchmark_variant()
+{
+	return {{"mpix_per_s", get_megapixels_per_second(filter_timings.get_summary().median)}};
+}
+
+std::vector<std::string> CpuFilters::get_benchmark_notes() const
+{
+	return {fmt::format("{}: unsupported, the TAA statistics shaders that define gamma and t are not part of the tree", filter_names[TAA_STATISTICS])};
+}
+
+std::unique_ptr<vkb::VulkanSample> create_cpu_filters()
+{
+	return std::make_unique<CpuFilters>();
+}
@@ -0,0 +1,107 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "api_vulkan_sample.h"
+#include "benchmark_target.h"
+#include "cpu_filter.h"
+#include "stats/timing_statistics.h"
+
+/**
+ * @brief Runs the CPU implementations of the filters every frame and measures their throughput
+ *
+ * The source is the texture of the GPU filter samples resampled to the surface extent, so the
+ * results compare to theirs at the same resolution. The frame itself only clears the swapchain
+ * and draws the UI. In benchmark mode every filter is measured with every supported instruction
+ * set and window, its pass time is the CPU time of the filter and its throughput is reported
+ * in megapixels per second.
+ *
+ * TAA statistics has no CPU reference, it can be selected but is not run nor benchmarked.
+ */
+class CpuFilters : public ApiVulkanSample, public vkb::BenchmarkTarget
+{
+  public:
+	CpuFilters();
+	virtual ~CpuFilters();
+
+	// Override basic framework functionality
+	virtual void build_command_buffers() override;
+	virtual void render(float delta_time) override;
+	virtual bool prepare(const vkb::ApplicationOptions &options) override;
+	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
+	virtual bool resize(uint32_t width, uint32_t height) override;
+
+	// Benchmark runner interface
+	virtual std::vector<Variant> get_benchmark_variants() const override;
+	virtual void set_benchmark_variant(size_t index) override;
+	virtual std::vector<PassTime> get_benchmark_pass_times() override;
+	virtual std::vector<Metric>   finish_benchmark_variant() override;
+	virtual std::vector<std::string> get_benchmark_notes() const override;
+
+  private:
+	static constexpr std::string_view texture_path = "textures/Lenna.ktx";
+
+	// windows 3x3, 5x5 and 7x7, like the bilateral and tent samples
+	static constexpr uint32_t window_count = 3;
+
+	enum Filter
+	{
+		GAUSSIAN,
+		BILATERAL,
+		TENT,
+		TAA_STATISTICS,
+		FILTER_COUNT,
+	} filter = GAUSSIAN;
+
+	uint32_t window_id = 0;
+
+	std::unique_ptr<vkb::CpuFilter> cpu_filter;
+
+	std::vector<vkb::CpuFilter::InstructionSet> instruction_sets;
+
+	// texture as loaded, and resampled to the surface extent
+	vkb::CpuFilter::Image texture;
+	vkb::CpuFilter::Image source;
+
+	vkb::CpuFilter::Image output;
+
+	// filter parameters, with the defaults of the GPU samples
+	float sigma   = 3.0f;
+	float sigma_d = 3.0f;
+	float sigma_r = 0.1f;
+	float k       = 7.0f;
+	float b       = 1.0f;
+	float gamma   = 1.0f;
+	float t       = 0.5f;
+
+	// false if the selected filter has no CPU implementation
+	bool filter_supported = true;
+
+	// CPU time of the filter in ms
+	vkb::TimingStatistics filter_timings;
+
+	// push count of the timings when the time was last reported
+	uint64_t reported_push_count = 0;
+
+	void load_texture_image();
+	void resample_source();
+	void run_filter();
+	double get_megapixels_per_second(double time) const;
+};
+
+std::unique_ptr<vkb::VulkanSample> create_cpu_filters();
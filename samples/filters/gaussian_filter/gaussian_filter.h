@@ -17,154 +17,39 @@
 
 #pragma once
 
-#include "api_vulkan_sample.h"
+#include "filter_sample.h"
 
-#include <utility>
-
-class GaussianFilter : public ApiVulkanSample
+/**
+ * @brief Compares fragment and compute gaussian filters, including compute passes that share their
+ *        texels through subgroup shuffles and a single dispatch convolving both axes in shared memory
+ */
+class GaussianFilter : public FilterSample
 {
   public:
 	GaussianFilter();
-	virtual ~GaussianFilter();
-
-	// Override basic framework functionality
-	virtual void build_command_buffers() override;
-	virtual void render(float delta_time) override;
-	virtual bool prepare(const vkb::ApplicationOptions &options) override;
-	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
-	virtual bool resize(uint32_t width, uint32_t height) override;
-	virtual void setup_framebuffer() override;
-	virtual void setup_render_pass() override;
-private:
-	static constexpr std::string_view texture_path = "textures/Lenna.ktx";
-
-	// Sample specific data
-	uint32_t pipeline_id = 0; // same for all shader kinds
-
-	// how many shaders of each kind
-	static constexpr uint32_t window_count = 3;
-
-	// compute shaders and pipelines
-	static constexpr std::string_view gaussian_filter_comp_path = "gaussian_filter/gaussian_blur_comp.comp";
-	static constexpr uint32_t workgroup_axis_size = 128u;
-	std::array<VkPipeline, window_count> gaussian_filter_comp_first_pass_pipelines {};
-    std::array<VkPipeline, window_count> gaussian_filter_comp_second_pass_pipelines {};
-
-	// common vertex shader for default, optimized and resolve shaders
-	static constexpr std::string_view vertex_shader_path = "quad3_vert.vert";
-	
-	// default frag shaders and pipelines
-	static constexpr std::string_view gaussian_filter_def_path = "gaussian_filter/gaussian_blur.frag";
-	std::array<VkPipeline, window_count> gaussian_filter_def_pipelines {};
-	
-	// optimized frag shaders and pipelines
-	static constexpr std::string_view gaussian_filter_opt_path = "gaussian_filter/gaussian_blur_optimized.frag";
-	std::array<VkPipeline, window_count> gaussian_filter_opt_pipelines {};
-
-	// vertical linear filter shaders and pipelines
-	static constexpr std::string_view gaussian_filter_linear_vert_path = "gaussian_filter/gaussian_blur_linear_vert.frag";
-	std::array<VkPipeline, window_count> gaussian_filter_linear_vert_pipelines {};
-
-	// vertical linear filter shaders and pipelines
-	static constexpr std::string_view gaussian_filter_linear_horiz_path = "gaussian_filter/gaussian_blur_linear_horiz.frag";
-	std::array<VkPipeline, window_count> gaussian_filter_linear_horiz_pipelines {};
-
-	// resolve shader and pipeline
-	static constexpr std::string_view resolve_fragment_shader_path = "simple.frag";
-	VkPipeline 				resolve_pipeline {};
+	virtual ~GaussianFilter() = default;
 
-	struct
-	{
-		VkPipelineLayout resolve;
-		VkPipelineLayout graphics;
-		VkPipelineLayout compute;
-	} pipeline_layouts;
+	virtual void request_gpu_features(vkb::PhysicalDevice &gpu) override;
 
-	struct 
-	{
-		VkDescriptorSetLayout graphics_resolve; // common layout
-		VkDescriptorSetLayout compute;
-	} descriptor_set_layouts;
+  protected:
+	virtual std::vector<FilterVariant> get_filter_variants() const override;
+	virtual vkb::FilterKernel create_kernel(uint32_t radius) const override;
+	virtual bool on_update_kernel_ui(vkb::Drawer &drawer) override;
+	virtual bool is_workgroup_supported(const FilterPass &pass, const vkb::WorkgroupConfig &workgroup, uint32_t radius) const override;
 
-	struct
-	{
-		std::pair<VkDescriptorSet, VkDescriptorSet> graphics;
-		std::pair<VkDescriptorSet, VkDescriptorSet> compute;
-		VkDescriptorSet resolve;
-	} descriptor_sets;
+  private:
+	static constexpr std::string_view subgroup_shader = "filters/convolution_subgroup.comp";
 
-	VkQueryPool query_pool;
+	static constexpr std::string_view fused_shader = "filters/convolution_fused.comp";
 
-	std::unique_ptr<vkb::core::Image> storage_intermediate_image;
-	std::unique_ptr<vkb::core::ImageView> storage_intermediate_image_view;
+	// smaller subgroups fetch most of the taps anyway
+	static constexpr uint32_t min_subgroup_size = 8u;
 
-    std::unique_ptr<vkb::core::Image> storage_output_image;
-	std::unique_ptr<vkb::core::ImageView> storage_output_image_view;
-
-	struct
-	{
-		Texture 								texture;
-		std::unique_ptr<vkb::core::Image> 		image;
-		std::unique_ptr<vkb::core::ImageView> 	image_view;
-		VkFramebuffer							framebuffer;
-		VkRenderPass 							render_pass;
-		VkDescriptorSet							set;
-		VkPipeline								pipeline;
-	} main_pass {};
-
-	std::unique_ptr<vkb::core::Image> 		intermediate_image;
-	std::unique_ptr<vkb::core::ImageView> 	intermediate_image_view;
-
-	VkRenderPass filter_pass;
-	VkRenderPass intermediate_filter_pass;
-	
-	VkFramebuffer intermediate_filter_pass_framebuffer = VK_NULL_HANDLE;
-	std::vector<VkFramebuffer> filter_pass_framebuffers;
-
-	enum Type 
-	{
-		DEF,
-		OPT,
-		COMP,
-		LINEAR,
-	} type = DEF;
-
-	struct
-	{
-		float offset_width;
-		float offset_height;
-		float gaussian_divisor;
-	} pushConstGraphics;
-
-	struct
-	{
-		uint32_t width;
-		uint32_t height;
-		float gaussian_divisor;
-	} pushConstCompute;
+	bool subgroup_supported = false;
 
 	float sigma = 3.0f;
 
-	double frametime = 0.0;
-	double frametime_first_pass = 0.0;
-	double frametime_second_pass = 0.0;
-
-	double avg_frametime = 0.0;
-	double avg_frametime_first_pass = 0.0;
-	double avg_frametime_second_pass = 0.0;
-
-	uint64_t n_frames = 0;
-
-	uint64_t mask; 
-
-	void prepare_pipelines();
-	void setup_query_pool();
-	void setup_descriptor_set_layouts();
-	void setup_descriptor_pool();
-	void setup_descriptor_sets();
-	void get_frame_time();
-	void update_descriptor_sets();
-	void setup_images();
+	bool check_subgroup_support(vkb::PhysicalDevice &gpu);
 };
 
 std::unique_ptr<vkb::VulkanSample> create_gaussian_filter();
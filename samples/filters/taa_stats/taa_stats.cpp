@@ -20,12 +20,19 @@
 TAAStats::TAAStats()
 {
 	title = "TAA stats filters collection";
+
+	// maps the timestamps to the host clock of a trace (see --trace-output)
+	add_device_extension(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME, true);
 }
 
 TAAStats::~TAAStats()
 {
 	if (device)
 	{
+		device->wait_idle();
+
+		pipeline_builder.reset();
+
 		for (int i = 0; i < window_count; ++i)
 		{
 			vkDestroyPipeline(get_device().get_handle(), taa_statistics_def_pipelines[i], nullptr);
@@ -40,6 +47,7 @@ TAAStats::~TAAStats()
 		vkDestroyRenderPass(get_device().get_handle(), filter_pass, nullptr);
 
 		vkDestroyFramebuffer(get_device().get_handle(), main_pass.framebuffer, nullptr);
+		vkDestroyFramebuffer(get_device().get_handle(), output_framebuffer, nullptr);
 		
 		for (int i = 0; i < filter_pass_framebuffers.size(); ++i)
 		{
@@ -56,14 +64,27 @@ TAAStats::~TAAStats()
 		main_pass.texture.image.reset();
 		vkDestroySampler(get_device().get_handle(), main_pass.texture.sampler, nullptr);
 
-		vkDestroyQueryPool(get_device().get_handle(), query_pool, nullptr);
+		timestamp_queries.reset();
 	}
 }
 
 void TAAStats::build_command_buffers()
 {
+	wait_active_pipelines();
+
 	update_descriptor_sets();
-	
+
+	// offscreen the main image is drawn once and the frames only hold the filter passes
+	if (is_offscreen())
+	{
+		with_command_buffer([this](VkCommandBuffer cmd) { record_main_pass(cmd); });
+	}
+
+	record_frames();
+}
+
+void TAAStats::record_frame(uint32_t frame)
+{
 	VkCommandBufferBeginInfo command_buffer_begin_info = vkb::initializers::command_buffer_begin_info();
 
 	VkClearValue clear_values;
@@ -77,18 +98,33 @@ void TAAStats::build_command_buffers()
 	render_pass_begin_info.clearValueCount          = 1;
 	render_pass_begin_info.pClearValues             = &clear_values;
 
-	for (int32_t i = 0; i < draw_cmd_buffers.size(); ++i)
-	{
-		auto cmd = draw_cmd_buffers[i];
+	// offscreen the main image is drawn once, by build_command_buffers()
+	bool offscreen = is_offscreen();
 
-		vkBeginCommandBuffer(cmd, &command_buffer_begin_info);
+	auto cmd = draw_cmd_buffers[frame];
 
-		vkCmdResetQueryPool(cmd, query_pool, 0, 2);
+	vkBeginCommandBuffer(cmd, &command_buffer_begin_info);
 
-		render_pass_begin_info.renderPass = main_pass.render_pass;
-		render_pass_begin_info.framebuffer = main_pass.framebuffer;
+	timestamp_queries->reset(cmd, frame);
 
+	if (!offscreen)
+	{
+		record_main_pass(cmd);
+	}
+
+	record_filter_pass(cmd, [&](VkPipelineStageFlagBits stage) {
+		timestamp_queries->write(cmd, stage, frame, stage == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT ? 0 : 1);
+	});
+
+	if (!offscreen)
+	{
+		// resolve pass, scales the storage image to the swapchain
 		{
+			render_pass_begin_info.framebuffer = filter_pass_framebuffers[frame];
+			render_pass_begin_info.renderPass  = filter_pass;
+			render_pass_begin_info.renderArea.extent.width  = width;
+			render_pass_begin_info.renderArea.extent.height = height;
+
 			vkCmdBeginRenderPass(cmd, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
 			VkViewport viewport = vkb::initializers::viewport(static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f);
@@ -97,127 +133,176 @@ void TAAStats::build_command_buffers()
 			VkRect2D scissor = vkb::initializers::rect2D(width, height, 0, 0);
 			vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pass.pipeline);
+			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, resolve_pipeline);
 
-			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-				pipeline_layouts.resolve, 0, 1, &main_pass.set, 0, nullptr);
+			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.resolve, 0, 1, &descriptor_sets.resolve, 0, nullptr);
 
 			vkCmdDraw(cmd, 3, 1, 0, 0);
 
 			vkCmdEndRenderPass(cmd);
 		}
 
-		if (type == COMP)
 		{
-			vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, taa_statistics_comp_pipelines[pipeline_id]);
-
-			VkImageMemoryBarrier image_barrier;
-			image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-			image_barrier.pNext = nullptr;
-			image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-			image_barrier.srcAccessMask = VK_ACCESS_NONE;
-			image_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-			image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
-			image_barrier.image = storage_image->get_handle();
-			image_barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
-			
-			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
-				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
-
-			vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layouts.compute, 0, 1, &descriptor_sets.compute, 0, nullptr);
-			
-			vkCmdPushConstants(cmd, pipeline_layouts.compute, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstCompute), &pushConstCompute);
-
-			uint32_t x_size = width / workgroup_axis_size + (width % workgroup_axis_size != 0);
-			uint32_t y_size = height / workgroup_axis_size + (height % workgroup_axis_size != 0);
-
-			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, 0);
-			vkCmdDispatch(cmd, x_size, y_size, 1);
-			vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 1);
-
-			image_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-			image_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-			image_barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
-			image_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-
-			vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
-				VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
-		}
+			render_pass_begin_info.framebuffer = framebuffers[frame];
+			render_pass_begin_info.renderPass  = render_pass; 
 
-		// filter pass (or resolve for compute)
-		{
-			render_pass_begin_info.framebuffer = filter_pass_framebuffers[i];
-			render_pass_begin_info.renderPass  = filter_pass;
-			
-			if (type != COMP)
-				vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, query_pool, 0);
 			vkCmdBeginRenderPass(cmd, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+		
+			draw_ui(cmd, frame);
+		
+			vkCmdEndRenderPass(cmd);
+		}
+	}
 
-			VkViewport viewport = vkb::initializers::viewport(static_cast<float>(width), static_cast<float>(height), 0.0f, 1.0f);
-			vkCmdSetViewport(cmd, 0, 1, &viewport);
+	VK_CHECK(vkEndCommandBuffer(cmd));
+}
 
-			VkRect2D scissor = vkb::initializers::rect2D(width, height, 0, 0);
-			vkCmdSetScissor(cmd, 0, 1, &scissor);
+void TAAStats::record_main_pass(VkCommandBuffer cmd)
+{
+	VkExtent2D filter_extent = get_filter_extent();
 
-			switch (type)
-			{
-			case DEF:
-				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, taa_statistics_def_pipelines[pipeline_id]);
+	VkClearValue clear_values;
+	clear_values.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
 
-				vkCmdPushConstants(cmd, pipeline_layouts.graphics, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushConstGraphics), &pushConstGraphics);
+	VkRenderPassBeginInfo render_pass_begin_info = vkb::initializers::render_pass_begin_info();
+	render_pass_begin_info.renderPass            = main_pass.render_pass;
+	render_pass_begin_info.framebuffer           = main_pass.framebuffer;
+	render_pass_begin_info.renderArea.extent     = filter_extent;
+	render_pass_begin_info.clearValueCount       = 1;
+	render_pass_begin_info.pClearValues          = &clear_values;
 
-				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.graphics, 0, 1, &descriptor_sets.graphics, 0, nullptr);
-				break;
-			case OPT:
-				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, taa_statistics_opt_pipelines[pipeline_id]);
+	vkCmdBeginRenderPass(cmd, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
 
-				vkCmdPushConstants(cmd, pipeline_layouts.graphics, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushConstGraphics), &pushConstGraphics);
+	VkViewport viewport = vkb::initializers::viewport(static_cast<float>(filter_extent.width), static_cast<float>(filter_extent.height), 0.0f, 1.0f);
+	vkCmdSetViewport(cmd, 0, 1, &viewport);
 
-				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.graphics, 0, 1, &descriptor_sets.graphics, 0, nullptr);				
-				break;
-			case COMP:
-				vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, resolve_pipeline);
+	VkRect2D scissor = vkb::initializers::rect2D(filter_extent.width, filter_extent.height, 0, 0);
+	vkCmdSetScissor(cmd, 0, 1, &scissor);
 
-				vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.resolve, 0, 1, &descriptor_sets.resolve, 0, nullptr);
-				break;
-			}
-					
-			vkCmdDraw(cmd, 3, 1, 0, 0);
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, main_pass.pipeline);
 
-			vkCmdEndRenderPass(cmd);
-			if (type != COMP)
-				vkCmdWriteTimestamp(cmd, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, query_pool, 1);
-		}
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+		pipeline_layouts.resolve, 0, 1, &main_pass.set, 0, nullptr);
 
-		{
-			render_pass_begin_info.framebuffer = framebuffers[i];
-			render_pass_begin_info.renderPass  = render_pass; 
+	vkCmdDraw(cmd, 3, 1, 0, 0);
 
-			vkCmdBeginRenderPass(cmd, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
-			
-			draw_ui(cmd);
-			
-			vkCmdEndRenderPass(cmd);
-		}
+	vkCmdEndRenderPass(cmd);
+}
+
+void TAAStats::record_filter_pass(VkCommandBuffer cmd, const std::function<void(VkPipelineStageFlagBits)> &write_timestamp)
+{
+	if (type == COMP)
+	{
+		record_dispatch(cmd, taa_statistics_comp_pipelines[pipeline_id], workgroup_axis_sizes[pipeline_id], write_timestamp);
+		return;
+	}
+
+	VkExtent2D filter_extent = get_filter_extent();
+
+	VkClearValue clear_values;
+	clear_values.color = {{0.0f, 0.0f, 0.0f, 0.0f}};
+
+	// graphics filter pass, into the storage image
+	VkRenderPassBeginInfo render_pass_begin_info = vkb::initializers::render_pass_begin_info();
+	render_pass_begin_info.renderPass            = main_pass.render_pass;
+	render_pass_begin_info.framebuffer           = output_framebuffer;
+	render_pass_begin_info.renderArea.extent     = filter_extent;
+	render_pass_begin_info.clearValueCount       = 1;
+	render_pass_begin_info.pClearValues          = &clear_values;
+
+	if (write_timestamp)
+	{
+		write_timestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	vkCmdBeginRenderPass(cmd, &render_pass_begin_info, VK_SUBPASS_CONTENTS_INLINE);
+
+	VkViewport viewport = vkb::initializers::viewport(static_cast<float>(filter_extent.width), static_cast<float>(filter_extent.height), 0.0f, 1.0f);
+	vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+	VkRect2D scissor = vkb::initializers::rect2D(filter_extent.width, filter_extent.height, 0, 0);
+	vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, type == DEF ? taa_statistics_def_pipelines[pipeline_id] : taa_statistics_opt_pipelines[pipeline_id]);
 
-		VK_CHECK(vkEndCommandBuffer(cmd));
+	vkCmdPushConstants(cmd, pipeline_layouts.graphics, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(pushConstGraphics), &pushConstGraphics);
+
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layouts.graphics, 0, 1, &descriptor_sets.graphics, 0, nullptr);
+
+	vkCmdDraw(cmd, 3, 1, 0, 0);
+
+	vkCmdEndRenderPass(cmd);
+	if (write_timestamp)
+	{
+		write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
 	}
 }
 
+void TAAStats::record_dispatch(VkCommandBuffer cmd, VkPipeline pipeline, uint32_t axis_size,
+                              const std::function<void(VkPipelineStageFlagBits)> &write_timestamp)
+{
+	VkExtent2D filter_extent = get_filter_extent();
+
+	vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+
+	VkImageMemoryBarrier image_barrier;
+	image_barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+	image_barrier.pNext = nullptr;
+	image_barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	image_barrier.srcAccessMask = VK_ACCESS_NONE;
+	image_barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	image_barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	image_barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	image_barrier.image = storage_image->get_handle();
+	image_barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+	
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 
+		VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+
+	vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layouts.compute, 0, 1, &descriptor_sets.compute, 0, nullptr);
+	
+	vkCmdPushConstants(cmd, pipeline_layouts.compute, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstCompute), &pushConstCompute);
+
+	uint32_t x_size = filter_extent.width / axis_size + (filter_extent.width % axis_size != 0);
+	uint32_t y_size = filter_extent.height / axis_size + (filter_extent.height % axis_size != 0);
+
+	if (write_timestamp)
+	{
+		write_timestamp(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT);
+	}
+	vkCmdDispatch(cmd, x_size, y_size, 1);
+	if (write_timestamp)
+	{
+		write_timestamp(VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT);
+	}
+
+	image_barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	image_barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	image_barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+	image_barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+	vkCmdPipelineBarrier(cmd, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 
+		VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &image_barrier);
+}
+
 void TAAStats::render(float delta_time)
 {
 	if (!prepared)
 	{
 		return;
 	}
+	update_configuration();
 	ApiVulkanSample::prepare_frame();
 	submit_info.commandBufferCount = 1;
 	submit_info.pCommandBuffers    = &draw_cmd_buffers[current_buffer];
-	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, VK_NULL_HANDLE));
-	ApiVulkanSample::submit_frame();
+
+	wait_for_frame_fence();
 	get_frame_time();
+	update_current_frame();
+
+	VK_CHECK(vkQueueSubmit(queue, 1, &submit_info, wait_fences[current_buffer]));
+	timestamp_queries->submitted(current_buffer);
+	ApiVulkanSample::submit_frame();
 }
 
 bool TAAStats::prepare(const vkb::ApplicationOptions &options)
@@ -229,14 +314,10 @@ bool TAAStats::prepare(const vkb::ApplicationOptions &options)
 
 	depth_format = vkb::get_suitable_depth_format(device->get_gpu().get_handle());
 
-	VkSemaphoreCreateInfo semaphore_create_info = vkb::initializers::semaphore_create_info();
-	VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &semaphores.acquired_image_ready));
-	VK_CHECK(vkCreateSemaphore(device->get_handle(), &semaphore_create_info, nullptr, &semaphores.render_complete));
-
 	submit_info                   = vkb::initializers::submit_info();
 	submit_info.pWaitDstStageMask = &submit_pipeline_stages;
 
-	if (window->get_window_mode() != vkb::Window::Mode::Headless)
+	if (render_context->has_swapchain())
 	{
 		submit_info.waitSemaphoreCount   = 1;
 		submit_info.pWaitSemaphores      = &semaphores.acquired_image_ready;
@@ -248,13 +329,7 @@ bool TAAStats::prepare(const vkb::ApplicationOptions &options)
 
 	queue = device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT, 0).get_handle();
 
-	uint32_t validBits = device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT, 0).get_properties().timestampValidBits;
-	assert(validBits);
-	LOGI(validBits);
-	validBits = sizeof(uint64_t) * CHAR_BIT - validBits;
-	mask = 0;
-	mask = ~mask >> validBits;
-	LOGI("valid bits mask = {0:x}", mask);
+	use_wait_fences = true;
 
 	create_swapchain_buffers();
 	setup_images();
@@ -271,15 +346,16 @@ bool TAAStats::prepare(const vkb::ApplicationOptions &options)
 
 	prepare_gui();
 
+	// the sample has no array image path, a batch set on the command line falls back to a single image
+	// and the benchmark skips every larger batch, see get_benchmark_notes()
+	check_batch_size();
+
 	// fill push constants
 	{
-		pushConstCompute.width = width;
-		pushConstCompute.height = height;
+		update_extent_push_constants();
 		pushConstCompute.gamma = 1.0f;
 		pushConstCompute.t = 0.5f;
 
-		pushConstGraphics.offset_width = 1.0f / width;
-		pushConstGraphics.offset_height = 1.0f / height;
 		pushConstGraphics.gamma = 1.0f;
 		pushConstGraphics.t = 0.5f;
 	}
@@ -288,11 +364,18 @@ bool TAAStats::prepare(const vkb::ApplicationOptions &options)
 
 	setup_query_pool();
 	setup_descriptor_set_layouts();
+	load_workgroup_sizes();
+	vkb::Timer pipeline_timer;
+	pipeline_timer.start();
 	prepare_pipelines();
+	wait_active_pipelines();
+	log_pipeline_creation_time(pipeline_timer.stop<vkb::Timer::Milliseconds>());
 	setup_descriptor_pool();
 	setup_descriptor_sets();
 	update_descriptor_sets();
+	tune_workgroups();
 	build_command_buffers();
+	insert_configurations(get_configuration());
 	prepared = true;
 	return true;
 }
@@ -339,21 +422,23 @@ void TAAStats::on_update_ui_overlay(vkb::Drawer &drawer)
 	}
 	
 	if (drawer.header("Frametime"))
-	{		
-		drawer.text("total: %lf ms", frametime_filter);
+	{
+		drawer.text("total: %lf ms", filter_timings.last());
 	}
 
-	if (drawer.header("Average frametime"))
+	if (drawer.header("Statistics"))
 	{
-		drawer.text("%llu frames", n_frames);
-		drawer.text("total: %lf ms", avg_frametime_filter);
+		drawer.text("%zu frames, %llu outliers", filter_timings.size(), static_cast<unsigned long long>(filter_timings.get_outlier_count()));
+		drawer.timing_statistics("total", filter_timings);
 	}
 
 	if (reset)
 	{
-		avg_frametime_filter = 0.0;
-		n_frames = 0;
+		wait_active_pipelines();
+		reset_timings();
 	}
+
+	apply_ui_changes(drawer);
 }
 
 bool TAAStats::resize(uint32_t _width, uint32_t _height)
@@ -374,11 +459,6 @@ bool TAAStats::resize(uint32_t _width, uint32_t _height)
 	width  = get_render_context().get_surface_extent().width;
 	height = get_render_context().get_surface_extent().height;
 
-	pushConstGraphics.offset_width 	= 1.0f / width;
-	pushConstGraphics.offset_height = 1.0f / height;
-	pushConstCompute.width 			= width;
-	pushConstCompute.height 		= height;
-
 	prepared = false;
 
 	// Ensure all operations on the device have been finished before destroying resources
@@ -404,6 +484,7 @@ bool TAAStats::resize(uint32_t _width, uint32_t _height)
 	main_pass.framebuffer = VK_NULL_HANDLE;
 	
 	setup_framebuffer();
+	update_extent_push_constants();
 
 	if ((width > 0.0f) && (height > 0.0f))
 	{
@@ -413,8 +494,7 @@ bool TAAStats::resize(uint32_t _width, uint32_t _height)
 		}
 	}
 
-	avg_frametime_filter = 0.0;
-	n_frames = 0;
+	reset_timings();
 
 	rebuild_command_buffers();
 
@@ -467,7 +547,7 @@ void TAAStats::setup_framebuffer()
 		}
 	}
 
-	// main framebuffer
+	// main and output framebuffers, at the filter extent
 	{
 		VkImageView attachment = main_pass.image_view->get_handle();
 
@@ -477,8 +557,8 @@ void TAAStats::setup_framebuffer()
 		framebuffer_create_info.renderPass              = main_pass.render_pass;
 		framebuffer_create_info.attachmentCount         = 1;
 		framebuffer_create_info.pAttachments            = &attachment;
-		framebuffer_create_info.width                   = get_render_context().get_surface_extent().width;
-		framebuffer_create_info.height                  = get_render_context().get_surface_extent().height;
+		framebuffer_create_info.width                   = get_filter_extent().width;
+		framebuffer_create_info.height                  = get_filter_extent().height;
 		framebuffer_create_info.layers                  = 1;
 
 		if (main_pass.framebuffer != VK_NULL_HANDLE)
@@ -487,6 +567,16 @@ void TAAStats::setup_framebuffer()
 		}
 
 		vkCreateFramebuffer(device->get_handle(), &framebuffer_create_info, nullptr, &main_pass.framebuffer);
+
+		// the storage image has the format of the main pass image, so both share the render pass
+		attachment = storage_image_view->get_handle();
+
+		if (output_framebuffer != VK_NULL_HANDLE)
+		{
+			vkDestroyFramebuffer(device->get_handle(), output_framebuffer, nullptr);
+		}
+
+		VK_CHECK(vkCreateFramebuffer(device->get_handle(), &framebuffer_create_info, nullptr, &output_framebuffer));
 	}
 }
 
@@ -728,6 +818,11 @@ void TAAStats::prepare_pipelines()
 	std::array<VkDynamicState, 2>    dynamics{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
 	VkPipelineDynamicStateCreateInfo dynamic = vkb::initializers::pipeline_dynamic_state_create_info(dynamics.data(), vkb::to_u32(dynamics.size()));
 
+	// Compile the shaders on the worker threads ahead of the pipelines that use them.
+	pipeline_builder = std::make_unique<vkb::PipelineBuilder>(get_device(), pipeline_cache);
+	pipeline_builder->compile_shaders({vertex_shader_path.data(), taa_statistics_def_path.data(), taa_statistics_opt_path.data(),
+	                                   resolve_fragment_shader_path.data(), taa_statistics_comp_path.data()});
+
 	// Load our SPIR-V shaders.
 	std::array<VkPipelineShaderStageCreateInfo, 2> shader_stages{};
 	shader_stages[0] = load_shader(vertex_shader_path.data(), VK_SHADER_STAGE_VERTEX_BIT);
@@ -747,7 +842,7 @@ void TAAStats::prepare_pipelines()
 	pipeline_create_info.pColorBlendState		= &blend;
 	pipeline_create_info.pDynamicState			= &dynamic;
 	pipeline_create_info.layout = pipeline_layouts.graphics;
-	pipeline_create_info.renderPass = filter_pass;
+	pipeline_create_info.renderPass = main_pass.render_pass;
 	pipeline_create_info.subpass = 0;
 	pipeline_create_info.basePipelineHandle = VK_NULL_HANDLE;
 	pipeline_create_info.basePipelineIndex = 0;
@@ -777,8 +872,7 @@ void TAAStats::prepare_pipelines()
 			pipeline_create_info.stageCount = vkb::to_u32(shader_stages.size());
 			pipeline_create_info.pStages 	= shader_stages.data();
 
-			VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), VK_NULL_HANDLE, 1,
-				&pipeline_create_info, nullptr, &taa_statistics_def_pipelines[i]));
+			pipeline_builder->add_graphics_pipeline(pipeline_create_info, &taa_statistics_def_pipelines[i]);
 		}
 	}
 
@@ -807,8 +901,7 @@ void TAAStats::prepare_pipelines()
 			pipeline_create_info.stageCount = vkb::to_u32(shader_stages.size());
 			pipeline_create_info.pStages 	= shader_stages.data();
 
-			VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), VK_NULL_HANDLE, 1,
-				&pipeline_create_info, nullptr, &taa_statistics_opt_pipelines[i]));
+			pipeline_builder->add_graphics_pipeline(pipeline_create_info, &taa_statistics_opt_pipelines[i]);
 		}
 	}
 
@@ -819,18 +912,17 @@ void TAAStats::prepare_pipelines()
 	VK_CHECK(vkCreatePipelineLayout(get_device().get_handle(), &layout_info, nullptr, &pipeline_layouts.resolve));
 
 	pipeline_create_info.layout = pipeline_layouts.resolve;
+	pipeline_create_info.renderPass = filter_pass;
 	shader_stages[1] = load_shader(resolve_fragment_shader_path.data(), VK_SHADER_STAGE_FRAGMENT_BIT);
 	pipeline_create_info.stageCount = vkb::to_u32(shader_stages.size());
 	pipeline_create_info.pStages = shader_stages.data();
 
-	VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), VK_NULL_HANDLE, 1,
-		&pipeline_create_info, nullptr, &resolve_pipeline));
+	pipeline_builder->add_graphics_pipeline(pipeline_create_info, &resolve_pipeline);
 
 	// main graphics pipeline
 	pipeline_create_info.renderPass = main_pass.render_pass;
 
-	VK_CHECK(vkCreateGraphicsPipelines(get_device().get_handle(), VK_NULL_HANDLE, 1,
-		&pipeline_create_info, nullptr, &main_pass.pipeline));
+	pipeline_builder->add_graphics_pipeline(pipeline_create_info, &main_pass.pipeline);
 
 	// compute pipelines
 	range = vkb::initializers::push_constant_range(VK_SHADER_STAGE_COMPUTE_BIT, sizeof(pushConstCompute), 0);
@@ -855,7 +947,6 @@ void TAAStats::prepare_pipelines()
 		map_entries[1].size = sizeof(int32_t);
 
 		std::array<int32_t, 2> data;
-		data[0] = workgroup_axis_size;
 
 		VkSpecializationInfo spec_info;
 		spec_info.mapEntryCount = map_entries.size();
@@ -865,27 +956,151 @@ void TAAStats::prepare_pipelines()
 
 		for (int i = 0; i < window_count; ++i)
 		{
+			data[0] = workgroup_axis_sizes[i];
 			data[1] = i + 1;
 
 			compute_create_info.stage = load_shader(taa_statistics_comp_path.data(), VK_SHADER_STAGE_COMPUTE_BIT);
 			compute_create_info.stage.pSpecializationInfo = &spec_info;
 
-			VK_CHECK(vkCreateComputePipelines(get_device().get_handle(), VK_NULL_HANDLE, 1, &compute_create_info, nullptr, &taa_statistics_comp_pipelines[i]));
+			pipeline_builder->add_compute_pipeline(compute_create_info, &taa_statistics_comp_pipelines[i]);
 		}
 	}
+
+	// the pipelines of the current type and window come first, then the other windows of that type
+	std::vector<const VkPipeline *> priority = get_pipelines(type, pipeline_id);
+	for (uint32_t i = 0; i < window_count; ++i)
+	{
+		if (i != pipeline_id)
+		{
+			auto window_pipelines = get_pipelines(type, i);
+			priority.insert(priority.end(), window_pipelines.begin(), window_pipelines.end());
+		}
+	}
+	pipeline_builder->build(priority);
+}
+
+VkPipeline TAAStats::create_compute_pipeline(const VkPipelineShaderStageCreateInfo &stage, uint32_t window, uint32_t axis_size)
+{
+	std::array<VkSpecializationMapEntry, 2> map_entries = {
+	    vkb::initializers::specialization_map_entry(0, 0, sizeof(int32_t)),
+	    vkb::initializers::specialization_map_entry(1, sizeof(int32_t), sizeof(int32_t)),
+	};
+
+	std::array<int32_t, 2> data{static_cast<int32_t>(axis_size), static_cast<int32_t>(window + 1)};
+
+	VkSpecializationInfo spec_info = vkb::initializers::specialization_info(vkb::to_u32(map_entries.size()), map_entries.data(),
+	                                                                        sizeof(data), data.data());
+
+	VkComputePipelineCreateInfo compute_create_info = vkb::initializers::compute_pipeline_create_info(pipeline_layouts.compute);
+	compute_create_info.stage                       = stage;
+	compute_create_info.stage.pSpecializationInfo   = &spec_info;
+
+	VkPipeline pipeline = VK_NULL_HANDLE;
+	if (vkCreateComputePipelines(get_device().get_handle(), pipeline_cache, 1, &compute_create_info, nullptr, &pipeline) != VK_SUCCESS)
+	{
+		return VK_NULL_HANDLE;
+	}
+	return pipeline;
+}
+
+std::string TAAStats::get_tuning_key(uint32_t window) const
+{
+	return fmt::format("{}_r{}", taa_statistics_comp_path, window + 1);
+}
+
+void TAAStats::load_workgroup_sizes()
+{
+	workgroup_tuner = std::make_unique<vkb::WorkgroupTuner>(get_device());
+
+	for (uint32_t i = 0; i < window_count; ++i)
+	{
+		vkb::WorkgroupConfig config{default_workgroup_axis_size, default_workgroup_axis_size, 1};
+		workgroup_tuner->find(get_tuning_key(i), config);
+		workgroup_axis_sizes[i] = config.width;
+	}
+}
+
+void TAAStats::tune_workgroups()
+{
+	if (!vkb::WorkgroupTuner::is_enabled())
+	{
+		return;
+	}
+
+	VkPipelineShaderStageCreateInfo stage = load_shader(taa_statistics_comp_path.data(), VK_SHADER_STAGE_COMPUTE_BIT);
+
+	bool main_image_drawn = false;
+	for (uint32_t i = 0; i < window_count; ++i)
+	{
+		vkb::WorkgroupConfig config;
+		if (workgroup_tuner->find(get_tuning_key(i), config))
+		{
+			continue;
+		}
+
+		// the candidates filter the main image, it is drawn before the first of them
+		if (!main_image_drawn)
+		{
+			pipeline_builder->wait(main_pass.pipeline);
+			with_command_buffer([this](VkCommandBuffer cmd) { record_main_pass(cmd); });
+			main_image_drawn = true;
+		}
+
+		// the shader has square workgroups with a pixel per invocation
+		auto create_pipeline = [&](const vkb::WorkgroupConfig &candidate) {
+			if (candidate.width != candidate.height || candidate.pixels_per_thread != 1)
+			{
+				return VkPipeline{VK_NULL_HANDLE};
+			}
+			return create_compute_pipeline(stage, i, candidate.width);
+		};
+
+		config = workgroup_tuner->tune(get_tuning_key(i), {workgroup_axis_sizes[i], workgroup_axis_sizes[i], 1}, create_pipeline,
+		                               [&](VkCommandBuffer cmd, VkPipeline pipeline, const vkb::WorkgroupConfig &candidate) {
+			                               record_dispatch(cmd, pipeline, candidate.width, {});
+		                               });
+
+		if (config.width != workgroup_axis_sizes[i])
+		{
+			pipeline_builder->wait(taa_statistics_comp_pipelines[i]);
+			vkDestroyPipeline(get_device().get_handle(), taa_statistics_comp_pipelines[i], nullptr);
+			taa_statistics_comp_pipelines[i] = create_compute_pipeline(stage, i, config.width);
+			workgroup_axis_sizes[i] = config.width;
+		}
+	}
+}
+
+std::vector<const VkPipeline *> TAAStats::get_pipelines(Type pipeline_type, uint32_t window) const
+{
+	std::vector<const VkPipeline *> pipelines{&main_pass.pipeline, &resolve_pipeline};
+	switch (pipeline_type)
+	{
+	case DEF:
+		pipelines.push_back(&taa_statistics_def_pipelines[window]);
+		break;
+	case OPT:
+		pipelines.push_back(&taa_statistics_opt_pipelines[window]);
+		break;
+	case COMP:
+		pipelines.push_back(&taa_statistics_comp_pipelines[window]);
+		break;
+	}
+	return pipelines;
+}
+
+void TAAStats::wait_active_pipelines()
+{
+	for (auto pipeline : get_pipelines(type, pipeline_id))
+	{
+		pipeline_builder->wait(*pipeline);
+	}
 }
 
 void TAAStats::setup_query_pool()
 {
-	VkQueryPoolCreateInfo query_pool_info;
-	query_pool_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
-	query_pool_info.pNext = nullptr;
-	query_pool_info.flags = 0;
-	query_pool_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
-	query_pool_info.queryCount = 2;
-	query_pool_info.pipelineStatistics = 0;
-		
-	VK_CHECK(vkCreateQueryPool(get_device().get_handle(), &query_pool_info, nullptr, &query_pool));
+	uint32_t valid_bits = device->get_queue_by_flags(VK_QUEUE_COMPUTE_BIT | VK_QUEUE_GRAPHICS_BIT, 0).get_properties().timestampValidBits;
+
+	timestamp_queries = std::make_unique<vkb::TimestampQueryRing>(get_device(), vkb::to_u32(draw_cmd_buffers.size()), 2, valid_bits);
 }
 
 void TAAStats::setup_descriptor_set_layouts()
@@ -940,15 +1155,19 @@ void TAAStats::setup_descriptor_sets()
 
 void TAAStats::get_frame_time()
 {
-	uint64_t labels[2];
-	uint32_t count = 2;
+	// Reads the frame previously submitted with the current command buffer, whose fence has signaled
+	std::array<uint64_t, 2> timestamps;
+	if (timestamp_queries->read(current_buffer, vkb::to_u32(timestamps.size()), timestamps.data()))
+	{
+		filter_timings.push(timestamp_queries->elapsed_ms(timestamps[0], timestamps[1]));
+		timestamp_queries->trace("filter", timestamps[0], timestamps[1]);
+	}
+}
 
-	auto result = vkGetQueryPoolResults(get_device().get_handle(), query_pool, 0, count, sizeof(labels[0]) * count,
-		&labels, sizeof(labels[0]), VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WAIT_BIT);
-	
-	frametime_filter = ((labels[1] & mask) - (labels[0] & mask)) * get_device().get_gpu().get_properties().limits.timestampPeriod * 1e-6;
-	avg_frametime_filter = (frametime_filter + avg_frametime_filter * n_frames) / (n_frames + 1);
-	++n_frames;
+void TAAStats::reset_timings()
+{
+	filter_timings.reset();
+	timestamp_queries->discard();
 }
 
 void TAAStats::update_descriptor_sets()
@@ -1007,8 +1226,7 @@ void TAAStats::update_descriptor_sets()
 
 void TAAStats::setup_images()
 {
-	VkExtent3D extent = {get_render_context().get_surface_extent().width, 
-		get_render_context().get_surface_extent().height, 1};
+	VkExtent3D extent = {get_filter_extent().width, get_filter_extent().height, 1};
 
 	main_pass.image = std::make_unique<vkb::core::Image>(get_device(), extent, VK_FORMAT_R8G8B8A8_UNORM,
 		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
@@ -1017,12 +1235,83 @@ void TAAStats::setup_images()
 		VK_IMAGE_VIEW_TYPE_2D, main_pass.image->get_format());
 
 	storage_image = std::make_unique<vkb::core::Image>(get_device(), extent, VK_FORMAT_R8G8B8A8_UNORM,
-		VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_GPU_ONLY);
 
 	storage_image_view = std::make_unique<vkb::core::ImageView>(*storage_image,
 		VK_IMAGE_VIEW_TYPE_2D, storage_image->get_format());
 }
 
+void TAAStats::update_extent_push_constants()
+{
+	VkExtent2D filter_extent = get_filter_extent();
+
+	pushConstGraphics.offset_width 	= 1.0f / filter_extent.width;
+	pushConstGraphics.offset_height = 1.0f / filter_extent.height;
+	pushConstCompute.width 			= filter_extent.width;
+	pushConstCompute.height 		= filter_extent.height;
+}
+
+const vkb::core::Image &TAAStats::get_output_image() const
+{
+	return *storage_image;
+}
+
+std::vector<vkb::BenchmarkTarget::Variant> TAAStats::get_benchmark_variants() const
+{
+	std::vector<Variant> variants;
+	for (auto &configuration : get_benchmark_configurations())
+	{
+		const char *type_name = configuration.type == DEF ? "DEF" : configuration.type == OPT ? "OPT" : "COMP";
+		variants.push_back({type_name, fmt::format("{0}x{0}", 2 * configuration.window + 3)});
+	}
+	return variants;
+}
+
+void TAAStats::set_benchmark_variant(size_t index)
+{
+	auto configuration = get_benchmark_configurations()[index];
+	type               = configuration.type;
+	pipeline_id        = configuration.window;
+
+	wait_active_pipelines();
+	reset_timings();
+
+	invalidate_frames();
+}
+
+std::vector<vkb::BenchmarkTarget::PassTime> TAAStats::get_benchmark_pass_times()
+{
+	if (!has_new_timings(filter_timings))
+	{
+		return {};
+	}
+	return {{"filter", filter_timings.last()}};
+}
+
+std::vector<vkb::BenchmarkTarget::Metric> TAAStats::finish_benchmark_variant()
+{
+	return profile_passes({{"filter", [this](VkCommandBuffer cmd) { record_filter_pass(cmd, {}); }}});
+}
+
+std::vector<std::string> TAAStats::get_benchmark_notes() const
+{
+	return {"the TAA statistics shaders have no half precision path, only the full precision variants are measured",
+	        "the TAA statistics filters have no array image path, only batches of a single image are measured"};
+}
+
+std::vector<TAAStats::BenchmarkConfiguration> TAAStats::get_benchmark_configurations() const
+{
+	std::vector<BenchmarkConfiguration> configurations;
+	for (Type configuration_type : {DEF, OPT, COMP})
+	{
+		for (uint32_t i = 0; i < window_count; ++i)
+		{
+			configurations.push_back({configuration_type, i});
+		}
+	}
+	return configurations;
+}
+
 std::unique_ptr<vkb::VulkanSample> create_taa_stats()
 {
 	return std::make_unique<TAAStats>();
@@ -17,9 +17,13 @@
 
 #pragma once
 
-#include "api_vulkan_sample.h"
+#include "filter_benchmark_sample.h"
+#include "pipeline_builder.h"
+#include "stats/timestamp_query_ring.h"
+#include "stats/timing_statistics.h"
+#include "workgroup_tuner.h"
 
-class TAAStats : public ApiVulkanSample
+class TAAStats : public FilterBenchmarkSample
 {
 public:
 	TAAStats();
@@ -33,6 +37,13 @@ public:
 	virtual bool resize(uint32_t width, uint32_t height) override;
 	virtual void setup_framebuffer() override;
 	virtual void setup_render_pass() override;
+
+	// Benchmark runner interface
+	virtual std::vector<Variant> get_benchmark_variants() const override;
+	virtual void set_benchmark_variant(size_t index) override;
+	virtual std::vector<PassTime> get_benchmark_pass_times() override;
+	virtual std::vector<Metric>   finish_benchmark_variant() override;
+	virtual std::vector<std::string> get_benchmark_notes() const override;
 private:
 	static constexpr std::string_view texture_path = "textures/Lenna.ktx";
 
@@ -45,9 +56,13 @@ private:
 	// compute shaders and pipelines
 	static constexpr std::string_view taa_statistics_comp_path = 
 		"taa_statistics/taa_comp.comp";
-	static constexpr uint32_t workgroup_axis_size = 16u;
+	static constexpr uint32_t default_workgroup_axis_size = 16u;
 	std::array<VkPipeline, window_count> taa_statistics_comp_pipelines {};
 
+	// side of the square workgroups of every window, from the tuning database if the device was tuned
+	std::array<uint32_t, window_count> workgroup_axis_sizes {};
+	std::unique_ptr<vkb::WorkgroupTuner> workgroup_tuner;
+
 	// common vertex shader for default, optimized and resolve shaders
 	static constexpr std::string_view vertex_shader_path = "quad3_vert.vert";
 	
@@ -63,6 +78,9 @@ private:
 	static constexpr std::string_view resolve_fragment_shader_path = "simple.frag";
 	VkPipeline resolve_pipeline {};
 
+	// creates the pipelines, in the background in lazy mode
+	std::unique_ptr<vkb::PipelineBuilder> pipeline_builder;
+
 	struct
 	{
 		VkPipelineLayout resolve;
@@ -83,7 +101,7 @@ private:
 		VkDescriptorSet resolve;
 	} descriptor_sets;
 
-	VkQueryPool query_pool;
+	std::unique_ptr<vkb::TimestampQueryRing> timestamp_queries;
 
 	std::unique_ptr<vkb::core::Image> storage_image;
 	std::unique_ptr<vkb::core::ImageView> storage_image_view;
@@ -102,6 +120,9 @@ private:
 	VkRenderPass filter_pass;
 	std::vector<VkFramebuffer> filter_pass_framebuffers;
 
+	// the graphics filters render into the storage image, which is then scaled to the swapchain
+	VkFramebuffer output_framebuffer {};
+
 	enum Type 
 	{
 		DEF,
@@ -125,21 +146,40 @@ private:
 		float t;
 	} pushConstCompute;
 
-	double frametime_filter  = 0.0;
-	double avg_frametime_filter  = 0.0;
+	// a benchmark variant
+	struct BenchmarkConfiguration
+	{
+		Type type;
 
-	uint64_t n_frames = 0;
+		uint32_t window;
+	};
 
-	uint64_t mask; 
+	// GPU time of the filter pass in ms
+	vkb::TimingStatistics filter_timings;
 
 	void prepare_pipelines();
+	VkPipeline create_compute_pipeline(const VkPipelineShaderStageCreateInfo &stage, uint32_t window, uint32_t axis_size);
+	std::string get_tuning_key(uint32_t window) const;
+	void load_workgroup_sizes();
+	void tune_workgroups();
+	std::vector<const VkPipeline *> get_pipelines(Type pipeline_type, uint32_t window) const;
+	void wait_active_pipelines();
 	void setup_query_pool();
 	void setup_descriptor_set_layouts();
 	void setup_descriptor_pool();
 	void setup_descriptor_sets();
 	void get_frame_time();
+	virtual void reset_timings() override;
 	void update_descriptor_sets();
-	void setup_images();
+	virtual void setup_images() override;
+	virtual void record_frame(uint32_t frame) override;
+	void record_main_pass(VkCommandBuffer cmd);
+	void record_filter_pass(VkCommandBuffer cmd, const std::function<void(VkPipelineStageFlagBits)> &write_timestamp);
+	void record_dispatch(VkCommandBuffer cmd, VkPipeline pipeline, uint32_t axis_size,
+	                     const std::function<void(VkPipelineStageFlagBits)> &write_timestamp);
+	virtual void update_extent_push_constants() override;
+	virtual const vkb::core::Image &get_output_image() const override;
+	std::vector<BenchmarkConfiguration> get_benchmark_configurations() const;
 };
 
 std::unique_ptr<vkb::VulkanSample> create_taa_stats();
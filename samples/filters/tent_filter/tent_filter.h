@@ -17,129 +17,40 @@
 
 #pragma once
 
-#include "api_vulkan_sample.h"
+#include "filter_sample.h"
 
-class TentFilter : public ApiVulkanSample
+/**
+ * @brief Compares fragment and compute tent filters w(dx, dy) = k - b * (|dx| + |dy|), including a
+ *        compute filter of constant cost per texel that slides running sums along the rows and columns
+ *        At large radii b is limited so that the weights stay positive, the UI and the benchmark output show the effective b
+ */
+class TentFilter : public FilterSample
 {
-public:
+  public:
 	TentFilter();
-	virtual ~TentFilter();
-
-	// Override basic framework functionality
-	virtual void build_command_buffers() override;
-	virtual void render(float delta_time) override;
-	virtual bool prepare(const vkb::ApplicationOptions &options) override;
-	virtual void on_update_ui_overlay(vkb::Drawer &drawer) override;
-	virtual bool resize(uint32_t width, uint32_t height) override;
-	virtual void setup_framebuffer() override;
-	virtual void setup_render_pass() override;
-private:
-	static constexpr std::string_view texture_path = "textures/Lenna.ktx";
-
-	// Sample specific data
-	uint32_t pipeline_id = 0; // same for all shader kinds
-
-	// how many shaders of each kind
-	static constexpr uint32_t window_count = 3;
-
-	// compute shaders and pipelines
-	static constexpr std::string_view tent_filter_comp_path = 
-		"tent_filter/tent_comp.comp";
-	static constexpr uint32_t workgroup_axis_size = 16u;
-	std::array<VkPipeline, window_count> tent_filter_comp_pipelines {};
-
-	// common vertex shader for default, optimized and resolve shaders
-	static constexpr std::string_view vertex_shader_path = "quad3_vert.vert";
-	
-	// default frag shaders and pipelines
-	static constexpr std::string_view tent_filter_def_path = "tent_filter/tent.frag";
-	std::array<VkPipeline, window_count> tent_filter_def_pipelines {};
-	
-	// optimized frag shaders and pipelines
-	static constexpr std::string_view tent_filter_opt_path = "tent_filter/tent_optimized.frag";
-	std::array<VkPipeline, window_count> tent_filter_opt_pipelines {};
-	
-	// resolve shader and pipeline
-	static constexpr std::string_view resolve_fragment_shader_path = "simple.frag";
-	VkPipeline resolve_pipeline {};
-
-	struct
-	{
-		VkPipelineLayout resolve;
-		VkPipelineLayout graphics;
-		VkPipelineLayout compute;
-	} pipeline_layouts;
-
-	struct 
-	{
-		VkDescriptorSetLayout graphics_resolve; // common layout
-		VkDescriptorSetLayout compute;
-	} descriptor_set_layouts;
-
-	struct
-	{
-		VkDescriptorSet graphics;
-		VkDescriptorSet compute;
-		VkDescriptorSet resolve;
-	} descriptor_sets;
-
-	VkQueryPool query_pool;
-
-	std::unique_ptr<vkb::core::Image> storage_image;
-	std::unique_ptr<vkb::core::ImageView> storage_image_view;
-
-	struct
-	{
-		Texture 								texture;
-		std::unique_ptr<vkb::core::Image> 		image;
-		std::unique_ptr<vkb::core::ImageView> 	image_view;
-		VkFramebuffer							framebuffer;
-		VkRenderPass 							render_pass;
-		VkDescriptorSet							set;
-		VkPipeline								pipeline;
-	} main_pass {};
-
-	VkRenderPass filter_pass;
-	std::vector<VkFramebuffer> filter_pass_framebuffers;
-
-	enum Type 
-	{
-		DEF,
-		OPT,
-		COMP,
-	} type = DEF;
-
-	struct
-	{
-		float offset_width;
-		float offset_height;
-		float k;
-	    float b;
-	} pushConstGraphics;
+	virtual ~TentFilter() = default;
 
-	struct
-	{
-		uint32_t width;
-		uint32_t height;
-		float k;
-		float b;
-	} pushConstCompute;
+  protected:
+	virtual std::vector<FilterVariant> get_filter_variants() const override;
+	virtual vkb::FilterKernel create_kernel(uint32_t radius) const override;
+	virtual bool on_update_kernel_ui(vkb::Drawer &drawer) override;
+	virtual glm::vec2 get_filter_parameters(uint32_t radius) const override;
+	virtual std::vector<Metric> get_kernel_metrics(uint32_t radius) const override;
 
-	double frametime_filter  = 0.0;
-	double avg_frametime_filter  = 0.0;
+  private:
+	// texels each invocation of the running sum passes writes, the SEGMENT_LENGTH of the shader
+	static constexpr uint32_t segment_length = 64;
 
-	uint64_t n_frames = 0;
+	float k = 7.0f;
 
-	uint64_t mask; 
+	float b = 1.0f;
 
-	void prepare_pipelines();
-	void setup_query_pool();
-	void setup_descriptor_set_layouts();
-	void setup_descriptor_pool();
-	void setup_descriptor_sets();
-	void get_frame_time();
-	void update_descriptor_sets();
-	void setup_images();
+	/**
+	 * @brief Returns the slope of the kernel at the given radius, limited to (k - 0.5) / (2 * radius)
+	 *        so that its corner weight stays at 0.5 or above. Every variant filters with this slope,
+	 *        so at large radii the filter is flatter than the b of the UI
+	 */
+	float get_slope(uint32_t radius) const;
 };
 
 std::unique_ptr<vkb::VulkanSample> create_tent_filter();
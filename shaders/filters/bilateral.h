@@ -0,0 +1,45 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Bilateral filter on the interface of filters/convolution.h. The spatial weights are the
+// two-dimensional kernel, the range weight of a tap falls off with the squared difference of its
+// color to the center: exp(|rgb - center.rgb|^2 * pc.parameters.x). The weights are normalized
+// by their sum, as the range weights change with every texel.
+
+vec4 bilateral(vec2 uv, float layer)
+{
+	filter_vec4  center       = filter_vec4(textureLod(src, vec3(uv, layer), 0));
+	filter_float range_factor = filter_float(pc.parameters.x);
+
+	filter_vec4  sum        = filter_vec4(0.0);
+	filter_float weight_sum = filter_float(0.0);
+	for (int y = -RADIUS; y <= RADIUS; ++y)
+	{
+		for (int x = -RADIUS; x <= RADIUS; ++x)
+		{
+			filter_vec4 value = filter_vec4(textureLod(src, vec3(uv + vec2(x, y) * pc.texel_size, layer), 0));
+			filter_vec4 diff  = value - center;
+
+			filter_float weight = filter_float(kernel.weights_2d[(y + RADIUS) * (2 * RADIUS + 1) + x + RADIUS]) *
+			                      exp(dot(diff.rgb, diff.rgb) * range_factor);
+			sum += weight * value;
+			weight_sum += weight;
+		}
+	}
+	return vec4(sum / weight_sum);
+}
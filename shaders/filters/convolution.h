@@ -0,0 +1,124 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+// Interface shared by the convolution filter shaders, must match FilterSample
+
+#define MAX_RADIUS 32
+
+// FilterSample compiles the shaders with FILTER_FP16 defined for the half precision variants,
+// the weights and samples are converted as they are read and accumulated in half precision.
+// Texture coordinates are always computed in full precision.
+#ifdef FILTER_FP16
+#extension GL_EXT_shader_explicit_arithmetic_types_float16 : require
+#define filter_float float16_t
+#define filter_vec4  f16vec4
+#else
+#define filter_float float
+#define filter_vec4  vec4
+#endif
+
+// FilterSample filters a batch of images as the layers of array images. Compute passes are dispatched
+// with a z of the batch size, fragment passes are compiled with FILTER_MULTIVIEW defined for batches of
+// more than one image and draw every layer at once through a multiview render pass.
+#ifdef FILTER_MULTIVIEW
+#extension GL_EXT_multiview : require
+#define FILTER_VIEW_LAYER float(gl_ViewIndex)
+#else
+#define FILTER_VIEW_LAYER 0.0
+#endif
+
+// Format of the storage image written by compute passes, rgba16f for half precision intermediate images
+#ifndef FILTER_DST_FORMAT
+#define FILTER_DST_FORMAT rgba8
+#endif
+
+layout (constant_id = 0) const int RADIUS = 1;
+
+layout (set = 0, binding = 0) uniform sampler2DArray src;
+
+// With FILTER_FP16_STORAGE (VK_KHR_16bit_storage) the half precision variants read half precision weights,
+// the linear taps stay in full precision as their offsets are texture coordinates.
+#ifdef FILTER_FP16_STORAGE
+#extension GL_EXT_shader_16bit_storage : require
+#define kernel_float float16_t
+#else
+#define kernel_float float
+#endif
+
+layout (std430, set = 0, binding = 2) readonly buffer Kernel
+{
+	// Row of a separable kernel
+	kernel_float weights[2 * MAX_RADIUS + 1];
+
+	// Pairs of adjacent taps of the row merged into bilinear taps, (offset, weight)
+	vec2 linear_taps[MAX_RADIUS + 1];
+
+	// (2 * RADIUS + 1)^2 weights in row-major order
+	kernel_float weights_2d[];
+} kernel;
+
+layout (push_constant) uniform PushConstants
+{
+	ivec2 extent;
+	vec2  texel_size;
+
+	// Sampling direction of one-dimensional passes
+	ivec2 direction;
+
+	// Filter specific parameters, see FilterSample::get_filter_parameters
+	vec2 parameters;
+} pc;
+
+vec4 convolve_2d(vec2 uv, float layer)
+{
+	filter_vec4 sum = filter_vec4(0.0);
+	for (int y = -RADIUS; y <= RADIUS; ++y)
+	{
+		for (int x = -RADIUS; x <= RADIUS; ++x)
+		{
+			filter_float weight = filter_float(kernel.weights_2d[(y + RADIUS) * (2 * RADIUS + 1) + x + RADIUS]);
+			sum += weight * filter_vec4(textureLod(src, vec3(uv + vec2(x, y) * pc.texel_size, layer), 0));
+		}
+	}
+	return vec4(sum);
+}
+
+vec4 convolve_1d(vec2 uv, float layer)
+{
+	vec2 texel_step = vec2(pc.direction) * pc.texel_size;
+
+	filter_vec4 sum = filter_vec4(0.0);
+	for (int i = -RADIUS; i <= RADIUS; ++i)
+	{
+		sum += filter_float(kernel.weights[i + RADIUS]) * filter_vec4(textureLod(src, vec3(uv + float(i) * texel_step, layer), 0));
+	}
+	return vec4(sum);
+}
+
+vec4 convolve_linear(vec2 uv, float layer)
+{
+	vec2 texel_step = vec2(pc.direction) * pc.texel_size;
+
+	filter_vec4 sum = filter_vec4(0.0);
+	for (int i = 0; i <= RADIUS; ++i)
+	{
+		vec2 tap = kernel.linear_taps[i];
+		sum += filter_float(tap.y) * filter_vec4(textureLod(src, vec3(uv + tap.x * texel_step, layer), 0));
+	}
+	return vec4(sum);
+}
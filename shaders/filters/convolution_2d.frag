@@ -0,0 +1,31 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#version 450
+
+#extension GL_GOOGLE_include_directive : require
+
+#include "filters/convolution.h"
+
+layout (location = 0) in vec2 texCoord;
+
+layout (location = 0) out vec4 color;
+
+void main()
+{
+	color = convolve_2d(texCoord, FILTER_VIEW_LAYER);
+}
@@ -0,0 +1,188 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "aliased_image_placement.h"
+
+using namespace vkb;
+
+namespace
+{
+constexpr uint32_t all_memory_types = 0xff;
+
+AliasedImageRequest create_request(VkDeviceSize size, uint64_t variants, VkDeviceSize alignment = 256, uint32_t memory_types = all_memory_types)
+{
+	return {{size, alignment, memory_types}, variants};
+}
+
+// block holding an image
+size_t find_block(const std::vector<AliasedImageBlock> &blocks, size_t image)
+{
+	for (size_t i = 0; i < blocks.size(); ++i)
+	{
+		if (std::find(blocks[i].images.begin(), blocks[i].images.end(), image) != blocks[i].images.end())
+		{
+			return i;
+		}
+	}
+	return blocks.size();
+}
+
+// checks that every image is placed once, into a block that fits it and whose other images it shares no variant with
+void check_placement(const std::vector<AliasedImageRequest> &images, const std::vector<AliasedImageBlock> &blocks)
+{
+	size_t placed = 0;
+	for (auto &block : blocks)
+	{
+		uint64_t variants = 0;
+		for (size_t image : block.images)
+		{
+			auto &requirements = images[image].requirements;
+			REQUIRE((variants & images[image].variants) == 0);
+			REQUIRE(block.requirements.size >= requirements.size);
+			REQUIRE(block.requirements.alignment >= requirements.alignment);
+			REQUIRE((block.requirements.memoryTypeBits & ~requirements.memoryTypeBits) == 0);
+			variants |= images[image].variants;
+		}
+		REQUIRE(block.variants == variants);
+		REQUIRE(block.requirements.memoryTypeBits != 0);
+		placed += block.images.size();
+	}
+	REQUIRE(placed == images.size());
+}
+}        // namespace
+
+TEST_CASE("vkb::place_aliased_images shares memory between disjoint variants", "[aliased_image_placement]")
+{
+	// the images of a filter sample: source and output of every variant, an intermediate image of the
+	// separable variants 1 and 2 and an accumulation image of variant 3
+	std::vector<AliasedImageRequest> images{
+	    create_request(1024, 0b1111),
+	    create_request(1024, 0b1111),
+	    create_request(2048, 0b0110),
+	    create_request(4096, 0b1000),
+	};
+
+	auto blocks = place_aliased_images(images);
+	check_placement(images, blocks);
+
+	// the accumulation image comes first and the intermediate image shares its memory
+	REQUIRE(blocks.size() == 3);
+	REQUIRE(find_block(blocks, 2) == find_block(blocks, 3));
+	REQUIRE(blocks[find_block(blocks, 3)].requirements.size == 4096);
+	REQUIRE(find_block(blocks, 0) != find_block(blocks, 1));
+
+	VkDeviceSize allocated = 0;
+	for (auto &block : blocks)
+	{
+		allocated += block.requirements.size;
+	}
+	REQUIRE(allocated == 4096 + 2 * 1024);
+}
+
+TEST_CASE("vkb::place_aliased_images keeps images of a variant apart", "[aliased_image_placement]")
+{
+	// every image is used by variant 0, so nothing can alias
+	std::vector<AliasedImageRequest> images{
+	    create_request(512, 0b01),
+	    create_request(512, 0b11),
+	    create_request(512, 0b01),
+	};
+
+	auto blocks = place_aliased_images(images);
+	check_placement(images, blocks);
+	REQUIRE(blocks.size() == 3);
+
+	// images of a single variant each all alias
+	images = {
+	    create_request(512, 0b001),
+	    create_request(256, 0b010),
+	    create_request(768, 0b100),
+	};
+	blocks = place_aliased_images(images);
+	check_placement(images, blocks);
+	REQUIRE(blocks.size() == 1);
+	REQUIRE(blocks[0].requirements.size == 768);
+
+	// the variants are a bitmask of up to 64 variants
+	images = {
+	    create_request(512, uint64_t{1} << 63),
+	    create_request(512, uint64_t{1} << 62),
+	    create_request(512, uint64_t{1} << 63),
+	};
+	blocks = place_aliased_images(images);
+	check_placement(images, blocks);
+	REQUIRE(blocks.size() == 2);
+	REQUIRE(find_block(blocks, 0) != find_block(blocks, 2));
+}
+
+TEST_CASE("vkb::place_aliased_images combines the requirements of a block", "[aliased_image_placement]")
+{
+	std::vector<AliasedImageRequest> images{
+	    create_request(4096, 0b001, 256, 0b0111),
+	    create_request(1024, 0b010, 4096, 0b0110),
+	    // no memory type in common with the first block
+	    create_request(2048, 0b100, 256, 0b1000),
+	};
+
+	auto blocks = place_aliased_images(images);
+	check_placement(images, blocks);
+	REQUIRE(blocks.size() == 2);
+
+	auto &shared = blocks[find_block(blocks, 0)];
+	REQUIRE(find_block(blocks, 1) == find_block(blocks, 0));
+	REQUIRE(shared.requirements.size == 4096);
+	REQUIRE(shared.requirements.alignment == 4096);
+	REQUIRE(shared.requirements.memoryTypeBits == 0b0110);
+
+	REQUIRE(find_block(blocks, 2) != find_block(blocks, 0));
+	REQUIRE(blocks[find_block(blocks, 2)].requirements.memoryTypeBits == 0b1000);
+}
+
+TEST_CASE("vkb::place_aliased_images places larger images first", "[aliased_image_placement]")
+{
+	// requested smallest first, the large image still starts a block that the smaller ones join
+	std::vector<AliasedImageRequest> images{
+	    create_request(256, 0b001),
+	    create_request(1024, 0b010),
+	    create_request(8192, 0b100),
+	};
+
+	auto blocks = place_aliased_images(images);
+	check_placement(images, blocks);
+	REQUIRE(blocks.size() == 1);
+	REQUIRE(blocks[0].images == std::vector<size_t>({2, 1, 0}));
+
+	// equal sizes keep the order of the requests
+	images = {
+	    create_request(1024, 0b01),
+	    create_request(1024, 0b10),
+	};
+	blocks = place_aliased_images(images);
+	REQUIRE(blocks[0].images == std::vector<size_t>({0, 1}));
+
+	REQUIRE(place_aliased_images({}).empty());
+}
@@ -0,0 +1,246 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <stdexcept>
+#include <vector>
+
+#include "cpu_filter.h"
+
+using namespace vkb;
+
+namespace
+{
+// not a multiple of the vector widths, so the kernels also run on the texels left at the end of a row,
+// and taller than a band of rows
+constexpr uint32_t image_width  = 37;
+constexpr uint32_t image_height = 41;
+
+// RGBA8 test image with edges in both directions and an alpha gradient
+CpuFilter::Image create_image()
+{
+	CpuFilter::Image image{image_width, image_height, std::vector<uint8_t>(image_width * image_height * 4)};
+	for (uint32_t y = 0; y < image_height; ++y)
+	{
+		for (uint32_t x = 0; x < image_width; ++x)
+		{
+			uint8_t *texel = &image.pixels[(y * image_width + x) * 4];
+			texel[0]       = static_cast<uint8_t>((x * 37 + y * 11) % 256);
+			texel[1]       = static_cast<uint8_t>(x > y ? 230 : 20);
+			texel[2]       = static_cast<uint8_t>((x * y * 7) % 256);
+			texel[3]       = static_cast<uint8_t>(y * 255 / (image_height - 1));
+		}
+	}
+	return image;
+}
+
+// channel of a texel as unorm, clamped to the edge like the samplers of the filters
+double texel(const CpuFilter::Image &image, int32_t x, int32_t y, uint32_t c)
+{
+	x = std::clamp(x, 0, static_cast<int32_t>(image.width) - 1);
+	y = std::clamp(y, 0, static_cast<int32_t>(image.height) - 1);
+	return image.pixels[(y * image.width + x) * 4 + c] / 255.0;
+}
+
+/**
+ * @brief Scalar reference of a filter, in double precision and directly over the window of each texel
+ * @param weight Weight of the texel at an offset, given the center texel
+ */
+CpuFilter::Image filter_reference(const CpuFilter::Image &src, uint32_t radius, const std::function<double(const CpuFilter::Image &, int32_t, int32_t, int32_t, int32_t)> &weight)
+{
+	int32_t          r = static_cast<int32_t>(radius);
+	CpuFilter::Image dst{src.width, src.height, std::vector<uint8_t>(src.pixels.size())};
+	for (int32_t y = 0; y < static_cast<int32_t>(src.height); ++y)
+	{
+		for (int32_t x = 0; x < static_cast<int32_t>(src.width); ++x)
+		{
+			double sum[4]     = {};
+			double weight_sum = 0.0;
+			for (int32_t j = -r; j <= r; ++j)
+			{
+				for (int32_t i = -r; i <= r; ++i)
+				{
+					double w = weight(src, x, y, i, j);
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						sum[c] += w * texel(src, x + i, y + j, c);
+					}
+					weight_sum += w;
+				}
+			}
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				double value                            = std::clamp(sum[c] / weight_sum, 0.0, 1.0);
+				dst.pixels[(y * src.width + x) * 4 + c] = static_cast<uint8_t>(value * 255.0 + 0.5);
+			}
+		}
+	}
+	return dst;
+}
+
+CpuFilter::Image gaussian_reference(const CpuFilter::Image &src, uint32_t radius, double gaussian_divisor)
+{
+	return filter_reference(src, radius, [=](const CpuFilter::Image &, int32_t, int32_t, int32_t i, int32_t j) {
+		return std::exp((i * i + j * j) * gaussian_divisor);
+	});
+}
+
+CpuFilter::Image bilateral_reference(const CpuFilter::Image &src, uint32_t radius, double gaussian_divisor, double intensities_divisor)
+{
+	return filter_reference(src, radius, [=](const CpuFilter::Image &image, int32_t x, int32_t y, int32_t i, int32_t j) {
+		double distance = 0.0;
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			double diff = texel(image, x + i, y + j, c) - texel(image, x, y, c);
+			distance += diff * diff;
+		}
+		return std::exp((i * i + j * j) * gaussian_divisor + distance * intensities_divisor);
+	});
+}
+
+CpuFilter::Image tent_reference(const CpuFilter::Image &src, uint32_t radius, double k, double b)
+{
+	return filter_reference(src, radius, [=](const CpuFilter::Image &, int32_t, int32_t, int32_t i, int32_t j) {
+		return k - b * (std::abs(i) + std::abs(j));
+	});
+}
+
+// the filters accumulate in single precision, which may round a texel to the neighbouring value
+void require_close(const CpuFilter::Image &result, const CpuFilter::Image &reference)
+{
+	REQUIRE(result.width == reference.width);
+	REQUIRE(result.height == reference.height);
+	REQUIRE(result.pixels.size() == reference.pixels.size());
+	for (size_t i = 0; i < reference.pixels.size(); ++i)
+	{
+		REQUIRE(std::abs(static_cast<int32_t>(result.pixels[i]) - static_cast<int32_t>(reference.pixels[i])) <= 1);
+	}
+}
+}        // namespace
+
+TEST_CASE("vkb::CpuFilter gaussian matches the reference", "[cpu_filter]")
+{
+	auto      image = create_image();
+	CpuFilter filter{2};
+
+	for (auto instruction_set : CpuFilter::get_supported_instruction_sets())
+	{
+		filter.set_instruction_set(instruction_set);
+		for (uint32_t radius : {0u, 1u, 3u, 8u})
+		{
+			float            divisor = -0.5f / (2.0f * 2.0f);
+			CpuFilter::Image result;
+			filter.gaussian(image, result, radius, divisor);
+			require_close(result, gaussian_reference(image, radius, divisor));
+		}
+	}
+}
+
+TEST_CASE("vkb::CpuFilter bilateral matches the reference", "[cpu_filter]")
+{
+	auto      image = create_image();
+	CpuFilter filter{2};
+
+	for (auto instruction_set : CpuFilter::get_supported_instruction_sets())
+	{
+		filter.set_instruction_set(instruction_set);
+		for (uint32_t radius : {1u, 2u, 3u})
+		{
+			float            gaussian_divisor    = -0.5f / (1.5f * 1.5f);
+			float            intensities_divisor = -0.5f / (0.2f * 0.2f);
+			CpuFilter::Image result;
+			filter.bilateral(image, result, radius, gaussian_divisor, intensities_divisor);
+			require_close(result, bilateral_reference(image, radius, gaussian_divisor, intensities_divisor));
+		}
+	}
+}
+
+TEST_CASE("vkb::CpuFilter tent matches the reference", "[cpu_filter]")
+{
+	auto      image = create_image();
+	CpuFilter filter{2};
+
+	for (auto instruction_set : CpuFilter::get_supported_instruction_sets())
+	{
+		filter.set_instruction_set(instruction_set);
+		for (uint32_t radius : {1u, 2u, 3u})
+		{
+			CpuFilter::Image result;
+			filter.tent(image, result, radius, 7.0f, 1.0f);
+			require_close(result, tent_reference(image, radius, 7.0, 1.0));
+		}
+
+		// the slope is limited to (k - 0.5) / (2 * radius), so that the corner weight stays at 0.5
+		CpuFilter::Image result;
+		filter.tent(image, result, 8, 7.0f, 1.5f);
+		require_close(result, tent_reference(image, 8, 7.0, 6.5 / 16.0));
+	}
+}
+
+TEST_CASE("vkb::CpuFilter instruction sets are bit-exact", "[cpu_filter]")
+{
+	auto      image            = create_image();
+	auto      instruction_sets =CpuFilter::get_supported_instruction_sets();
+	CpuFilter filter{2};
+
+	REQUIRE(instruction_sets.front() == CpuFilter::InstructionSet::Scalar);
+
+	std::vector<std::function<void(CpuFilter::Image &)>> filters{
+	    [&](CpuFilter::Image &dst) { filter.gaussian(image, dst, 4, -0.5f / 4.0f); },
+	    [&](CpuFilter::Image &dst) { filter.bilateral(image, dst, 2, -0.5f, -12.5f); },
+	    [&](CpuFilter::Image &dst) { filter.tent(image, dst, 3, 9.0f, 1.0f); },
+	};
+	for (auto &run : filters)
+	{
+		filter.set_instruction_set(CpuFilter::InstructionSet::Scalar);
+		CpuFilter::Image scalar;
+		run(scalar);
+
+		for (auto instruction_set : instruction_sets)
+		{
+			filter.set_instruction_set(instruction_set);
+			CpuFilter::Image result;
+			run(result);
+			REQUIRE(result.pixels == scalar.pixels);
+		}
+	}
+}
+
+TEST_CASE("vkb::CpuFilter invalid sources and unsupported filters", "[cpu_filter]")
+{
+	CpuFilter        filter{1};
+	CpuFilter::Image result;
+
+	REQUIRE_THROWS_AS(filter.gaussian({0, 4, {}}, result, 1, -0.5f), std::invalid_argument);
+	REQUIRE_THROWS_AS(filter.tent({4, 4, std::vector<uint8_t>(4 * 4 * 4 - 1)}, result, 1, 7.0f, 1.0f), std::invalid_argument);
+
+	// the TAA statistics filter leaves the destination unchanged
+	auto image = create_image();
+	result     = image;
+	REQUIRE_FALSE(filter.taa_statistics(image, result, 1, 1.0f, 0.5f));
+	REQUIRE(result.pixels == image.pixels);
+}
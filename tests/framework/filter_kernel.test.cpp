@@ -0,0 +1,239 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+#include "filter_kernel.h"
+
+using namespace vkb;
+
+namespace
+{
+constexpr int image_size = 16;
+
+// single channel test image with edges in both directions
+std::vector<float> create_image()
+{
+	std::vector<float> image(image_size * image_size);
+	for (int y = 0; y < image_size; ++y)
+	{
+		for (int x = 0; x < image_size; ++x)
+		{
+			image[y * image_size + x] = static_cast<float>((x * 7 + y * 13) % 17) + (x > y ? 10.0f : 0.0f);
+		}
+	}
+	return image;
+}
+
+// texel of the image, clamped to its border like the samplers of the filters
+float texel(const std::vector<float> &image, int x, int y)
+{
+	x = std::clamp(x, 0, image_size - 1);
+	y = std::clamp(y, 0, image_size - 1);
+	return image[y * image_size + x];
+}
+
+std::vector<float> convolve_2d(const std::vector<float> &image, const FilterKernel &kernel)
+{
+	int  radius  = static_cast<int>(kernel.get_radius());
+	int  size    = static_cast<int>(kernel.get_size());
+	auto weights = kernel.get_weights_2d();
+
+	std::vector<float> result(image.size());
+	for (int y = 0; y < image_size; ++y)
+	{
+		for (int x = 0; x < image_size; ++x)
+		{
+			float sum = 0.0f;
+			for (int j = -radius; j <= radius; ++j)
+			{
+				for (int i = -radius; i <= radius; ++i)
+				{
+					sum += weights[(j + radius) * size + i + radius] * texel(image, x + i, y + j);
+				}
+			}
+			result[y * image_size + x] = sum;
+		}
+	}
+	return result;
+}
+
+std::vector<float> convolve_1d(const std::vector<float> &image, const FilterKernel &kernel, int direction_x, int direction_y)
+{
+	int   radius  = static_cast<int>(kernel.get_radius());
+	auto &weights = kernel.get_weights();
+
+	std::vector<float> result(image.size());
+	for (int y = 0; y < image_size; ++y)
+	{
+		for (int x = 0; x < image_size; ++x)
+		{
+			float sum = 0.0f;
+			for (int i = -radius; i <= radius; ++i)
+			{
+				sum += weights[i + radius] * texel(image, x + i * direction_x, y + i * direction_y);
+			}
+			result[y * image_size + x] = sum;
+		}
+	}
+	return result;
+}
+
+// linear filtering of a row of the image, at a fractional texel position
+float sample_row(const std::vector<float> &image, float x, int y)
+{
+	float base     = std::floor(x);
+	float fraction = x - base;
+	int   texel_x  = static_cast<int>(base);
+	return (1.0f - fraction) * texel(image, texel_x, y) + fraction * texel(image, texel_x + 1, y);
+}
+}        // namespace
+
+TEST_CASE("vkb::FilterKernel normalization", "[filter_kernel]")
+{
+	for (uint32_t radius : {0u, 1u, 3u, 8u, FilterKernel::max_radius})
+	{
+		for (auto &kernel : {FilterKernel::gaussian(radius, std::max(1.0f, radius / 2.0f)), FilterKernel::box(radius), FilterKernel::tent(radius)})
+		{
+			auto &weights = kernel.get_weights();
+			REQUIRE(weights.size() == kernel.get_size());
+			REQUIRE(std::accumulate(weights.begin(), weights.end(), 0.0) == Catch::Approx(1.0).margin(1e-5));
+
+			auto weights_2d = kernel.get_weights_2d();
+			REQUIRE(std::accumulate(weights_2d.begin(), weights_2d.end(), 0.0) == Catch::Approx(1.0).margin(1e-5));
+
+			// symmetric around the center tap
+			for (size_t i = 0; i < weights.size(); ++i)
+			{
+				REQUIRE(weights[i] == Catch::Approx(weights[weights.size() - 1 - i]));
+			}
+		}
+	}
+
+	// the weights of the explicit kernels are used as given
+	auto row = FilterKernel::from_row("row", {1.0f, 2.0f, 1.0f});
+	REQUIRE(row.get_weights() == std::vector<float>({1.0f, 2.0f, 1.0f}));
+}
+
+TEST_CASE("vkb::FilterKernel radius 32", "[filter_kernel]")
+{
+	auto kernel = FilterKernel::gaussian(FilterKernel::max_radius, 12.0f);
+	REQUIRE(kernel.get_radius() == 32);
+	REQUIRE(kernel.get_size() == 65);
+	REQUIRE(kernel.get_weights().size() == 65);
+	REQUIRE(kernel.get_weights_2d().size() == 65 * 65);
+	REQUIRE(kernel.get_linear_taps().size() == 33);
+
+	// the kernel buffer of the shaders has no room for larger kernels
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(FilterKernel::max_radius + 1, 12.0f), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::from_row("row", std::vector<float>(67, 1.0f)), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::from_weights("weights", std::vector<float>(67 * 67, 1.0f)), std::invalid_argument);
+}
+
+TEST_CASE("vkb::FilterKernel separable and 2D convolutions agree", "[filter_kernel]")
+{
+	auto image = create_image();
+
+	for (auto &kernel : {FilterKernel::gaussian(2, 1.0f), FilterKernel::tent(3), FilterKernel::box(5)})
+	{
+		// a horizontal then a vertical pass of the row, against the outer product of the row
+		auto separable = convolve_1d(convolve_1d(image, kernel, 1, 0), kernel, 0, 1);
+		auto full      = convolve_2d(image, kernel);
+
+		// the same weights as a non-separable kernel
+		auto non_separable = FilterKernel::from_weights(kernel.get_name(), kernel.get_weights_2d());
+		REQUIRE_FALSE(non_separable.is_separable());
+		auto non_separable_full = convolve_2d(image, non_separable);
+
+		// the clamp to the border commutes with the passes, so the results agree everywhere
+		for (size_t i = 0; i < image.size(); ++i)
+		{
+			REQUIRE(separable[i] == Catch::Approx(full[i]).margin(1e-4));
+			REQUIRE(non_separable_full[i] == Catch::Approx(full[i]).margin(1e-4));
+		}
+	}
+}
+
+TEST_CASE("vkb::FilterKernel linear taps agree with the row", "[filter_kernel]")
+{
+	auto image = create_image();
+
+	for (auto &kernel : {FilterKernel::gaussian(4, 2.0f), FilterKernel::tent(2)})
+	{
+		REQUIRE(kernel.supports_linear_sampling());
+
+		auto taps       = kernel.get_linear_taps();
+		auto horizontal = convolve_1d(image, kernel, 1, 0);
+
+		// away from the border, where the bilinear taps would clamp differently
+		int radius = static_cast<int>(kernel.get_radius());
+		for (int y = 0; y < image_size; ++y)
+		{
+			for (int x = radius; x < image_size - radius - 1; ++x)
+			{
+				float sum = 0.0f;
+				for (auto &tap : taps)
+				{
+					sum += tap.weight * sample_row(image, static_cast<float>(x) + tap.offset, y);
+				}
+				REQUIRE(sum == Catch::Approx(horizontal[y * image_size + x]).margin(1e-4));
+			}
+		}
+	}
+
+	// non-separable kernels have no row to merge
+	REQUIRE(FilterKernel::from_weights("weights", std::vector<float>(9, 1.0f / 9.0f)).get_linear_taps().empty());
+}
+
+TEST_CASE("vkb::FilterKernel invalid gaussian parameters", "[filter_kernel]")
+{
+	// a zero sigma would divide by zero and a negative one would not fall off
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(4, 0.0f), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(4, -1.0f), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(4, std::nanf("")), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(4, INFINITY), std::invalid_argument);
+
+	// small but positive sigmas give finite weights that collapse onto the center tap
+	auto narrow = FilterKernel::gaussian(4, 0.01f);
+	for (float weight : narrow.get_weights())
+	{
+		REQUIRE(std::isfinite(weight));
+	}
+	REQUIRE(narrow.get_weights()[4] == Catch::Approx(1.0f));
+}
+
+TEST_CASE("vkb::FilterKernel radius is validated before the weights are allocated", "[filter_kernel]")
+{
+	// a radius that would overflow the tap count is rejected rather than allocated
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(UINT32_MAX / 2, 1.0f), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::box(UINT32_MAX / 2), std::invalid_argument);
+	REQUIRE_THROWS_AS(FilterKernel::tent(UINT32_MAX / 2), std::invalid_argument);
+
+	// the radius is checked before the sigma
+	REQUIRE_THROWS_AS(FilterKernel::gaussian(FilterKernel::max_radius + 1, 0.0f), std::invalid_argument);
+}
@@ -0,0 +1,141 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "pipeline_cache_data.h"
+
+using namespace vkb;
+
+namespace
+{
+VkPhysicalDeviceProperties create_properties()
+{
+	VkPhysicalDeviceProperties properties{};
+	properties.vendorID      = 0x13b5;
+	properties.deviceID      = 0x92020010;
+	properties.driverVersion = 0x0a0b0c0d;
+	for (uint32_t i = 0; i < VK_UUID_SIZE; ++i)
+	{
+		properties.pipelineCacheUUID[i] = static_cast<uint8_t>(i * 17);
+	}
+	return properties;
+}
+
+// cache data as a driver returns it, the header followed by the cached pipelines
+std::vector<uint8_t> create_cache_data(const VkPhysicalDeviceProperties &properties, size_t payload_size = 64)
+{
+	VkPipelineCacheHeaderVersionOne header{};
+	header.headerSize    = sizeof(header);
+	header.headerVersion = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
+	header.vendorID      = properties.vendorID;
+	header.deviceID      = properties.deviceID;
+	std::memcpy(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE);
+
+	std::vector<uint8_t> data(sizeof(header) + payload_size, 0xab);
+	std::memcpy(data.data(), &header, sizeof(header));
+	return data;
+}
+
+// modifies a field of the header of cache data
+template <typename Modify>
+std::vector<uint8_t> modify_header(std::vector<uint8_t> data, Modify modify)
+{
+	VkPipelineCacheHeaderVersionOne header{};
+	std::memcpy(&header, data.data(), sizeof(header));
+	modify(header);
+	std::memcpy(data.data(), &header, sizeof(header));
+	return data;
+}
+}        // namespace
+
+TEST_CASE("vkb::is_valid_pipeline_cache accepts the data of the device", "[pipeline_cache_data]")
+{
+	auto properties = create_properties();
+
+	REQUIRE(is_valid_pipeline_cache(create_cache_data(properties), properties));
+
+	// an empty cache is just the header
+	REQUIRE(is_valid_pipeline_cache(create_cache_data(properties, 0), properties));
+
+	// the driver version is not part of the header, the file name separates the drivers
+	auto updated_driver = properties;
+	updated_driver.driverVersion += 1;
+	REQUIRE(is_valid_pipeline_cache(create_cache_data(properties), updated_driver));
+}
+
+TEST_CASE("vkb::is_valid_pipeline_cache rejects the data of other devices", "[pipeline_cache_data]")
+{
+	auto properties = create_properties();
+	auto data       = create_cache_data(properties);
+
+	auto other_vendor = properties;
+	other_vendor.vendorID += 1;
+	REQUIRE_FALSE(is_valid_pipeline_cache(data, other_vendor));
+
+	auto other_device = properties;
+	other_device.deviceID += 1;
+	REQUIRE_FALSE(is_valid_pipeline_cache(data, other_device));
+
+	auto other_uuid = properties;
+	other_uuid.pipelineCacheUUID[VK_UUID_SIZE - 1] ^= 1;
+	REQUIRE_FALSE(is_valid_pipeline_cache(data, other_uuid));
+}
+
+TEST_CASE("vkb::is_valid_pipeline_cache rejects malformed headers", "[pipeline_cache_data]")
+{
+	auto properties = create_properties();
+	auto data       = create_cache_data(properties);
+
+	// truncated before the end of the header
+	REQUIRE_FALSE(is_valid_pipeline_cache({}, properties));
+	REQUIRE_FALSE(is_valid_pipeline_cache(std::vector<uint8_t>(data.begin(), data.begin() + sizeof(VkPipelineCacheHeaderVersionOne) - 1), properties));
+
+	// a header size smaller than the header, or beyond the data
+	REQUIRE_FALSE(is_valid_pipeline_cache(modify_header(data, [](auto &header) { header.headerSize = sizeof(header) - 1; }), properties));
+	REQUIRE_FALSE(is_valid_pipeline_cache(modify_header(data, [&](auto &header) { header.headerSize = static_cast<uint32_t>(data.size() + 1); }), properties));
+
+	// a larger header of a later version is fine as long as it fits
+	REQUIRE(is_valid_pipeline_cache(modify_header(data, [&](auto &header) { header.headerSize = static_cast<uint32_t>(data.size()); }), properties));
+
+	// an unknown header version
+	REQUIRE_FALSE(is_valid_pipeline_cache(modify_header(data, [](auto &header) { header.headerVersion = static_cast<VkPipelineCacheHeaderVersion>(2); }), properties));
+}
+
+TEST_CASE("vkb::get_pipeline_cache_filename identifies the device and driver", "[pipeline_cache_data]")
+{
+	auto properties = create_properties();
+	auto filename   = get_pipeline_cache_filename(properties);
+
+	REQUIRE(filename == "pipeline_cache_13b5_92020010_0a0b0c0d_00112233445566778899aabbccddeeff.bin");
+
+	auto updated_driver = properties;
+	updated_driver.driverVersion += 1;
+	REQUIRE(get_pipeline_cache_filename(updated_driver) != filename);
+
+	auto other_uuid = properties;
+	other_uuid.pipelineCacheUUID[0] ^= 1;
+	REQUIRE(get_pipeline_cache_filename(other_uuid) != filename);
+}
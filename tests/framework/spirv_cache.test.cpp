@@ -0,0 +1,250 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "platform/filesystem.h"
+#include "spirv_cache.h"
+
+using namespace vkb;
+
+namespace
+{
+// shaders directory and cache directory of the test, in place of the platform file system
+std::map<std::string, std::string> shader_files;
+
+std::map<std::string, std::vector<uint8_t>> cache_files;
+
+std::vector<uint8_t> to_bytes(const std::string &source)
+{
+	return {source.begin(), source.end()};
+}
+
+uint64_t hash_source(const std::string &source)
+{
+	uint64_t hash = 0;
+	REQUIRE(SpirvCache::hash_source(to_bytes(source), hash));
+	return hash;
+}
+
+// an entry in the layout SpirvCache writes: magic, version, key and word count, then the words
+std::vector<uint8_t> create_entry(uint32_t magic, uint32_t version, uint64_t key, const std::vector<uint32_t> &spirv)
+{
+	struct
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t key;
+		uint64_t word_count;
+	} header{magic, version, key, spirv.size()};
+
+	std::vector<uint8_t> data(sizeof(header) + spirv.size() * sizeof(uint32_t));
+	std::memcpy(data.data(), &header, sizeof(header));
+	std::memcpy(data.data() + sizeof(header), spirv.data(), spirv.size() * sizeof(uint32_t));
+	return data;
+}
+
+std::string get_filename(uint64_t key)
+{
+	char name[64];
+	std::snprintf(name, sizeof(name), "spirv_%016llx.spv", static_cast<unsigned long long>(key));
+	return name;
+}
+
+constexpr uint32_t cache_magic   = 0x53425643;
+constexpr uint32_t cache_version = 1;
+constexpr uint32_t spirv_magic   = 0x07230203;
+}        // namespace
+
+namespace vkb
+{
+namespace fs
+{
+namespace path
+{
+const std::string get(const Type type, const std::string &file)
+{
+	return file;
+}
+}        // namespace path
+
+bool is_file(const std::string &filename)
+{
+	return shader_files.count(filename) > 0;
+}
+
+std::string read_shader(const std::string &filename)
+{
+	auto it = shader_files.find(filename);
+	if (it == shader_files.end())
+	{
+		throw std::runtime_error("Failed to open file: " + filename);
+	}
+	return it->second;
+}
+
+std::vector<uint8_t> read_cache(const std::string &filename)
+{
+	auto it = cache_files.find(filename);
+	return it == cache_files.end() ? std::vector<uint8_t>{} : it->second;
+}
+
+bool write_cache(const std::vector<uint8_t> &data, const std::string &filename)
+{
+	cache_files[filename] = data;
+	return true;
+}
+}        // namespace fs
+}        // namespace vkb
+
+TEST_CASE("vkb::SpirvCache hash separates the fields of the key", "[spirv_cache]")
+{
+	uint64_t seed = SpirvCache::hash(std::string("seed"), 0);
+
+	// the size of each field is hashed, so moving bytes between consecutive fields changes the key
+	REQUIRE(SpirvCache::hash("c", SpirvCache::hash("ab", seed)) != SpirvCache::hash("bc", SpirvCache::hash("a", seed)));
+	REQUIRE(SpirvCache::hash("", SpirvCache::hash("a", seed)) != SpirvCache::hash("a", seed));
+
+	// the order of the fields matters, e.g. the stage and the entry point
+	REQUIRE(SpirvCache::hash("b", SpirvCache::hash("a", seed)) != SpirvCache::hash("a", SpirvCache::hash("b", seed)));
+
+	// and the hash is stable for the same fields
+	REQUIRE(SpirvCache::hash("main", seed) == SpirvCache::hash(std::string("main"), seed));
+}
+
+TEST_CASE("vkb::SpirvCache source hash follows the includes", "[spirv_cache]")
+{
+	shader_files = {
+	    {"filters/convolution.h", "#include \"kernel.h\"\nvec4 convolve();\n"},
+	    {"filters/kernel.h", "float weights[65];\n"},
+	    {"common.h", "#define PI 3.14\n"},
+	};
+
+	std::string source = "#version 450\n#include \"filters/convolution.h\"\n  #  include <common.h>\nvoid main() {}\n";
+	uint64_t    hash   = hash_source(source);
+	REQUIRE(hash_source(source) == hash);
+
+	// a change to a directly included file
+	shader_files["common.h"] = "#define PI 3.1416\n";
+	uint64_t common_changed  = hash_source(source);
+	REQUIRE(common_changed != hash);
+
+	// a change to a nested include, found relative to the including file
+	shader_files["filters/kernel.h"] = "float weights[67];\n";
+	REQUIRE(hash_source(source) != common_changed);
+
+	// a file of the same name next to the shader is not included
+	uint64_t before        = hash_source(source);
+	shader_files["kernel.h"] = "unrelated\n";
+	REQUIRE(hash_source(source) == before);
+
+	// unless the relative file disappears, then the include resolves to the shaders directory
+	shader_files.erase("filters/kernel.h");
+	REQUIRE(hash_source(source) != before);
+}
+
+TEST_CASE("vkb::SpirvCache source hash of repeated and missing includes", "[spirv_cache]")
+{
+	shader_files = {
+	    {"a.h", "#pragma once\n#include \"b.h\"\n"},
+	    {"b.h", "#pragma once\n#include \"a.h\"\n"},
+	};
+
+	// include guards make the content of a repeated include irrelevant, so cycles end
+	uint64_t hash = hash_source("#include \"a.h\"\n#include \"b.h\"\n");
+	shader_files["b.h"] += "float b;\n";
+	REQUIRE(hash_source("#include \"a.h\"\n#include \"b.h\"\n") != hash);
+
+	// a shader with an include that cannot be read is not cached
+	REQUIRE_FALSE(SpirvCache::hash_source(to_bytes("#include \"missing.h\"\n"), hash));
+
+	// directives that are not includes are hashed as plain source
+	REQUIRE(SpirvCache::hash_source(to_bytes("// #include \"missing.h\"\n#define include\n"), hash));
+}
+
+TEST_CASE("vkb::SpirvCache stores and loads entries", "[spirv_cache]")
+{
+	cache_files.clear();
+	SpirvCache::set_enabled(true);
+
+	std::vector<uint32_t> spirv{spirv_magic, 0x00010300, 1, 2, 3};
+	SpirvCache::store(1, spirv);
+	REQUIRE(cache_files.count(get_filename(1)) == 1);
+	REQUIRE(cache_files[get_filename(1)] == create_entry(cache_magic, cache_version, 1, spirv));
+
+	std::vector<uint32_t> loaded;
+	REQUIRE(SpirvCache::load(1, loaded));
+	REQUIRE(loaded == spirv);
+
+	// an entry of a previous run, read from disk
+	cache_files[get_filename(2)] = create_entry(cache_magic, cache_version, 2, spirv);
+	loaded.clear();
+	REQUIRE(SpirvCache::load(2, loaded));
+	REQUIRE(loaded == spirv);
+
+	REQUIRE_FALSE(SpirvCache::load(3, loaded));
+
+	// a disabled cache neither loads nor stores
+	SpirvCache::set_enabled(false);
+	REQUIRE_FALSE(SpirvCache::load(1, loaded));
+	SpirvCache::store(4, spirv);
+	REQUIRE(cache_files.count(get_filename(4)) == 0);
+	SpirvCache::set_enabled(true);
+}
+
+TEST_CASE("vkb::SpirvCache ignores invalid entries", "[spirv_cache]")
+{
+	cache_files.clear();
+	SpirvCache::set_enabled(true);
+
+	std::vector<uint32_t> spirv{spirv_magic, 0x00010300, 1, 2, 3};
+	std::vector<uint32_t> loaded;
+
+	// entries of another cache version, or written for another key
+	cache_files[get_filename(10)] = create_entry(cache_magic, cache_version + 1, 10, spirv);
+	cache_files[get_filename(11)] = create_entry(cache_magic, cache_version, 12, spirv);
+	cache_files[get_filename(13)] = create_entry(0, cache_version, 13, spirv);
+	REQUIRE_FALSE(SpirvCache::load(10, loaded));
+	REQUIRE_FALSE(SpirvCache::load(11, loaded));
+	REQUIRE_FALSE(SpirvCache::load(13, loaded));
+
+	// truncated entries, and entries without SPIR-V
+	auto truncated = create_entry(cache_magic, cache_version, 14, spirv);
+	truncated.pop_back();
+	cache_files[get_filename(14)] = truncated;
+	cache_files[get_filename(15)] = create_entry(cache_magic, cache_version, 15, {});
+	cache_files[get_filename(16)] = create_entry(cache_magic, cache_version, 16, {0, 1, 2});
+	REQUIRE_FALSE(SpirvCache::load(14, loaded));
+	REQUIRE_FALSE(SpirvCache::load(15, loaded));
+	REQUIRE_FALSE(SpirvCache::load(16, loaded));
+
+	// and a file shorter than the header
+	cache_files[get_filename(17)] = {1, 2, 3};
+	REQUIRE_FALSE(SpirvCache::load(17, loaded));
+}
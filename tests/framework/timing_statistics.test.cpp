@@ -0,0 +1,80 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_approx.hpp>
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include "stats/timing_statistics.h"
+
+using namespace vkb;
+
+TEST_CASE("vkb::TimingStatistics::mann_whitney_greater small samples", "[timing_statistics]")
+{
+	// U = 9 of a mean of 4.5 and a variance of 5.25, z = (9 - 4.5 - 0.5) / sqrt(5.25)
+	REQUIRE(TimingStatistics::mann_whitney_greater({4.0, 5.0, 6.0}, {1.0, 2.0, 3.0}) == Catch::Approx(0.0404278).margin(1e-6));
+	REQUIRE(TimingStatistics::mann_whitney_greater({1.0, 2.0, 3.0}, {4.0, 5.0, 6.0}) == Catch::Approx(0.9854518).margin(1e-6));
+
+	// three pairs of ties, U = 15.5 of a mean of 8 and a variance of 16 / 12 * (9 - 18 / 56)
+	REQUIRE(TimingStatistics::mann_whitney_greater({3.0, 4.0, 4.0, 5.0}, {1.0, 2.0, 2.0, 3.0}) == Catch::Approx(0.0198044).margin(1e-6));
+}
+
+TEST_CASE("vkb::TimingStatistics::mann_whitney_greater all ties", "[timing_statistics]")
+{
+	// no variance left once the ties are corrected for
+	REQUIRE(TimingStatistics::mann_whitney_greater({2.0, 2.0, 2.0}, {2.0, 2.0, 2.0}) == 1.0);
+	REQUIRE(TimingStatistics::mann_whitney_greater({2.0}, {2.0, 2.0, 2.0, 2.0}) == 1.0);
+}
+
+TEST_CASE("vkb::TimingStatistics::mann_whitney_greater identical distributions", "[timing_statistics]")
+{
+	std::vector<double> values{1.0, 2.0, 3.0, 4.0, 5.0};
+
+	// U equals its mean, only the continuity correction moves the p-value above 0.5
+	double p = TimingStatistics::mann_whitney_greater(values, values);
+	REQUIRE(p == Catch::Approx(0.5422350).margin(1e-6));
+	REQUIRE(p > 0.5);
+}
+
+TEST_CASE("vkb::TimingStatistics::mann_whitney_greater empty samples", "[timing_statistics]")
+{
+	REQUIRE(TimingStatistics::mann_whitney_greater({}, {1.0, 2.0}) == 1.0);
+	REQUIRE(TimingStatistics::mann_whitney_greater({1.0, 2.0}, {}) == 1.0);
+}
+
+TEST_CASE("vkb::TimingStatistics::get_push_count", "[timing_statistics]")
+{
+	TimingStatistics timings{2};
+	REQUIRE(timings.get_push_count() == 0);
+
+	// keeps counting once the ring overwrites its oldest samples
+	timings.push(1.0);
+	timings.push(2.0);
+	timings.push(3.0);
+	REQUIRE(timings.size() == 2);
+	REQUIRE(timings.get_push_count() == 3);
+
+	// a reset drops the samples but not the count, so readers do not report a sample twice
+	timings.reset();
+	REQUIRE(timings.empty());
+	REQUIRE(timings.get_push_count() == 3);
+	timings.push(4.0);
+	REQUIRE(timings.get_push_count() == 4);
+}
@@ -0,0 +1,179 @@
+/* Copyright (c) 2023, Arm Limited and Contributors
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 the "License";
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <core/util/error.hpp>
+
+VKBP_DISABLE_WARNINGS()
+#include <catch2/catch_test_macros.hpp>
+VKBP_ENABLE_WARNINGS()
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "platform/filesystem.h"
+#include "workgroup_database.h"
+
+using namespace vkb;
+
+namespace
+{
+constexpr const char *database_filename = "workgroup_tuning.json";
+
+// cache directory of the test, in place of the platform file system
+std::map<std::string, std::vector<uint8_t>> cache_files;
+
+void write_database(const std::string &text)
+{
+	cache_files[database_filename] = std::vector<uint8_t>(text.begin(), text.end());
+}
+
+nlohmann::json read_database()
+{
+	auto &data = cache_files[database_filename];
+	return nlohmann::json::parse(data.begin(), data.end());
+}
+}        // namespace
+
+namespace vkb
+{
+namespace fs
+{
+std::vector<uint8_t> read_cache(const std::string &filename)
+{
+	auto it = cache_files.find(filename);
+	return it == cache_files.end() ? std::vector<uint8_t>{} : it->second;
+}
+
+bool write_cache(const std::vector<uint8_t> &data, const std::string &filename)
+{
+	cache_files[filename] = data;
+	return true;
+}
+}        // namespace fs
+}        // namespace vkb
+
+TEST_CASE("vkb::WorkgroupConfig tile extent", "[workgroup_database]")
+{
+	WorkgroupConfig config{8, 4, 2};
+	REQUIRE(config.get_tile_extent().width == 16);
+	REQUIRE(config.get_tile_extent().height == 4);
+
+	REQUIRE(config == (WorkgroupConfig{8, 4, 2}));
+	REQUIRE_FALSE(config == (WorkgroupConfig{8, 4, 1}));
+}
+
+TEST_CASE("vkb::WorkgroupDatabase stores and finds entries", "[workgroup_database]")
+{
+	cache_files.clear();
+
+	WorkgroupConfig config;
+	{
+		WorkgroupDatabase database{"device_a", "Device A"};
+		REQUIRE_FALSE(database.find("pass", config));
+
+		database.store("pass", {32, 2, 4}, 0.5);
+		REQUIRE(database.find("pass", config));
+		REQUIRE(config == (WorkgroupConfig{32, 2, 4}));
+	}
+
+	// a later run on the same device finds the entry without tuning
+	WorkgroupDatabase same_device{"device_a", "Device A"};
+	REQUIRE(same_device.find("pass", config));
+	REQUIRE(config == (WorkgroupConfig{32, 2, 4}));
+
+	// another device or driver has no entries
+	WorkgroupDatabase other_device{"device_b", "Device B"};
+	REQUIRE_FALSE(other_device.find("pass", config));
+
+	auto database = read_database();
+	REQUIRE(database["version"] == 1);
+	REQUIRE(database["devices"]["device_a"]["device"] == "Device A");
+	REQUIRE(database["devices"]["device_a"]["passes"]["pass"]["time_ms"] == 0.5);
+}
+
+TEST_CASE("vkb::WorkgroupDatabase keeps the entries of other runs", "[workgroup_database]")
+{
+	cache_files.clear();
+
+	// two runs load the database before either of them stores
+	WorkgroupDatabase first{"device_a", "Device A"};
+	WorkgroupDatabase second{"device_a", "Device A"};
+	WorkgroupDatabase other{"device_b", "Device B"};
+
+	first.store("first_pass", {16, 16, 1}, 1.0);
+	second.store("second_pass", {64, 1, 2}, 2.0);
+	other.store("first_pass", {8, 8, 4}, 3.0);
+
+	WorkgroupDatabase reloaded{"device_a", "Device A"};
+	WorkgroupConfig   config;
+	REQUIRE(reloaded.find("first_pass", config));
+	REQUIRE(config == (WorkgroupConfig{16, 16, 1}));
+	REQUIRE(reloaded.find("second_pass", config));
+	REQUIRE(config == (WorkgroupConfig{64, 1, 2}));
+
+	WorkgroupDatabase reloaded_other{"device_b", "Device B"};
+	REQUIRE(reloaded_other.find("first_pass", config));
+	REQUIRE(config == (WorkgroupConfig{8, 8, 4}));
+
+	// storing a pass again replaces its entry
+	first.store("first_pass", {32, 8, 1}, 0.5);
+	WorkgroupDatabase replaced{"device_a", "Device A"};
+	REQUIRE(replaced.find("first_pass", config));
+	REQUIRE(config == (WorkgroupConfig{32, 8, 1}));
+}
+
+TEST_CASE("vkb::WorkgroupDatabase ignores invalid databases and entries", "[workgroup_database]")
+{
+	WorkgroupConfig config{1, 2, 3};
+
+	// unparsable, of another version, or without an object of devices
+	std::string              entry = R"({"width": 16, "height": 8, "pixels_per_thread": 2, "time_ms": 1.0})";
+	std::vector<std::string> texts{"not json", "[]",
+	                               R"({"version": 2, "devices": {"device_a": {"passes": {"pass": )" + entry + "}}}}",
+	                               R"({"version": 1, "devices": []})"};
+	for (auto &text : texts)
+	{
+		write_database(text);
+		WorkgroupDatabase database{"device_a", "Device A"};
+		REQUIRE_FALSE(database.find("pass", config));
+
+		// and replaces them on the next store
+		database.store("pass", {16, 8, 2}, 1.0);
+		REQUIRE(read_database()["version"] == 1);
+		REQUIRE((WorkgroupDatabase{"device_a", "Device A"}.find("pass", config)));
+	}
+	REQUIRE(config == (WorkgroupConfig{16, 8, 2}));
+
+	// incomplete entries, entries of the wrong type and zero sizes
+	write_database(R"({"version": 1, "devices": {"device_a": {"passes": {
+	    "missing": {"width": 16, "height": 8},
+	    "string": {"width": "16", "height": 8, "pixels_per_thread": 1},
+	    "negative": {"width": -16, "height": 8, "pixels_per_thread": 1},
+	    "zero": {"width": 16, "height": 0, "pixels_per_thread": 1},
+	    "valid": {"width": 4, "height": 16, "pixels_per_thread": 1}}}}})");
+
+	WorkgroupDatabase database{"device_a", "Device A"};
+	for (auto key : {"missing", "string", "negative", "zero"})
+	{
+		REQUIRE_FALSE(database.find(key, config));
+	}
+	REQUIRE(config == (WorkgroupConfig{16, 8, 2}));
+	REQUIRE(database.find("valid", config));
+	REQUIRE(config == (WorkgroupConfig{4, 16, 1}));
+}